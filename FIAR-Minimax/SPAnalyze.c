@@ -0,0 +1,339 @@
+#include "SPAnalyze.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SPMinimax.h"
+#include "SPFIARParser.h"
+#include "SPFIARCodec.h"
+#include "SPThreadPool.h"
+#include "SPThreatParity.h"
+
+#define ANALYZE_WINDOW_PER_THREAD 4
+
+/*
+* The outcome of the analysis of a position.
+*/
+typedef enum sp_analyze_status_t {
+	ANALYZE_SEARCHED,
+	ANALYZE_GAME_OVER,
+	ANALYZE_INVALID,
+	ANALYZE_FAILED
+} SP_ANALYZE_STATUS;
+
+typedef struct sp_analysis_t SPAnalysis;
+
+/*
+* A chunk of input lines and their results.
+*/
+typedef struct sp_analyze_chunk_t {
+	SPAnalysis* analysis;
+	char lines[ANALYZE_CHUNK_SIZE][SP_MAX_LINE_LENGTH + 1];
+	SP_ANALYZE_STATUS status[ANALYZE_CHUNK_SIZE];
+	SPMinimaxResult results[ANALYZE_CHUNK_SIZE];
+	SPMinimaxLine variations[ANALYZE_CHUNK_SIZE][SP_FIAR_GAME_MAX_COLUMNS]; // the moves of a multi-PV analysis
+	int variation_counts[ANALYZE_CHUNK_SIZE];
+	int count;
+	bool done;
+} SPAnalyzeChunk;
+
+struct sp_analysis_t {
+	unsigned int depth;
+	int multipv;         // the best moves printed with their variations, 0 for none
+	SPMinimaxConfig config;
+	const SPFiarGeometry* geometry;
+	pthread_mutex_t lock;
+	pthread_cond_t chunk_done;
+};
+
+/*
+* Analyzes the positions of a chunk. The task of the pool.
+* @param arg the chunk
+*/
+static void analyzeChunk(void* arg) {
+	SPAnalyzeChunk* chunk = (SPAnalyzeChunk*)arg;
+	SPAnalysis* analysis = chunk->analysis;
+	SPFiarGame* game;
+	int i;
+
+	for (i = 0; i < chunk->count; i++) {
+		// the placeholder of the empty board reads as the empty board
+		if (strcmp(chunk->lines[i], ANALYZE_EMPTY_POSITION) == 0) {
+			chunk->lines[i][0] = '\0';
+		}
+
+		if ((game = spFiarCodecDecodeMoves(chunk->lines[i], analysis->geometry, SP_FIAR_CODEC_MAX_MOVES)) == NULL) {
+			chunk->status[i] = ANALYZE_INVALID;
+		}
+		else if (spFiarCheckWinner(game) != '\0') {
+			chunk->status[i] = ANALYZE_GAME_OVER;
+		}
+		else if (analysis->multipv > 0 && (chunk->variation_counts[i] = spMinimaxAnalyzeMoves(game, analysis->depth,
+			&analysis->config, chunk->variations[i], &chunk->results[i])) == -1) {
+			chunk->status[i] = ANALYZE_FAILED;
+		}
+		else if (analysis->multipv == 0 &&
+			spMinimaxSuggestMoveWithConfig(game, analysis->depth, &analysis->config, &chunk->results[i]) == -1) {
+			chunk->status[i] = ANALYZE_FAILED;
+		}
+		else {
+			chunk->status[i] = ANALYZE_SEARCHED;
+		}
+
+		spFiarGameDestroy(game);
+	}
+
+	pthread_mutex_lock(&analysis->lock);
+	chunk->done = true;
+	pthread_cond_broadcast(&analysis->chunk_done);
+	pthread_mutex_unlock(&analysis->lock);
+}
+
+/*
+* Reads the next lines of the input into a chunk, without their line breaks.
+* A line longer than SP_MAX_LINE_LENGTH is cut, it isn't a valid position anyway.
+*
+* @param input the input
+* @param chunk the chunk to fill
+* @return the number of lines read, 0 at the end of the input
+*/
+static int readChunk(FILE* input, SPAnalyzeChunk* chunk) {
+	char* line;
+	size_t length;
+	int c;
+
+	for (chunk->count = 0; chunk->count < ANALYZE_CHUNK_SIZE; chunk->count++) {
+		line = chunk->lines[chunk->count];
+
+		if (fgets(line, SP_MAX_LINE_LENGTH + 1, input) == NULL) {
+			break;
+		}
+
+		length = strlen(line);
+
+		if (length > 0 && line[length - 1] != '\n') {
+			// skip the rest of a long line
+			while ((c = fgetc(input)) != EOF && c != '\n');
+		}
+
+		while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r' ||
+			line[length - 1] == ' ' || line[length - 1] == '\t')) {
+			line[--length] = '\0';
+		}
+	}
+
+	return chunk->count;
+}
+
+/*
+* Prints the best moves of a multi-PV analysis, best first, ties in column order.
+* @param lines the moves, in column order
+* @param count the number of moves
+* @param n the number of moves to print
+*/
+static void printVariations(SPMinimaxLine* lines, int count, int n) {
+	bool printed[SP_FIAR_GAME_MAX_COLUMNS] = { false };
+	int i, j, best;
+
+	for (i = 0; i < n && i < count; i++) {
+		best = -1;
+
+		for (j = 0; j < count; j++) {
+			if (!printed[j] && (best == -1 || lines[j].score > lines[best].score)) {
+				best = j;
+			}
+		}
+
+		printed[best] = true;
+		printf(" ");
+
+		for (j = 0; j < lines[best].length; j++) {
+			printf("%d", lines[best].pv[j] + 1);
+		}
+
+		printf(":%d", lines[best].score);
+	}
+}
+
+/*
+* Waits until a chunk is analyzed and prints its output lines.
+* @param analysis the analysis
+* @param chunk the chunk
+* @return false iff a search of the chunk failed
+*/
+static bool printChunk(SPAnalysis* analysis, SPAnalyzeChunk* chunk) {
+	const char* position;
+	bool succeeded = true;
+	int i;
+
+	pthread_mutex_lock(&analysis->lock);
+
+	while (!chunk->done) {
+		pthread_cond_wait(&analysis->chunk_done, &analysis->lock);
+	}
+
+	pthread_mutex_unlock(&analysis->lock);
+
+	for (i = 0; i < chunk->count; i++) {
+		// an empty position would leave the first field empty
+		position = chunk->lines[i][0] == '\0' ? ANALYZE_EMPTY_POSITION : chunk->lines[i];
+
+		switch (chunk->status[i]) {
+		case ANALYZE_SEARCHED:
+			printf("%s %d %d %lu", position, chunk->results[i].move + 1, chunk->results[i].score,
+				chunk->results[i].nodes);
+
+			if (analysis->multipv > 0) {
+				printVariations(chunk->variations[i], chunk->variation_counts[i], analysis->multipv);
+			}
+
+			printf("\n");
+			break;
+		case ANALYZE_GAME_OVER:
+			printf("%s -\n", position);
+			break;
+		case ANALYZE_INVALID:
+			printf("%s invalid\n", position);
+			break;
+		default:
+			printf("%s error\n", position);
+			succeeded = false;
+			break;
+		}
+	}
+
+	return succeeded;
+}
+
+/*
+* Parses the options of the analysis.
+* @param argc the number of arguments
+* @param argv the arguments
+* @param analysis the analysis to configure
+* @param path set to the input file, NULL for the standard input
+* @param threads set to the threads option, 0 if none
+* @return true iff the arguments are valid
+*/
+static bool parseOptions(int argc, char* argv[], SPAnalysis* analysis, const char** path, int* threads) {
+	int i = 2;
+
+	if (argc < 2 || !spParserIsInt(argv[1]) || atoi(argv[1]) <= 0) {
+		return false;
+	}
+
+	analysis->depth = atoi(argv[1]);
+
+	if (argc > 2 && strncmp(argv[2], "--", 2) != 0) {
+		*path = strcmp(argv[2], "-") == 0 ? NULL : argv[2];
+		i = 3;
+	}
+
+	for (; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], ANALYZE_THREADS_OPTION) == 0 && spParserIsInt(argv[i + 1]) && atoi(argv[i + 1]) > 0) {
+			*threads = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], ANALYZE_MODE_OPTION) == 0 && spMinimaxParseMode(argv[i + 1], &analysis->config.mode)) {
+			continue;
+		}
+		else if (strcmp(argv[i], ANALYZE_GEOMETRY_OPTION) == 0 &&
+			(analysis->geometry = spFiarGeometryFind(argv[i + 1])) != NULL) {
+			continue;
+		}
+		else if (strcmp(argv[i], ANALYZE_MULTIPV_OPTION) == 0 && spParserIsInt(argv[i + 1]) &&
+			atoi(argv[i + 1]) > 0 && atoi(argv[i + 1]) <= SP_FIAR_GAME_MAX_COLUMNS) {
+			analysis->multipv = atoi(argv[i + 1]);
+		}
+		else {
+			return false;
+		}
+	}
+
+	return i == argc;
+}
+
+int spAnalyzeMain(int argc, char* argv[]) {
+	SPAnalysis analysis;
+	SPAnalyzeChunk* chunks;
+	SPThreatParityStats stats;
+	SPThreadPool* pool;
+	FILE* input = stdin;
+	const char* path = NULL;
+	long next = 0, printed = 0;
+	int threads = 0, window;
+	bool succeeded = true;
+
+	spMinimaxConfigInit(&analysis.config);
+	analysis.multipv = 0;
+	analysis.geometry = spFiarGeometryGet(SP_FIAR_GEOMETRY_DEFAULT);
+
+	if (!parseOptions(argc, argv, &analysis, &path, &threads)) {
+		printf("Usage: %s <depth> [<file> | -] [%s <n>] [%s plain|pvs|mtdf|mcts] [%s 7x6|8x7|9x7|connect5] "
+			"[%s <n>]\n", argv[0], ANALYZE_THREADS_OPTION, ANALYZE_MODE_OPTION, ANALYZE_GEOMETRY_OPTION,
+			ANALYZE_MULTIPV_OPTION);
+		return 1;
+	}
+
+	if (path != NULL && (input = fopen(path, "r")) == NULL) {
+		printf("Error: cannot read %s\n", path);
+		return 1;
+	}
+
+	if (threads == 0) {
+		threads = spThreadPoolCountProcessors();
+	}
+
+	// the chunks in flight, a chunk is reused once it is printed
+	window = ANALYZE_WINDOW_PER_THREAD * threads;
+	chunks = (SPAnalyzeChunk*)malloc(window * sizeof(SPAnalyzeChunk));
+
+	if (chunks == NULL || (pool = spThreadPoolCreate(threads, window)) == NULL) {
+		printf("Error: malloc has failed\n");
+		free(chunks);
+
+		if (path != NULL) {
+			fclose(input);
+		}
+
+		return 1;
+	}
+
+	pthread_mutex_init(&analysis.lock, NULL);
+	pthread_cond_init(&analysis.chunk_done, NULL);
+	spThreatParityResetStats();
+
+	while (true) {
+		if (next - printed == window && !printChunk(&analysis, &chunks[printed++ % window])) {
+			succeeded = false;
+		}
+
+		chunks[next % window].analysis = &analysis;
+		chunks[next % window].done = false;
+
+		if (readChunk(input, &chunks[next % window]) == 0) {
+			break;
+		}
+
+		spThreadPoolSubmit(pool, analyzeChunk, &chunks[next++ % window]);
+	}
+
+	while (printed < next) {
+		if (!printChunk(&analysis, &chunks[printed++ % window])) {
+			succeeded = false;
+		}
+	}
+
+	spThreadPoolDestroy(pool);
+
+	// the counters go to the standard error, the output keeps a line per position
+	spThreatParityGetStats(&stats);
+	fprintf(stderr, "threat parity: %lu probes, %lu resolved\n", stats.probes, stats.resolved);
+
+	pthread_cond_destroy(&analysis.chunk_done);
+	pthread_mutex_destroy(&analysis.lock);
+	free(chunks);
+
+	if (path != NULL) {
+		fclose(input);
+	}
+
+	return succeeded ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+#ifndef SPANALYZE_H_
+#define SPANALYZE_H_
+
+#define ANALYZE_COMMAND "analyze"
+#define ANALYZE_THREADS_OPTION "--threads"
+#define ANALYZE_MODE_OPTION "--mode"
+#define ANALYZE_GEOMETRY_OPTION "--geometry"
+#define ANALYZE_MULTIPV_OPTION "--multipv"
+#define ANALYZE_CHUNK_SIZE 64
+#define ANALYZE_EMPTY_POSITION "-"
+
+/**
+ * SPAnalyze Summary:
+ *
+ * A batch analysis of positions, without prompts or boards. Every input line is a
+ * position as the sequence of the columns (1-based) played from the empty board,
+ * such as "4453", and every position gets an output line of
+ *   <position> <move> <score> <nodes>
+ * where move is the best move (1-based) for the player to move and the score is
+ * for that player. A position whose game has ended gets "-" for its move, and a
+ * position that isn't a valid game gets "invalid". The empty board, an empty line,
+ * is printed as "-", which is read as the empty board too.
+ *
+ * With --multipv <n>, every move of a position is scored by a single multi-PV
+ * search (see spMinimaxAnalyzeMoves), whatever the mode, and the output line goes
+ * on with the n best moves, best first, as
+ *   <principal variation>:<score>
+ * where the principal variation is the sequence of the columns (1-based) played
+ * from the position, starting with the move.
+ *
+ * The positions are searched in parallel, in chunks of ANALYZE_CHUNK_SIZE lines,
+ * and the output lines keep the order of the input lines. Only a bounded window
+ * of chunks is held in memory, so inputs of any length are streamed. At the end,
+ * the positions the threat parity analyzer probed and resolved over all threads
+ * (see SPThreatParity.h) are printed to the standard error.
+ *
+ * spAnalyzeMain  - Runs the analysis
+ */
+
+/**
+ * Runs the analysis. Usage: analyze <depth> [<file> | -] [--threads <n>]
+ * [--mode <plain|pvs|mtdf|mcts>] [--geometry <7x6|8x7|9x7|connect5>] [--multipv <n>]
+ * The positions are read from the file, or from the standard input if there is
+ * no file or it is "-". The threads are as many as the processors by default.
+ *
+ * @param argc - the number of arguments, including the command name
+ * @param argv - the arguments, argv[0] is the command name
+ * @return
+ * 0 on success, 1 if the arguments are invalid, the input can't be read or a
+ * search failed
+ */
+int spAnalyzeMain(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,259 @@
+#define _POSIX_C_SOURCE 200112L
+#include "SPArchive.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SPFIARCodec.h"
+#include "SPGameRecord.h"
+#include "SPPositionIndex.h"
+#include "SPFIARParser.h"
+
+/*
+* The names of the results, by SP_GAME_RECORD_RESULT.
+*/
+static const char* RESULT_NAMES[] = { "*", "1-0", "0-1", "1/2" };
+
+/*
+* Packs a text log of games into an archive. Blank lines are skipped, a line
+* longer than any game fails the packing.
+* @param text_path the path of the text log, a move string per line
+* @param archive_path the path of the archive to create
+* @param geometry the geometry of the games
+* @return 0 on success, 1 otherwise
+*/
+static int packArchive(const char* text_path, const char* archive_path, const SPFiarGeometry* geometry) {
+	char line[SP_FIAR_CODEC_MOVES_SIZE + 2];
+	SPGameRecordWriter* writer;
+	SPFiarGame* game;
+	unsigned long line_number = 0;
+	FILE* text;
+	size_t length;
+	int failed = 0;
+
+	if ((text = fopen(text_path, "r")) == NULL) {
+		printf("Error: cannot read %s\n", text_path);
+		return 1;
+	}
+
+	if ((writer = spGameRecordWriterOpen(archive_path)) == NULL) {
+		printf("Error: cannot write %s\n", archive_path);
+		fclose(text);
+		return 1;
+	}
+
+	while (!failed && fgets(line, sizeof(line), text) != NULL) {
+		line_number++;
+		length = strlen(line);
+
+		// a line that fills the buffer without its line break goes on, unless the log ends
+		if (length > 0 && line[length - 1] != '\n' && fgetc(text) != EOF) {
+			printf("Error: line %lu is too long\n", line_number);
+			failed = 1;
+			break;
+		}
+
+		while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r' ||
+			line[length - 1] == ' ' || line[length - 1] == '\t')) {
+			line[--length] = '\0';
+		}
+
+		if (length == 0) {
+			continue;
+		}
+
+		if ((game = spFiarCodecDecodeMoves(line, geometry, SP_FIAR_CODEC_MAX_MOVES)) == NULL) {
+			printf("Error: invalid game at line %lu\n", line_number);
+			failed = 1;
+		}
+		else if (spGameRecordWrite(writer, game, NULL, 0) != SP_GAME_RECORD_SUCCESS) {
+			printf("Error: cannot write %s\n", archive_path);
+			failed = 1;
+		}
+
+		spFiarGameDestroy(game);
+	}
+
+	fclose(text);
+
+	if (!failed) {
+		printf("packed %lu games\n", writer->count);
+	}
+
+	if (spGameRecordWriterClose(writer) != SP_GAME_RECORD_SUCCESS && !failed) {
+		printf("Error: cannot write %s\n", archive_path);
+		failed = 1;
+	}
+
+	return failed;
+}
+
+/*
+* Prints the games of an archive, a line per game: the move string, the result,
+* the geometry, the engine mode and the engine level.
+* @param archive_path the path of the archive
+* @return 0 on success, 1 otherwise
+*/
+static int dumpArchive(const char* archive_path) {
+	char moves[SP_FIAR_CODEC_MOVES_SIZE];
+	SPGameRecordReader* reader;
+	SP_GAME_RECORD_MESSAGE msg;
+	SPGameRecord record;
+	int i;
+
+	if ((reader = spGameRecordReaderOpen(archive_path)) == NULL) {
+		printf("Error: cannot read archive %s\n", archive_path);
+		return 1;
+	}
+
+	while ((msg = spGameRecordReaderNext(reader, &record)) == SP_GAME_RECORD_SUCCESS) {
+		for (i = 0; i < record.length; i++) {
+			moves[i] = (char)('1' + spGameRecordGetMove(&record, i));
+		}
+
+		moves[record.length] = '\0';
+		printf("%s %s %s %s %u\n", moves, RESULT_NAMES[record.result], record.geometry->name,
+			spMinimaxModeName(record.mode), record.level);
+	}
+
+	if (msg != SP_GAME_RECORD_END) {
+		printf("Error: corrupt archive %s after %lu games\n", archive_path, reader->count);
+	}
+
+	spGameRecordReaderClose(reader);
+
+	return msg != SP_GAME_RECORD_END;
+}
+
+/*
+* Builds the position index of an archive.
+* @param archive_path the path of the archive
+* @param index_path the path of the index to create
+* @param threads the number of threads, 0 for the number of processors
+* @param memory_limit the bytes of the entries kept in memory, 0 for the default
+* @return 0 on success, 1 otherwise
+*/
+static int indexArchive(const char* archive_path, const char* index_path, int threads, size_t memory_limit) {
+	SPPositionIndexBuildStats stats;
+	SP_POSITION_INDEX_MESSAGE msg;
+	struct timespec start, end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	msg = spPositionIndexBuild(archive_path, index_path, threads, memory_limit, &stats);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	switch (msg) {
+	case SP_POSITION_INDEX_SUCCESS:
+		printf("indexed %lu games (%lu skipped), %lu positions, %lu distinct, %lu runs spilled, %d threads, %.2f ms\n",
+			stats.games, stats.skipped, stats.positions, stats.entries, stats.runs, stats.threads,
+			(end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1000000.0);
+		return 0;
+	case SP_POSITION_INDEX_INVALID_ARCHIVE:
+		printf("Error: cannot read archive %s\n", archive_path);
+		break;
+	case SP_POSITION_INDEX_NO_KEYS:
+		printf("Error: the positions of the archive have no keys\n");
+		break;
+	case SP_POSITION_INDEX_TOO_LARGE:
+		printf("Error: the archive has more than %lu games or positions\n", (unsigned long)SP_POSITION_INDEX_MAX_COUNT);
+		break;
+	case SP_POSITION_INDEX_IO_ERROR:
+		printf("Error: cannot write %s or its temporary files\n", index_path);
+		break;
+	default:
+		printf("Error: malloc has failed\n");
+		break;
+	}
+
+	return 1;
+}
+
+/*
+* Prints the results and the first games of a position of an index.
+* @param index_path the path of the index
+* @param moves the move string of the position
+* @return 0 on success, 1 otherwise
+*/
+static int queryIndex(const char* index_path, const char* moves) {
+	const SPPositionIndexEntry* entry;
+	SPPositionIndex* index;
+	struct timespec start, end;
+	const uint32_t* games;
+	SPFiarGame* game;
+	unsigned long long key;
+	uint32_t i;
+
+	if ((index = spPositionIndexOpen(index_path)) == NULL) {
+		printf("Error: cannot read index %s\n", index_path);
+		return 1;
+	}
+
+	if ((game = spFiarCodecDecodeMoves(moves, index->geometry, SP_FIAR_CODEC_MAX_MOVES)) == NULL) {
+		printf("Error: invalid position %s\n", moves);
+		spPositionIndexClose(index);
+		return 1;
+	}
+
+	key = spFiarCodecEncodeKey(game);
+	spFiarGameDestroy(game);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	entry = spPositionIndexLookup(index, key);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	printf("position %s key %llu, lookup %.2f us\n", moves, key,
+		(end.tv_sec - start.tv_sec) * 1000000.0 + (end.tv_nsec - start.tv_nsec) / 1000.0);
+
+	if (entry == NULL) {
+		printf("games 0\n");
+	}
+	else {
+		printf("games %u: %s %u, %s %u, %s %u, %s %u\n", entry->count,
+			RESULT_NAMES[SP_GAME_RECORD_PLAYER_1_WINS], entry->results[SP_GAME_RECORD_PLAYER_1_WINS],
+			RESULT_NAMES[SP_GAME_RECORD_DRAW], entry->results[SP_GAME_RECORD_DRAW],
+			RESULT_NAMES[SP_GAME_RECORD_PLAYER_2_WINS], entry->results[SP_GAME_RECORD_PLAYER_2_WINS],
+			RESULT_NAMES[SP_GAME_RECORD_UNFINISHED], entry->results[SP_GAME_RECORD_UNFINISHED]);
+
+		games = spPositionIndexGetGames(index, entry);
+
+		for (i = 0; i < entry->count && i < ARCHIVE_QUERY_MAX_GAMES; i++) {
+			printf("%s%u", i == 0 ? "" : " ", games[i]);
+		}
+
+		printf("%s\n", entry->count > ARCHIVE_QUERY_MAX_GAMES ? " ..." : "");
+	}
+
+	spPositionIndexClose(index);
+
+	return 0;
+}
+
+int spArchiveMain(int argc, char* argv[]) {
+	const SPFiarGeometry* geometry = spFiarGeometryGet(SP_FIAR_GEOMETRY_DEFAULT);
+
+	if ((argc == 4 || argc == 5) && strcmp(argv[1], ARCHIVE_PACK_COMMAND) == 0 &&
+		(argc == 4 || (geometry = spFiarGeometryFind(argv[4])) != NULL)) {
+		return packArchive(argv[2], argv[3], geometry);
+	}
+
+	if (argc == 3 && strcmp(argv[1], ARCHIVE_DUMP_COMMAND) == 0) {
+		return dumpArchive(argv[2]);
+	}
+
+	if ((argc == 4 || (argc >= 5 && spParserIsInt(argv[4]) && atoi(argv[4]) >= 0)) &&
+		(argc <= 5 || (argc == 6 && spParserIsInt(argv[5]) && atoi(argv[5]) > 0)) &&
+		strcmp(argv[1], ARCHIVE_INDEX_COMMAND) == 0) {
+		return indexArchive(argv[2], argv[3], argc >= 5 ? atoi(argv[4]) : 0, argc == 6 ? (size_t)atoi(argv[5]) << 20 : 0);
+	}
+
+	if (argc == 4 && strcmp(argv[1], ARCHIVE_QUERY_COMMAND) == 0) {
+		return queryIndex(argv[2], argv[3]);
+	}
+
+	printf("Usage: %s %s <text file> <archive> [7x6|8x7|9x7|connect5]\n", argv[0], ARCHIVE_PACK_COMMAND);
+	printf("       %s %s <archive>\n", argv[0], ARCHIVE_DUMP_COMMAND);
+	printf("       %s %s <archive> <index> [threads] [memory MB]\n", argv[0], ARCHIVE_INDEX_COMMAND);
+	printf("       %s %s <index> <moves>\n", argv[0], ARCHIVE_QUERY_COMMAND);
+
+	return 1;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef SPARCHIVE_H_
+#define SPARCHIVE_H_
+
+#define ARCHIVE_COMMAND "archive"
+#define ARCHIVE_PACK_COMMAND "pack"
+#define ARCHIVE_DUMP_COMMAND "dump"
+#define ARCHIVE_INDEX_COMMAND "index"
+#define ARCHIVE_QUERY_COMMAND "query"
+// the number of game numbers a query prints
+#define ARCHIVE_QUERY_MAX_GAMES 20
+
+/**
+ * SPArchive Summary:
+ *
+ * A command line tool of game archives (see SPGameRecord.h).
+ *
+ *   archive pack <text file> <archive> [geometry] - packs a text log of games, a move
+ *                                                   string per line (see SPFIARCodec.h),
+ *                                                   blank lines skipped
+ *   archive dump <archive>                        - prints the games of an archive as
+ *                                                   a text log, with their results
+ *   archive index <archive> <index> [threads] [memory MB]
+ *                                                 - builds the position index of an
+ *                                                   archive (see SPPositionIndex.h),
+ *                                                   spilling past the memory limit
+ *   archive query <index> <moves>                 - prints the results and the games of
+ *                                                   the position of a move string
+ *
+ * spArchiveMain  - Runs the tool
+ */
+
+/**
+ * Runs the archive tool.
+ *
+ * @param argc - the number of arguments, including the command name
+ * @param argv - the arguments, argv[0] is the command name
+ * @return
+ * 0 on success, 1 if the arguments are invalid or a file can't be read or written
+ */
+int spArchiveMain(int argc, char* argv[]);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "SPBench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "SPMinimax.h"
+#include "SPFIARParser.h"
+#include "SPFIARCodec.h"
+#include "SPThreatParity.h"
+
+#define BENCH_HISTORY_SIZE SP_FIAR_CODEC_MAX_MOVES
+#define BENCH_N_MODES 3
+
+/*
+* The benchmark positions, as the sequence of the columns (1-based) played from the
+* empty board. They are valid on every geometry.
+*/
+static const char* BENCH_POSITIONS[] = {
+	"",
+	"44",
+	"4453",
+	"434443",
+	"4453354",
+	"43344553",
+	"444333222",
+	"44444422",
+	"3333334444",
+	"44433355521",
+	"444455526367",
+	"12345671234567",
+	"12345676543211",
+	"73635315152456514417426526343412"
+};
+
+/*
+* Returns the milliseconds of processor time since start.
+* @param start the start time
+* @return the milliseconds since start
+*/
+static double elapsedMs(clock_t start) {
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+int spBenchMain(int argc, char* argv[]) {
+	SP_MINIMAX_MODE modes[BENCH_N_MODES] = { SP_MINIMAX_MODE_PLAIN, SP_MINIMAX_MODE_PVS, SP_MINIMAX_MODE_MTDF };
+	unsigned long total_nodes[BENCH_N_MODES] = { 0 }, probes[BENCH_N_MODES] = { 0 }, resolved[BENCH_N_MODES] = { 0 };
+	double total_ms[BENCH_N_MODES] = { 0 }, ms;
+	int mismatches[BENCH_N_MODES] = { 0 };
+	unsigned int depth, max_depth = BENCH_DEFAULT_MAX_DEPTH;
+	SPMinimaxResult results[BENCH_N_MODES];
+	SPMinimaxConfig config;
+	SPThreatParityStats stats;
+	const SPFiarGeometry* geometry = spFiarGeometryGet(SP_FIAR_GEOMETRY_DEFAULT);
+	SPFiarGame* game;
+	clock_t start;
+	size_t p;
+	int m;
+
+	if (argc > 3 || (argc >= 2 && (!spParserIsInt(argv[1]) || atoi(argv[1]) <= 0)) ||
+		(argc == 3 && (geometry = spFiarGeometryFind(argv[2])) == NULL)) {
+		printf("Usage: %s [max depth] [7x6|8x7|9x7|connect5]\n", argv[0]);
+		return 1;
+	}
+
+	if (argc >= 2) {
+		max_depth = atoi(argv[1]);
+	}
+
+	printf("geometry %s\n", geometry->name);
+
+	spMinimaxConfigInit(&config);
+	printf("%-24s %5s %-5s %4s %11s %12s %10s\n", "position", "depth", "mode", "move", "score", "nodes", "ms");
+
+	for (p = 0; p < sizeof(BENCH_POSITIONS) / sizeof(BENCH_POSITIONS[0]); p++) {
+		if ((game = spFiarCodecDecodeMoves(BENCH_POSITIONS[p], geometry, BENCH_HISTORY_SIZE)) == NULL) {
+			printf("Error: invalid position %s\n", BENCH_POSITIONS[p]);
+			return 1;
+		}
+
+		for (depth = 1; depth <= max_depth; depth++) {
+			for (m = 0; m < BENCH_N_MODES; m++) {
+				config.mode = modes[m];
+				spThreatParityResetStats();
+				start = clock();
+
+				if (spMinimaxSuggestMoveWithConfig(game, depth, &config, results + m) == -1) {
+					printf("Error: search of position %s failed\n", BENCH_POSITIONS[p]);
+					spFiarGameDestroy(game);
+					return 1;
+				}
+
+				ms = elapsedMs(start);
+				spThreatParityGetStats(&stats);
+				probes[m] += stats.probes;
+				resolved[m] += stats.resolved;
+				total_nodes[m] += results[m].nodes;
+				total_ms[m] += ms;
+
+				if (results[m].move != results[0].move || results[m].score != results[0].score) {
+					mismatches[m]++;
+				}
+
+				printf("%-24s %5u %-5s %4d %11d %12lu %10.2f%s\n", BENCH_POSITIONS[p], depth, spMinimaxModeName(modes[m]),
+					results[m].move + 1, results[m].score, results[m].nodes, ms,
+					m > 0 && (results[m].move != results[0].move || results[m].score != results[0].score) ? " MISMATCH" : "");
+			}
+		}
+
+		spFiarGameDestroy(game);
+	}
+
+	printf("\n%-5s %14s %10s %12s %10s %10s %10s %10s\n", "mode", "nodes", "ms", "node ratio", "speedup", "mismatch",
+		"probes", "resolved");
+
+	for (m = 0; m < BENCH_N_MODES; m++) {
+		printf("%-5s %14lu %10.2f %12.3f %10.2f %10d %10lu %10lu\n", spMinimaxModeName(modes[m]), total_nodes[m], total_ms[m],
+			total_nodes[0] > 0 ? (double)total_nodes[m] / total_nodes[0] : 0.0,
+			total_ms[m] > 0 ? total_ms[0] / total_ms[m] : 0.0, mismatches[m], probes[m], resolved[m]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,32 @@
+#ifndef SPBENCH_H_
+#define SPBENCH_H_
+
+#define BENCH_COMMAND "bench"
+#define BENCH_DEFAULT_MAX_DEPTH 7
+
+/**
+ * SPBench Summary:
+ *
+ * A benchmark of the search modes of the engine. Every position of a fixed set is
+ * searched at every depth up to a maximal one, with every mode. For each search
+ * the move, score, node count and time are printed, then the total node count and
+ * time of every mode compared with the plain search, with the positions the threat
+ * parity analyzer probed and resolved (see SPThreatParity.h). A mode that disagrees
+ * with the plain search on a move or a score is reported. The last position is a
+ * closed one, with most of the board filled, where the analyzer proves results.
+ *
+ * spBenchMain  - Runs the benchmark
+ */
+
+/**
+ * Runs the benchmark. Usage: bench [max depth] [geometry], the geometry is
+ * the name of a supported one (see spFiarGeometryFind), 7x6 by default.
+ *
+ * @param argc - the number of arguments, including the command name
+ * @param argv - the arguments, argv[0] is the command name
+ * @return
+ * 0 on success, 1 if the arguments are invalid or a search failed
+ */
+int spBenchMain(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef SPEVALWEIGHTS_H_
+#define SPEVALWEIGHTS_H_
+
+/**
+ * The weights of the evaluation of a position (see spCalculateGameScore), by the
+ * sum of a span: the number of discs of player 1 minus those of player 2 in the
+ * span, from -(span - 1) to span - 1 without 0. The tune command writes a
+ * replacement of this header fitted to self-play samples.
+ */
+#define WEIGHTS { -5, -2, -1, 1, 2, 5 }
+// the weights of the geometries with a span of 5
+#define WEIGHTS_SPAN_5 { -12, -5, -2, -1, 1, 2, 5, 12 }
+
+#endif
@@ -0,0 +1,172 @@
+#include "SPFIARCodec.h"
+
+/*
+* Returns the number of bits of the field of a column in the keys of a geometry.
+* Assumes geometry is not null.
+*
+* @param geometry the geometry
+* @return the field width, 0 if the geometry has no keys
+*/
+static int getColumnBits(const SPFiarGeometry* geometry) {
+	if ((geometry->rows + 1) * geometry->columns > 64) {
+		return 0;
+	}
+
+	return geometry->rows + 1;
+}
+
+bool spFiarCodecHasKeys(const SPFiarGeometry* geometry) {
+	return (void*)geometry != NULL && getColumnBits(geometry) != 0;
+}
+
+unsigned long long spFiarCodecEncodeKey(SPFiarGame* src) {
+	unsigned long long key = 0;
+	char current;
+	int i, j, bits;
+
+	if ((void*)src == NULL || (bits = getColumnBits(src->geometry)) == 0) {
+		return 0;
+	}
+
+	current = spFiarGameGetCurrentPlayer(src);
+
+	for (j = 0; j < src->geometry->columns; j++) {
+		// the bit above the top
+		key |= 1ULL << ((src->tops)[j] + j * bits);
+
+		for (i = 0; i < (src->tops)[j]; i++) {
+			if ((src->gameBoard)[i][j] == current) {
+				key |= 1ULL << (i + j * bits);
+			}
+		}
+	}
+
+	return key;
+}
+
+SPFiarGame* spFiarCodecDecodeKey(unsigned long long key, const SPFiarGeometry* geometry, int historySize) {
+	unsigned long long field;
+	int tops[SP_FIAR_GAME_MAX_COLUMNS], i, j, bits, discs = 0, current_discs = 0;
+	char current, opponent;
+	SPFiarGame* game;
+
+	if ((void*)geometry == NULL || (bits = getColumnBits(geometry)) == 0) {
+		return NULL;
+	}
+
+	// no bits above the last column
+	if (bits * geometry->columns < 64 && (key >> (bits * geometry->columns)) != 0) {
+		return NULL;
+	}
+
+	// the top of every column is its highest bit
+	for (j = 0; j < geometry->columns; j++) {
+		field = (key >> (j * bits)) & ((1ULL << bits) - 1);
+
+		if (field == 0) {
+			return NULL;
+		}
+
+		for (tops[j] = bits - 1; !(field & (1ULL << tops[j])); tops[j]--);
+
+		for (i = 0; i < tops[j]; i++) {
+			if (field & (1ULL << i)) {
+				current_discs++;
+			}
+		}
+
+		discs += tops[j];
+	}
+
+	// player 1 has as many discs as player 2 or one more, so the player to move has the floor of half
+	if (current_discs != discs / 2) {
+		return NULL;
+	}
+
+	if ((game = spFiarGameCreateWithGeometry(historySize, geometry)) == NULL) {
+		return NULL;
+	}
+
+	// player 1 moves after an even number of discs
+	current = discs % 2 == 0 ? SP_FIAR_GAME_PLAYER_1_SYMBOL : SP_FIAR_GAME_PLAYER_2_SYMBOL;
+	opponent = discs % 2 == 0 ? SP_FIAR_GAME_PLAYER_2_SYMBOL : SP_FIAR_GAME_PLAYER_1_SYMBOL;
+	game->currentPlayer = current;
+
+	for (j = 0; j < geometry->columns; j++) {
+		(game->tops)[j] = tops[j];
+
+		for (i = 0; i < tops[j]; i++) {
+			(game->gameBoard)[i][j] = (key >> (i + j * bits)) & 1ULL ? current : opponent;
+		}
+	}
+
+	return game;
+}
+
+unsigned long long spFiarCodecMirrorKey(unsigned long long key, const SPFiarGeometry* geometry) {
+	unsigned long long mirror_key = 0, field_mask;
+	int j, bits;
+
+	if ((void*)geometry == NULL || (bits = getColumnBits(geometry)) == 0) {
+		return 0;
+	}
+
+	field_mask = (1ULL << bits) - 1;
+
+	for (j = 0; j < geometry->columns; j++) {
+		mirror_key |= ((key >> (j * bits)) & field_mask) << ((geometry->columns - 1 - j) * bits);
+	}
+
+	return mirror_key;
+}
+
+SP_FIAR_GAME_MESSAGE spFiarCodecEncodeMoves(SPFiarGame* src, char* dest, size_t size) {
+	int i, moves, discs = 0;
+
+	if ((void*)src == NULL || dest == NULL) {
+		return SP_FIAR_GAME_INVALID_ARGUMENT;
+	}
+
+	for (i = 0; i < src->geometry->columns; i++) {
+		discs += (src->tops)[i];
+	}
+
+	// the first moves may have been dropped from a full history
+	if ((moves = spArrayListSize(src->history)) != discs) {
+		return SP_FIAR_GAME_NO_HISTORY;
+	}
+
+	if ((size_t)moves + 1 > size) {
+		return SP_FIAR_GAME_INVALID_ARGUMENT;
+	}
+
+	for (i = 0; i < moves; i++) {
+		dest[i] = (char)('1' + spArrayListGetAt(src->history, i));
+	}
+
+	dest[moves] = '\0';
+
+	return SP_FIAR_GAME_SUCCESS;
+}
+
+SPFiarGame* spFiarCodecDecodeMoves(const char* moves, const SPFiarGeometry* geometry, int historySize) {
+	SPFiarGame* game;
+	bool won = false;
+
+	if (moves == NULL || (game = spFiarGameCreateWithGeometry(historySize, geometry)) == NULL) {
+		return NULL;
+	}
+
+	// only the cells around each move are checked, a move after a win is invalid
+	for (; *moves != '\0'; moves++) {
+		if (won || !spFiarGameIsValidMove(game, *moves - '1')) {
+			spFiarGameDestroy(game);
+			return NULL;
+		}
+
+		won = spFiarGameIsWinningMove(game, *moves - '1', spFiarGameGetCurrentPlayer(game));
+		spFiarGameSetMove(game, *moves - '1');
+	}
+
+	return game;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#ifndef SPFIARCODEC_H_
+#define SPFIARCODEC_H_
+#include <stddef.h>
+#include "SPFIARGame.h"
+
+/**
+ * SPFIARCodec Summary:
+ *
+ * Compact encodings of games, for storing, caching and shipping positions.
+ *
+ * A position key is a 64 bit number with a field of rows + 1 bits for every
+ * column, the first column in the lowest bits. The bits of a column are the discs
+ * of the player to move, from the bottom up, plus a bit right above the top disc
+ * of the column. The key is the same for every move order leading to a position,
+ * and a position can be rebuilt from its key (without its history).
+ * A geometry has keys iff (rows + 1) * columns <= 64, that is every geometry
+ * but 9x7.
+ *
+ * A move string is the sequence of columns played from the empty board, 1-based,
+ * one digit per move, such as "4453".
+ *
+ * spFiarCodecHasKeys      - Checks if the positions of a geometry have keys
+ * spFiarCodecEncodeKey    - Returns the key of the position of a game
+ * spFiarCodecDecodeKey    - Creates a game of the position of a key
+ * spFiarCodecMirrorKey    - Returns the key of the mirror image of a position
+ * spFiarCodecEncodeMoves  - Writes the move string of a game
+ * spFiarCodecDecodeMoves  - Creates a game by playing a move string
+ */
+
+//Definitions
+#define SP_FIAR_CODEC_MAX_MOVES (SP_FIAR_GAME_MAX_ROWS * SP_FIAR_GAME_MAX_COLUMNS)
+// the size of a buffer that holds every move string, with its null terminator
+#define SP_FIAR_CODEC_MOVES_SIZE (SP_FIAR_CODEC_MAX_MOVES + 1)
+
+/**
+ * Checks if the positions of a geometry have keys.
+ *
+ * @param geometry - the geometry
+ * @return
+ * true iff geometry != NULL and (rows + 1) * columns <= 64
+ */
+bool spFiarCodecHasKeys(const SPFiarGeometry* geometry);
+
+/**
+ * Returns the key of the position of a game.
+ *
+ * @param src - the source game
+ * @return
+ * 0 if src == NULL or its geometry has no keys, the key otherwise (never 0).
+ */
+unsigned long long spFiarCodecEncodeKey(SPFiarGame* src);
+
+/**
+ * Creates a game of the position of a key. The game has an empty history, so
+ * its moves can't be undone.
+ *
+ * @param key - the key of the position
+ * @param geometry - the geometry of the position
+ * @param historySize - the history size of the new game
+ * @return
+ * NULL if geometry is NULL or has no keys, key is not a valid key of the geometry,
+ * historySize <= 0 or a memory allocation failure occurred. Otherwise, the game.
+ * A valid key gives player 1 as many discs as player 2 or one more.
+ */
+SPFiarGame* spFiarCodecDecodeKey(unsigned long long key, const SPFiarGeometry* geometry, int historySize);
+
+/**
+ * Returns the key of the mirror image of a position, in which column j is column
+ * columns - 1 - j of the position.
+ *
+ * @param key - the key of the position
+ * @param geometry - the geometry of the position
+ * @return
+ * 0 if geometry is NULL or has no keys, the mirrored key otherwise.
+ */
+unsigned long long spFiarCodecMirrorKey(unsigned long long key, const SPFiarGeometry* geometry);
+
+/**
+ * Writes the move string of a game, its moves from the empty board.
+ *
+ * @param src - the source game
+ * @param dest - the buffer to write the null terminated string to
+ * @param size - the size of dest, SP_FIAR_CODEC_MOVES_SIZE is always enough
+ * @return
+ * SP_FIAR_GAME_INVALID_ARGUMENT - if src or dest is NULL or dest is too small
+ * SP_FIAR_GAME_NO_HISTORY       - if the history of src doesn't hold all of its moves
+ * SP_FIAR_GAME_SUCCESS          - otherwise
+ */
+SP_FIAR_GAME_MESSAGE spFiarCodecEncodeMoves(SPFiarGame* src, char* dest, size_t size);
+
+/**
+ * Creates a game by playing a move string from the empty board. Each move is
+ * checked for a win by the cells around it only, so decoding takes linear time.
+ *
+ * @param moves - the move string
+ * @param geometry - the geometry of the game
+ * @param historySize - the history size of the new game, the length of moves at least
+ *                      for all of the moves to be undoable
+ * @return
+ * NULL if moves or geometry is NULL, historySize <= 0, moves has an invalid move
+ * (including a move after the game has ended) or a memory allocation failure
+ * occurred. Otherwise, the game.
+ */
+SPFiarGame* spFiarCodecDecodeMoves(const char* moves, const SPFiarGeometry* geometry, int historySize);
+
+#endif
\ No newline at end of file
@@ -23,31 +23,48 @@ static SP_ARRAY_LIST_MESSAGE forceSpArrayListAddLast(SPArrayList* src, int elem)
 }
 
 SPFiarGame* spFiarGameCreate(int historySize) {
-	int i, j;
-	SPFiarGame *game;
-
-	if (historySize <= 0) {
-		return NULL;
-	}
+	return spFiarGameCreateWithGeometry(historySize, spFiarGeometryGet(SP_FIAR_GEOMETRY_DEFAULT));
+}
 
-	game = (SPFiarGame*)(malloc(sizeof(SPFiarGame)));
-	if ((void*)game == NULL) {
-		return NULL;
-	}
+/*
+* Sets the empty board of a geometry and the first player.
+* Assumes game and geometry are not null.
+*
+* @param game the game
+* @param geometry the geometry
+*/
+static void setEmptyBoard(SPFiarGame* game, const SPFiarGeometry* geometry) {
+	int i, j;
 
 	game->currentPlayer = SP_FIAR_GAME_PLAYER_1_SYMBOL;
+	game->geometry = geometry;
 
-	// set game board
-	for (i = 0; i < SP_FIAR_GAME_N_ROWS; i++) {
-		for (j = 0; j < SP_FIAR_GAME_N_COLUMNS; j++) {
+	// set game board, the cells out of the geometry are kept empty as well
+	for (i = 0; i < SP_FIAR_GAME_MAX_ROWS; i++) {
+		for (j = 0; j < SP_FIAR_GAME_MAX_COLUMNS; j++) {
 			(game->gameBoard)[i][j] = SP_FIAR_GAME_EMPTY_ENTRY;
 		}
 	}
 
 	// set tops
-	for (i = 0; i < SP_FIAR_GAME_N_COLUMNS; i++) {
+	for (i = 0; i < SP_FIAR_GAME_MAX_COLUMNS; i++) {
 		(game->tops)[i] = 0;
 	}
+}
+
+SPFiarGame* spFiarGameCreateWithGeometry(int historySize, const SPFiarGeometry* geometry) {
+	SPFiarGame *game;
+
+	if (historySize <= 0 || (void*)geometry == NULL) {
+		return NULL;
+	}
+
+	game = (SPFiarGame*)(malloc(sizeof(SPFiarGame)));
+	if ((void*)game == NULL) {
+		return NULL;
+	}
+
+	setEmptyBoard(game, geometry);
 	
 	game->history = spArrayListCreate(historySize);
 
@@ -74,16 +91,17 @@ SPFiarGame* spFiarGameCopy(SPFiarGame* src) {
 	}
 
 	game->currentPlayer = src->currentPlayer;
+	game->geometry = src->geometry;
 
 	// set game board
-	for (i = 0; i < SP_FIAR_GAME_N_ROWS; i++) {
-		for (j = 0; j < SP_FIAR_GAME_N_COLUMNS; j++) {
+	for (i = 0; i < SP_FIAR_GAME_MAX_ROWS; i++) {
+		for (j = 0; j < SP_FIAR_GAME_MAX_COLUMNS; j++) {
 			(game->gameBoard)[i][j] = (src->gameBoard)[i][j];
 		}
 	}
 
 	// set tops
-	for (i = 0; i < SP_FIAR_GAME_N_COLUMNS; i++) {
+	for (i = 0; i < SP_FIAR_GAME_MAX_COLUMNS; i++) {
 		(game->tops)[i] = (src->tops)[i];
 	}
 
@@ -106,6 +124,17 @@ void spFiarGameDestroy(SPFiarGame* src) {
 	free(src);
 }
 
+SP_FIAR_GAME_MESSAGE spFiarGameReset(SPFiarGame* src, const SPFiarGeometry* geometry) {
+	if ((void*)src == NULL || (void*)geometry == NULL) {
+		return SP_FIAR_GAME_INVALID_ARGUMENT;
+	}
+
+	setEmptyBoard(src, geometry);
+	spArrayListClear(src->history);
+
+	return SP_FIAR_GAME_SUCCESS;
+}
+
 /*
 * Change the current player of the game.
 * @param src the game
@@ -141,11 +170,11 @@ static void setBoardCell(SPFiarGame* src, int row, int col, char symbol) {
 }
 
 SP_FIAR_GAME_MESSAGE spFiarGameSetMove(SPFiarGame* src, int col) {
-	if ((void*)src == NULL || !(col >= 0 && col < SP_FIAR_GAME_N_COLUMNS)) {
+	if ((void*)src == NULL || !(col >= 0 && col < src->geometry->columns)) {
 		return SP_FIAR_GAME_INVALID_ARGUMENT;
 	}
 
-	if (!((src->tops)[col] < SP_FIAR_GAME_N_ROWS)) {
+	if (!((src->tops)[col] < src->geometry->rows)) {
 		return SP_FIAR_GAME_INVALID_MOVE;
 	}
 	
@@ -158,11 +187,11 @@ SP_FIAR_GAME_MESSAGE spFiarGameSetMove(SPFiarGame* src, int col) {
 }
 
 bool spFiarGameIsValidMove(SPFiarGame* src, int col) {
-	if ((void*)src == NULL || !(col >= 0 && col < SP_FIAR_GAME_N_COLUMNS)) {
+	if ((void*)src == NULL || !(col >= 0 && col < src->geometry->columns)) {
 		return false;
 	}
 
-	return  (src->tops)[col] < SP_FIAR_GAME_N_ROWS;
+	return  (src->tops)[col] < src->geometry->rows;
 }
 
 SP_FIAR_GAME_MESSAGE spFiarGameUndoPrevMove(SPFiarGame* src) {
@@ -194,16 +223,23 @@ SP_FIAR_GAME_MESSAGE spFiarGamePrintBoard(SPFiarGame* src) {
 		return SP_FIAR_GAME_INVALID_ARGUMENT;
 	}
 
-	for (i = SP_FIAR_GAME_N_ROWS - 1; i >= 0; i--) {
+	for (i = src->geometry->rows - 1; i >= 0; i--) {
 		printf("| ");
-		for (j = 0; j < SP_FIAR_GAME_N_COLUMNS; j++) {
+		for (j = 0; j < src->geometry->columns; j++) {
 			printf("%c ", (src->gameBoard)[i][j]);
 		}
 		printf("|\n");
 	}
 
-	printf("-----------------\n");
-	printf("  1 2 3 4 5 6 7  \n");
+	printf("---");
+	for (j = 0; j < src->geometry->columns; j++) {
+		printf("--");
+	}
+	printf("\n ");
+	for (j = 0; j < src->geometry->columns; j++) {
+		printf(" %d", j + 1);
+	}
+	printf("  \n");
 
 	return SP_FIAR_GAME_SUCCESS;
 }
@@ -217,153 +253,6 @@ char spFiarGameGetCurrentPlayer(SPFiarGame* src) {
 	return src->currentPlayer;
 }
 
-/*
-* Checks if there is a FIAR of the input symbol in the game board as a row.
-* Assumes src is not null.
-*
-* @param src the game
-* @param symbol the symbol to check (i.e the symbol of the player)
-@return true iff the user with the specified symbol is a winner
-*/
-static bool checkWinAsRow(SPFiarGame* src, char symbol) {
-	int count, i, j;
-
-	// check for a win as a row
-	for (i = 0; i < SP_FIAR_GAME_N_ROWS; i++) {
-		count = 0;
-
-		for (j = 0; j < SP_FIAR_GAME_N_COLUMNS; j++) {
-			if ((src->gameBoard)[i][j] == symbol) {
-				count++;
-
-				if (count == SP_FIAR_GAME_SPAN) {
-					return true;
-				}
-			}
-			else {
-				count = 0;
-			}
-		}
-	}
-
-	return false;
-}
-
-/*
-* Checks if there is a FIAR of the input symbol in the game board as a col.
-* Assumes src is not null.
-*
-* @param src the game
-* @param symbol the symbol to check (i.e the symbol of the player)
-@return true iff the user with the specified symbol is a winner
-*/
-static bool checkWinAsCol(SPFiarGame* src, char symbol) {
-	int count, i, j;
-
-	// check for a win as a col
-	for (j = 0; j < SP_FIAR_GAME_N_COLUMNS; j++) {
-		count = 0;
-
-		for (i = 0; i < SP_FIAR_GAME_N_ROWS; i++) {
-			if ((src->gameBoard)[i][j] == symbol) {
-				count++;
-
-				if (count == SP_FIAR_GAME_SPAN) {
-					return true;
-				}
-			}
-			else {
-				count = 0;
-			}
-		}
-	}
-
-	return false;
-}
-
-/*
-* Checks if there is a FIAR of the input symbol in the game board as a diag.
-* Assumes src is not null.
-*
-* @param src the game
-* @param symbol the symbol to check (i.e the symbol of the player)
-@return true iff the user with the specified symbol is a winner
-*/
-static bool checkWinAsDiag(SPFiarGame* src, char symbol) {
-	int count, i, j, k;
-
-	// check for a win as a row as a diagonal of type / 
-	//checking the diagonals start with the first column
-	for (i = SP_FIAR_GAME_N_ROWS - 1; i >= 0; i--) {
-		count = 0;
-
-		// go diagonaly right up
-		for (j = 0, k = i; j < SP_FIAR_GAME_N_COLUMNS && k < SP_FIAR_GAME_N_ROWS; j++, k++) {
-			if ((src->gameBoard)[k][j] == symbol) {
-				count++;
-
-				if (count == SP_FIAR_GAME_SPAN) 
-					return true;
-			}
-			else 
-				count = 0;
-		}
-	}
-
-	// checking the diagonals start with the bottom row
-	for (j = 0; j < SP_FIAR_GAME_N_COLUMNS; j++) {
-		count = 0;
-
-		// go diagonaly right up
-		for (i = 0, k = j; i < SP_FIAR_GAME_N_ROWS && k < SP_FIAR_GAME_N_COLUMNS; k++, i++) {
-			if ((src->gameBoard)[i][k] == symbol) {
-				count++;
-
-				if (count == SP_FIAR_GAME_SPAN)
-					return true;
-			}
-			else
-				count = 0;
-		}
-	}
-
-	// check for a win as a row as a diagonal of type '\', checking the diagonals start with the last column
-	for (i = SP_FIAR_GAME_N_ROWS - 1; i >= 0; i--) {
-		count = 0;
-
-		// go diagonaly left up
-		for (j = SP_FIAR_GAME_N_COLUMNS - 1, k = i; j >= 0 && k < SP_FIAR_GAME_N_ROWS; j--, k++) {
-			if ((src->gameBoard)[k][j] == symbol) {
-				count++;
-
-				if (count == SP_FIAR_GAME_SPAN) 
-					return true;
-			}
-			else 
-				count = 0;
-		}
-	}
-
-	// checking the diagonals start with the bottom row
-	for (j = 0; j < SP_FIAR_GAME_N_COLUMNS; j++) {
-		count = 0;
-
-		// go diagonaly left up
-		for (i = 0, k = j; i < SP_FIAR_GAME_N_ROWS && k >= 0; k--, i++) {
-			if ((src->gameBoard)[i][k] == symbol) {
-				count++;
-
-				if (count == SP_FIAR_GAME_SPAN) 
-					return true;
-			}
-			else 
-				count = 0;
-		}
-	}
-
-	return false;
-}
-
 /*
 * Checks if there is a FIAR of the input symbol in the game board.
 * Assumes src is not null.
@@ -373,17 +262,8 @@ static bool checkWinAsDiag(SPFiarGame* src, char symbol) {
 @return true iff the user with the specified symbol is a winner
 */
 static bool isWinnerWithSymbol(SPFiarGame* src, char symbol) {
-	
-	if (checkWinAsRow(src, symbol))
-		return true;
-
-	if (checkWinAsCol(src, symbol))
-		return true;
-
-	if (checkWinAsDiag(src, symbol))
-		return true;
-
-	return false;
+	// rows, columns and diagonals are all scanned by the kernel of the geometry
+	return src->geometry->hasSpan((const char (*)[SP_FIAR_GAME_MAX_COLUMNS])src->gameBoard, symbol);
 }
 
 char spFiarCheckWinner(SPFiarGame* src) {
@@ -402,11 +282,48 @@ char spFiarCheckWinner(SPFiarGame* src) {
 	}
 
 	// check for tie - no more moves
-	for (i = 0; i < SP_FIAR_GAME_N_COLUMNS && !spFiarGameIsValidMove(src, i); i++);
+	for (i = 0; i < src->geometry->columns && !spFiarGameIsValidMove(src, i); i++);
 
-	if (i == SP_FIAR_GAME_N_COLUMNS) {
+	if (i == src->geometry->columns) {
 		return SP_FIAR_GAME_TIE_SYMBOL;
 	}
 
 	return '\0';
+}
+
+bool spFiarGameIsMirrorSymmetric(SPFiarGame* src) {
+	int i, j, columns;
+
+	if ((void*)src == NULL) {
+		return false;
+	}
+
+	columns = src->geometry->columns;
+
+	// compare the heights first, most positions differ there already
+	for (j = 0; j < columns / 2; j++) {
+		if ((src->tops)[j] != (src->tops)[columns - 1 - j]) {
+			return false;
+		}
+	}
+
+	for (j = 0; j < columns / 2; j++) {
+		for (i = 0; i < (src->tops)[j]; i++) {
+			if ((src->gameBoard)[i][j] != (src->gameBoard)[i][columns - 1 - j]) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool spFiarGameIsWinningMove(SPFiarGame* src, int col, char symbol) {
+	if (!spFiarGameIsValidMove(src, col)) {
+		return false;
+	}
+
+	// only the cells around the top of the column are scanned
+	return src->geometry->isSpanThrough((const char (*)[SP_FIAR_GAME_MAX_COLUMNS])src->gameBoard,
+		(src->tops)[col], col, symbol);
 }
\ No newline at end of file
@@ -2,39 +2,45 @@
 #define SPFIARGAME_H_
 #include <stdbool.h>
 #include "SPArrayList.h"
+#include "SPFIARGeometry.h"
 
 /**
  * SPFIARGame Summary:
  *
  * A container that represents a classic connect-4 game, a two players 6 by 7
- * board game (rows X columns). The container supports the following functions.
+ * board game (rows X columns). A game can also be played on any other geometry
+ * of SPFIARGeometry.h, its dimensions are held by the game and every column index
+ * is in the range [0, src->geometry->columns - 1].
+ * The container supports the following functions.
  *
  * spFiarGameCreate           - Creates a new game board
+ * spFiarGameCreateWithGeometry - Creates a new game board of a specified geometry
  * spFiarGameCopy             - Copies a game board
  * spFiarGameDestroy          - Frees all memory resources associated with a game
+ * spFiarGameReset            - Clears a game board, to start a new game without allocations
  * spFiarGameSetMove          - Sets a move on a game board
  * spFiarGameIsValidMove      - Checks if a move is valid
  * spFiarGameUndoPrevMove     - Undoes previous move made by the last player
  * spFiarGamePrintBoard       - Prints the current board
  * spFiarGameGetCurrentPlayer - Returns the current player
+ * spFiarGameIsMirrorSymmetric - Checks if the board is left-right symmetric
+ * spFiarGameIsWinningMove    - Checks if a disc in a column completes a FIAR
  *
  */
 
 //Definitions
-#define SP_FIAR_GAME_SPAN 4
-#define SP_FIAR_GAME_N_ROWS 6
-#define SP_FIAR_GAME_N_COLUMNS 7
 #define SP_FIAR_GAME_PLAYER_1_SYMBOL 'X'
 #define SP_FIAR_GAME_PLAYER_2_SYMBOL 'O'
 #define SP_FIAR_GAME_TIE_SYMBOL '-'
 #define SP_FIAR_GAME_EMPTY_ENTRY ' '
 
 typedef struct sp_fiar_game_t {
-	char gameBoard[SP_FIAR_GAME_N_ROWS][SP_FIAR_GAME_N_COLUMNS];
-	int tops[SP_FIAR_GAME_N_COLUMNS];
+	char gameBoard[SP_FIAR_GAME_MAX_ROWS][SP_FIAR_GAME_MAX_COLUMNS];
+	int tops[SP_FIAR_GAME_MAX_COLUMNS];
 	char currentPlayer;
 	//You May add any fields you like
 	SPArrayList * history;
+	const SPFiarGeometry* geometry;
 } SPFiarGame;
 
 /**
@@ -62,6 +68,19 @@ typedef enum sp_fiar_game_message_t {
  */
 SPFiarGame* spFiarGameCreate(int historySize);
 
+/**
+ * Creates a new game of the specified geometry with a specified history size,
+ * as spFiarGameCreate does.
+ *
+ * @historySize - The total number of moves to undo,
+ *                a player can undo at most historySizeMoves turns.
+ * @geometry    - The geometry of the board
+ * @return
+ * NULL if either a memory allocation failure occurs, historySize <= 0 or
+ * geometry is NULL. Otherwise, a new game instant is returned.
+ */
+SPFiarGame* spFiarGameCreateWithGeometry(int historySize, const SPFiarGeometry* geometry);
+
 /**
  *	Creates a copy of a given game.
  *	The new copy has the same status as the src game.
@@ -82,9 +101,22 @@ SPFiarGame* spFiarGameCopy(SPFiarGame* src);
  */
 void spFiarGameDestroy(SPFiarGame* src);
 
+/**
+ * Clears a game to the empty board of the specified geometry, with an empty
+ * history of the same size. No memory is allocated, so a game can be reused to
+ * replay many games.
+ *
+ * @param src - the target game
+ * @param geometry - the geometry of the new board
+ * @return
+ * SP_FIAR_GAME_INVALID_ARGUMENT - if src or geometry is NULL
+ * SP_FIAR_GAME_SUCCESS - otherwise
+ */
+SP_FIAR_GAME_MESSAGE spFiarGameReset(SPFiarGame* src, const SPFiarGeometry* geometry);
+
 /**
  * Sets the next move in a given game by specifying column index. The
- * columns are 0-based and in the range [0,SP_FIAR_GAME_N_COLUMNS -1].
+ * columns are 0-based and in the range [0,src->geometry->columns -1].
  *
  * @param src - The target game
  * @param col - The target column, the columns are 0-based
@@ -159,4 +191,34 @@ char spFiarGameGetCurrentPlayer(SPFiarGame* src);
 */
 char spFiarCheckWinner(SPFiarGame* src);
 
-#endif
+/**
+ * Checks if the board of the specified game is left-right (mirror) symmetric,
+ * that is column j holds exactly the same discs as column
+ * columns - 1 - j for every j. In a symmetric position a move and
+ * its mirrored move lead to mirrored positions of the same value, so a search
+ * only has to expand the columns in [0, (columns - 1) / 2].
+ *
+ * @param src - the source game
+ * @return
+ * true  - if src != NULL and the board is mirror symmetric
+ * false - otherwise
+ */
+bool spFiarGameIsMirrorSymmetric(SPFiarGame* src);
+
+/**
+ * Checks if putting a disc of the specified symbol in the specified column
+ * would complete span discs in a row. Only the cells around the
+ * top of the column are scanned, so this is much cheaper than setting the move
+ * and calling spFiarCheckWinner. The game is not changed.
+ *
+ * @param src - the source game
+ * @param col - the target column, 0-based
+ * @param symbol - the symbol of the disc, SP_FIAR_GAME_PLAYER_1_SYMBOL or
+ *                 SP_FIAR_GAME_PLAYER_2_SYMBOL
+ * @return
+ * true  - if the move is valid and completes a FIAR for symbol
+ * false - otherwise
+ */
+bool spFiarGameIsWinningMove(SPFiarGame* src, int col, char symbol);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "SPFIARGeometry.h"
+#include "SPFIARGame.h"
+#include <string.h>
+
+// the kernels of every supported geometry
+
+#define SP_KERNEL_NAME _7x6
+#define SP_KERNEL_ROWS 6
+#define SP_KERNEL_COLUMNS 7
+#define SP_KERNEL_SPAN 4
+#include "SPFIARGeometryKernel.h"
+
+#define SP_KERNEL_NAME _8x7
+#define SP_KERNEL_ROWS 7
+#define SP_KERNEL_COLUMNS 8
+#define SP_KERNEL_SPAN 4
+#include "SPFIARGeometryKernel.h"
+
+#define SP_KERNEL_NAME _9x7
+#define SP_KERNEL_ROWS 7
+#define SP_KERNEL_COLUMNS 9
+#define SP_KERNEL_SPAN 4
+#include "SPFIARGeometryKernel.h"
+
+#define SP_KERNEL_NAME _Connect5
+#define SP_KERNEL_ROWS 6
+#define SP_KERNEL_COLUMNS 9
+#define SP_KERNEL_SPAN 5
+#include "SPFIARGeometryKernel.h"
+
+static const SPFiarGeometry GEOMETRIES[SP_FIAR_N_GEOMETRIES] = {
+	{ SP_FIAR_GEOMETRY_7X6, "7x6", 6, 7, 4, hasSpan_7x6, isSpanThrough_7x6, fillHistogram_7x6,
+		evaluateSpans_7x6 },
+	{ SP_FIAR_GEOMETRY_8X7, "8x7", 7, 8, 4, hasSpan_8x7, isSpanThrough_8x7, fillHistogram_8x7,
+		evaluateSpans_8x7 },
+	{ SP_FIAR_GEOMETRY_9X7, "9x7", 7, 9, 4, hasSpan_9x7, isSpanThrough_9x7, fillHistogram_9x7,
+		evaluateSpans_9x7 },
+	{ SP_FIAR_GEOMETRY_CONNECT_5, "connect5", 6, 9, 5, hasSpan_Connect5, isSpanThrough_Connect5, fillHistogram_Connect5,
+		evaluateSpans_Connect5 }
+};
+
+const SPFiarGeometry* spFiarGeometryGet(SP_FIAR_GEOMETRY_ID id) {
+	if (!(id >= 0 && id < SP_FIAR_N_GEOMETRIES)) {
+		return NULL;
+	}
+
+	return GEOMETRIES + id;
+}
+
+const SPFiarGeometry* spFiarGeometryFind(const char* name) {
+	int i;
+
+	if (name == NULL) {
+		return NULL;
+	}
+
+	for (i = 0; i < SP_FIAR_N_GEOMETRIES; i++) {
+		if (strcmp(GEOMETRIES[i].name, name) == 0) {
+			return GEOMETRIES + i;
+		}
+	}
+
+	return NULL;
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#ifndef SPFIARGEOMETRY_H_
+#define SPFIARGEOMETRY_H_
+#include <stdbool.h>
+
+/**
+ * SPFIARGeometry Summary:
+ *
+ * The board geometries a game can be played on: the number of rows and columns
+ * and the span, the number of discs in a row that wins. Every geometry has its
+ * own board kernels, instantiated at compile time from SPFIARGeometryKernel.h with
+ * its dimensions as constants, so their loops are folded and unrolled as in a
+ * hand-written kernel of that geometry. A game calls the kernels of its geometry.
+ *
+ * Boards of all geometries are stored in arrays of the maximal dimensions, only
+ * the cells in the first rows and columns of the geometry are used.
+ *
+ * spFiarGeometryGet   - Returns a supported geometry
+ * spFiarGeometryFind  - Returns the supported geometry of a name
+ */
+
+//Definitions
+#define SP_FIAR_GAME_MAX_ROWS 7
+#define SP_FIAR_GAME_MAX_COLUMNS 9
+#define SP_FIAR_GAME_MAX_SPAN 5
+
+/**
+ * The supported geometries, columns x rows
+ */
+typedef enum sp_fiar_geometry_id_t {
+	SP_FIAR_GEOMETRY_7X6,      // the classic connect-4 board
+	SP_FIAR_GEOMETRY_8X7,
+	SP_FIAR_GEOMETRY_9X7,
+	SP_FIAR_GEOMETRY_CONNECT_5, // 9 x 6, five in a row
+	SP_FIAR_N_GEOMETRIES
+} SP_FIAR_GEOMETRY_ID;
+
+#define SP_FIAR_GEOMETRY_DEFAULT SP_FIAR_GEOMETRY_7X6
+
+typedef struct sp_fiar_geometry_t {
+	SP_FIAR_GEOMETRY_ID id;
+	const char* name;
+	int rows;
+	int columns;
+	int span;
+
+	/*
+	 * Checks if the board has span discs of the symbol in a row, column or diagonal.
+	 */
+	bool (*hasSpan)(const char board[][SP_FIAR_GAME_MAX_COLUMNS], char symbol);
+
+	/*
+	 * Checks if a disc of the symbol in the cell (row, col) would be part of span
+	 * discs in a row, the cell itself is taken as the symbol whatever it holds.
+	 */
+	bool (*isSpanThrough)(const char board[][SP_FIAR_GAME_MAX_COLUMNS], int row, int col, char symbol);
+
+	/*
+	 * Adds every span of cells to the histogram, at the index of the number of
+	 * player 1 discs minus the number of player 2 discs in it, plus span.
+	 * The histogram must have 2 * span + 1 entries.
+	 */
+	void (*fillHistogram)(const char board[][SP_FIAR_GAME_MAX_COLUMNS], int histogram[]);
+
+	/*
+	 * Sums the values of the patterns of every span of cells. The pattern of a span
+	 * is a base 3 number whose digit m is its m-th cell: 0 if empty, 1 for a player 1
+	 * disc, 2 for a player 2 disc. The patterns table must have 3^span entries.
+	 */
+	int (*evaluateSpans)(const char board[][SP_FIAR_GAME_MAX_COLUMNS], const int patterns[]);
+} SPFiarGeometry;
+
+/**
+ * Returns a supported geometry.
+ *
+ * @param id - the id of the geometry
+ * @return
+ * NULL if id is out of range, the geometry otherwise.
+ */
+const SPFiarGeometry* spFiarGeometryGet(SP_FIAR_GEOMETRY_ID id);
+
+/**
+ * Returns the supported geometry of a name: "7x6", "8x7", "9x7" or "connect5".
+ *
+ * @param name - the name of the geometry
+ * @return
+ * NULL if name is NULL or not the name of a supported geometry, the geometry otherwise.
+ */
+const SPFiarGeometry* spFiarGeometryFind(const char* name);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,190 @@
+/*
+ * A template of the board kernels of a single geometry (see SPFIARGeometry.h).
+ * It has no include guard: every inclusion instantiates the kernels of the geometry
+ * given by the macros below, which are undefined at the end.
+ *
+ * SP_KERNEL_NAME    - the suffix of the kernel functions
+ * SP_KERNEL_ROWS    - the number of rows
+ * SP_KERNEL_COLUMNS - the number of columns
+ * SP_KERNEL_SPAN    - the span
+ *
+ * The dimensions are compile-time constants, so the compiler folds the bounds
+ * and fully unrolls the loops over the span.
+ */
+
+#define SP_KERNEL_CONCAT_(name, suffix) name##suffix
+#define SP_KERNEL_CONCAT(name, suffix) SP_KERNEL_CONCAT_(name, suffix)
+#define SP_KERNEL_FUNCTION(name) SP_KERNEL_CONCAT(name, SP_KERNEL_NAME)
+
+static bool SP_KERNEL_FUNCTION(hasSpan)(const char board[][SP_FIAR_GAME_MAX_COLUMNS], char symbol) {
+	int i, j, m;
+
+	// rows
+	for (i = 0; i < SP_KERNEL_ROWS; i++) {
+		for (j = 0; j + SP_KERNEL_SPAN <= SP_KERNEL_COLUMNS; j++) {
+			for (m = 0; m < SP_KERNEL_SPAN && board[i][j + m] == symbol; m++);
+
+			if (m == SP_KERNEL_SPAN)
+				return true;
+		}
+	}
+
+	// columns
+	for (i = 0; i + SP_KERNEL_SPAN <= SP_KERNEL_ROWS; i++) {
+		for (j = 0; j < SP_KERNEL_COLUMNS; j++) {
+			for (m = 0; m < SP_KERNEL_SPAN && board[i + m][j] == symbol; m++);
+
+			if (m == SP_KERNEL_SPAN)
+				return true;
+		}
+	}
+
+	// diagonals of type / and of type '\'
+	for (i = 0; i + SP_KERNEL_SPAN <= SP_KERNEL_ROWS; i++) {
+		for (j = 0; j + SP_KERNEL_SPAN <= SP_KERNEL_COLUMNS; j++) {
+			for (m = 0; m < SP_KERNEL_SPAN && board[i + m][j + m] == symbol; m++);
+
+			if (m == SP_KERNEL_SPAN)
+				return true;
+
+			for (m = 0; m < SP_KERNEL_SPAN && board[i + m][j + SP_KERNEL_SPAN - 1 - m] == symbol; m++);
+
+			if (m == SP_KERNEL_SPAN)
+				return true;
+		}
+	}
+
+	return false;
+}
+
+static bool SP_KERNEL_FUNCTION(isSpanThrough)(const char board[][SP_FIAR_GAME_MAX_COLUMNS], int row, int col, char symbol) {
+	int count, m;
+
+	// row
+	for (count = 1, m = 1; col - m >= 0 && board[row][col - m] == symbol; m++, count++);
+	for (m = 1; col + m < SP_KERNEL_COLUMNS && board[row][col + m] == symbol; m++, count++);
+
+	if (count >= SP_KERNEL_SPAN)
+		return true;
+
+	// column
+	for (count = 1, m = 1; row - m >= 0 && board[row - m][col] == symbol; m++, count++);
+	for (m = 1; row + m < SP_KERNEL_ROWS && board[row + m][col] == symbol; m++, count++);
+
+	if (count >= SP_KERNEL_SPAN)
+		return true;
+
+	// diagonal of type /
+	for (count = 1, m = 1; row - m >= 0 && col - m >= 0 && board[row - m][col - m] == symbol; m++, count++);
+	for (m = 1; row + m < SP_KERNEL_ROWS && col + m < SP_KERNEL_COLUMNS && board[row + m][col + m] == symbol; m++, count++);
+
+	if (count >= SP_KERNEL_SPAN)
+		return true;
+
+	// diagonal of type '\'
+	for (count = 1, m = 1; row - m >= 0 && col + m < SP_KERNEL_COLUMNS && board[row - m][col + m] == symbol; m++, count++);
+	for (m = 1; row + m < SP_KERNEL_ROWS && col - m >= 0 && board[row + m][col - m] == symbol; m++, count++);
+
+	return count >= SP_KERNEL_SPAN;
+}
+
+static void SP_KERNEL_FUNCTION(fillHistogram)(const char board[][SP_FIAR_GAME_MAX_COLUMNS], int histogram[]) {
+	int values[SP_KERNEL_ROWS][SP_KERNEL_COLUMNS], i, j, m, row, col, diag, anti_diag;
+
+	// 1 for player 1 discs, -1 for player 2 discs, 0 o/w
+	for (i = 0; i < SP_KERNEL_ROWS; i++) {
+		for (j = 0; j < SP_KERNEL_COLUMNS; j++) {
+			values[i][j] = (board[i][j] == SP_FIAR_GAME_PLAYER_1_SYMBOL) - (board[i][j] == SP_FIAR_GAME_PLAYER_2_SYMBOL);
+		}
+	}
+
+	// rows
+	for (i = 0; i < SP_KERNEL_ROWS; i++) {
+		for (j = 0; j + SP_KERNEL_SPAN <= SP_KERNEL_COLUMNS; j++) {
+			for (row = 0, m = 0; m < SP_KERNEL_SPAN; m++) {
+				row += values[i][j + m];
+			}
+
+			histogram[row + SP_KERNEL_SPAN]++;
+		}
+	}
+
+	// columns
+	for (i = 0; i + SP_KERNEL_SPAN <= SP_KERNEL_ROWS; i++) {
+		for (j = 0; j < SP_KERNEL_COLUMNS; j++) {
+			for (col = 0, m = 0; m < SP_KERNEL_SPAN; m++) {
+				col += values[i + m][j];
+			}
+
+			histogram[col + SP_KERNEL_SPAN]++;
+		}
+	}
+
+	// diagonals of type / and of type '\'
+	for (i = 0; i + SP_KERNEL_SPAN <= SP_KERNEL_ROWS; i++) {
+		for (j = 0; j + SP_KERNEL_SPAN <= SP_KERNEL_COLUMNS; j++) {
+			for (diag = 0, anti_diag = 0, m = 0; m < SP_KERNEL_SPAN; m++) {
+				diag += values[i + m][j + m];
+				anti_diag += values[i + m][j + SP_KERNEL_SPAN - 1 - m];
+			}
+
+			histogram[diag + SP_KERNEL_SPAN]++;
+			histogram[anti_diag + SP_KERNEL_SPAN]++;
+		}
+	}
+}
+
+static int SP_KERNEL_FUNCTION(evaluateSpans)(const char board[][SP_FIAR_GAME_MAX_COLUMNS], const int patterns[]) {
+	int codes[SP_KERNEL_ROWS][SP_KERNEL_COLUMNS], i, j, m, row, col, diag, anti_diag, score = 0;
+
+	// the digit of a cell: 1 for player 1 discs, 2 for player 2 discs, 0 o/w
+	for (i = 0; i < SP_KERNEL_ROWS; i++) {
+		for (j = 0; j < SP_KERNEL_COLUMNS; j++) {
+			codes[i][j] = (board[i][j] == SP_FIAR_GAME_PLAYER_1_SYMBOL) + 2 * (board[i][j] == SP_FIAR_GAME_PLAYER_2_SYMBOL);
+		}
+	}
+
+	// rows, the first cell of a span is its lowest digit
+	for (i = 0; i < SP_KERNEL_ROWS; i++) {
+		for (j = 0; j + SP_KERNEL_SPAN <= SP_KERNEL_COLUMNS; j++) {
+			for (row = 0, m = SP_KERNEL_SPAN - 1; m >= 0; m--) {
+				row = 3 * row + codes[i][j + m];
+			}
+
+			score += patterns[row];
+		}
+	}
+
+	// columns
+	for (i = 0; i + SP_KERNEL_SPAN <= SP_KERNEL_ROWS; i++) {
+		for (j = 0; j < SP_KERNEL_COLUMNS; j++) {
+			for (col = 0, m = SP_KERNEL_SPAN - 1; m >= 0; m--) {
+				col = 3 * col + codes[i + m][j];
+			}
+
+			score += patterns[col];
+		}
+	}
+
+	// diagonals of type / and of type '\'
+	for (i = 0; i + SP_KERNEL_SPAN <= SP_KERNEL_ROWS; i++) {
+		for (j = 0; j + SP_KERNEL_SPAN <= SP_KERNEL_COLUMNS; j++) {
+			for (diag = 0, anti_diag = 0, m = SP_KERNEL_SPAN - 1; m >= 0; m--) {
+				diag = 3 * diag + codes[i + m][j + m];
+				anti_diag = 3 * anti_diag + codes[i + m][j + SP_KERNEL_SPAN - 1 - m];
+			}
+
+			score += patterns[diag] + patterns[anti_diag];
+		}
+	}
+
+	return score;
+}
+
+#undef SP_KERNEL_FUNCTION
+#undef SP_KERNEL_CONCAT
+#undef SP_KERNEL_CONCAT_
+#undef SP_KERNEL_NAME
+#undef SP_KERNEL_ROWS
+#undef SP_KERNEL_COLUMNS
+#undef SP_KERNEL_SPAN
\ No newline at end of file
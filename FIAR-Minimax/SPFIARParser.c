@@ -1,143 +1,248 @@
 #include "SPFIARParser.h"
 #include "SPFIARParserAdditionalHeaders.h"
 #include <string.h>
-#include <stdlib.h>
-#include <ctype.h>
 #include <limits.h>
 
 /*
-* Checks if the string is an integer number.
-* Assumes str is of length 1024 at most, and str is not NULL.
+* Checks if a char is one of the separators of SEP.
 *
-* @return true iff the string represents an integer number.
+* @param c the char
+* @return true iff c separates tokens
 */
-static bool isIntegerNumber(const char* str) {
-	int i = 0;
-	
-	// check first digit
-	if (!isdigit(str[i])) {
-		if (str[i] != '-' && str[i] != '+')
-			return false;
+static bool isSeparator(char c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
 
-		// negative number or starts with +
-		if (!isdigit(str[++i]))
-			return false;
+/*
+* Checks if a char is a decimal digit, as isdigit in the C locale.
+*
+* @param c the char
+* @return true iff c is a digit
+*/
+static bool isDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+/*
+* Finds the next token of a string, the string isn't changed. A null char ends
+* the string before its end.
+*
+* @param str the string
+* @param end the end of the string
+* @param length set to the length of the token
+* @return the start of the token, NULL if there are no more tokens
+*/
+static const char* nextToken(const char* str, const char* end, size_t* length) {
+	const char* token;
+
+	while (str < end && isSeparator(*str)) {
+		str++;
 	}
-		
-	for (; i < SP_MAX_LINE_LENGTH; i++) {
-		if (str[i] == '\0')
-			return true;
-		if (!isdigit(str[i]))
-			return false;
+
+	if (str == end || *str == '\0') {
+		return NULL;
 	}
 
-	// no null terminator
-	return false;
+	for (token = str; str < end && *str != '\0' && !isSeparator(*str); str++);
+
+	*length = str - token;
+
+	return token;
 }
 
-bool spParserIsInt(const char* str) {
-	char str_copied[SP_MAX_LINE_LENGTH + 1], *token;
-	long long result;
+/*
+* Checks if a token is an integer number in the range of int: an optional sign
+* and then digits only. The digits of a token cut by the line length may go on
+* past its end, those count for the range but not for the syntax.
+*
+* @param token the token
+* @param length the length of the token
+* @param cut true iff the token is cut, its string goes on up to a null char
+* @param value set to the number if it is valid
+* @return true iff the token is an integer number in the range of int
+*/
+static bool parseInteger(const char* token, size_t length, bool cut, int* value) {
+	const char *digit = token, *end = token + length;
+	bool negative = false;
+	long long result = 0;
+
+	if (*digit == '-' || *digit == '+') {
+		negative = *digit == '-';
+		digit++;
+	}
 
-	if (str == NULL) {
+	if (digit == end) {
 		return false;
 	}
 
-	// copy the line to prevent a case where str is not null terminated
-	strncpy(str_copied, str, SP_MAX_LINE_LENGTH);
-	str_copied[SP_MAX_LINE_LENGTH] = '\0';
-
-	// get the number token
-	token = strtok(str_copied, SEP);
+	for (; digit < end; digit++) {
+		if (!isDigit(*digit)) {
+			return false;
+		}
+	}
 
-	if (token == NULL) {
+	// a token of the whole line length was never accepted
+	if (length >= SP_MAX_LINE_LENGTH) {
 		return false;
 	}
 
-	if (!isIntegerNumber(token))
+	for (digit = token + (*token == '-' || *token == '+'); (digit < end || cut) && isDigit(*digit); digit++) {
+		result = result * 10 + (*digit - '0');
+
+		// out of range already, more digits only grow it
+		if (result > (long long)INT_MAX + 1) {
+			return false;
+		}
+	}
+
+	result = negative ? -result : result;
+
+	if (!(INT_MIN <= result && result <= INT_MAX)) {
 		return false;
+	}
+
+	*value = (int)result;
+
+	return true;
+}
+
+/*
+* Returns the length of a null terminated string, SP_MAX_LINE_LENGTH at most.
+*
+* @param str the string
+* @return the length of the string that the parser reads
+*/
+static size_t lineLength(const char* str) {
+	size_t length;
 
-	// see that there are no more token
-	token = strtok(NULL, SEP);
+	for (length = 0; length < SP_MAX_LINE_LENGTH && str[length] != '\0'; length++);
 
-	if (token != NULL) {
+	return length;
+}
+
+/*
+* Checks if a token is the specified keyword.
+*
+* @param token the token
+* @param length the length of the token
+* @param keyword the keyword
+* @param keywordLength the length of the keyword
+* @return true iff the token equals the keyword
+*/
+static bool isKeyword(const char* token, size_t length, const char* keyword, size_t keywordLength) {
+	return length == keywordLength && memcmp(token, keyword, length) == 0;
+}
+
+bool spParserIsInt(const char* str) {
+	const char *token, *end;
+	size_t length, extra;
+	int value;
+
+	if (str == NULL) {
 		return false;
 	}
 
-	// check if the number can be converted to long
-	result = strtoll(str, NULL, 10);
-	
-	// if the number is 0, the check isn't ok
-	//if (!result)
-	//	return false;
+	// only the first SP_MAX_LINE_LENGTH chars are tokens, a number may go on past them
+	end = str + lineLength(str);
+	token = nextToken(str, end, &length);
 
-	// the number is not in the integer range
-	if (!(INT_MIN <= result && result <= INT_MAX))
-		return false; 
+	if (token == NULL || nextToken(token + length, end, &extra) != NULL) {
+		return false;
+	}
 
-	return true;
+	return parseInteger(token, length, token + length == end && *end != '\0', &value);
 }
 
-SPCommand spParserPraseLine(const char* str) {
+SPCommand spParserParseCommand(const char* str, size_t length) {
 	SPCommand sp_cmd;
-	char line[SP_MAX_LINE_LENGTH + 1], *token;
-	int param;
+	const char *token, *end;
+	size_t token_length;
 
 	// set to invalid line by default
 	sp_cmd.cmd = SP_INVALID_LINE;
 	sp_cmd.validArg = false;
+	sp_cmd.arg = 0;
 
-	// check if the string is null
 	if (str == NULL) {
 		return sp_cmd;
 	}
 
-	// copy the line to prevent a case where str is not null terminated
-	strncpy(line, str, SP_MAX_LINE_LENGTH);
-	line[SP_MAX_LINE_LENGTH] = '\0';
+	// the line ends after SP_MAX_LINE_LENGTH chars, or at a null char (see nextToken)
+	if (length > SP_MAX_LINE_LENGTH) {
+		length = SP_MAX_LINE_LENGTH;
+	}
 
-	// get the first token - command string
-	token = strtok(line, SEP);
+	end = str + length;
 
-	if (token == NULL) {
+	// get the first token - command string
+	if ((token = nextToken(str, end, &token_length)) == NULL) {
 		return sp_cmd;
 	}
 
-	// switch-case
-	if (strcmp(token, ADD_DISC) == 0) {
-		token = strtok(NULL, SEP);
+	if (isKeyword(token, token_length, ADD_DISC, sizeof(ADD_DISC) - 1)) {
+		token = nextToken(token + token_length, end, &token_length);
 
 		// check if second token is valid param
-		if ((token != NULL) && (param = spParserIsInt(token))) {
-			sp_cmd.validArg = true;
-			sp_cmd.arg = atoi(token);
-			sp_cmd.cmd = SP_ADD_DISC;
-		}
-
-		else {
+		if (token == NULL || !parseInteger(token, token_length, false, &sp_cmd.arg)) {
 			return sp_cmd;
 		}
+
+		// the tokens after the argument have always been ignored
+		sp_cmd.validArg = true;
+		sp_cmd.cmd = SP_ADD_DISC;
+
+		return sp_cmd;
 	}
-	else if (strcmp(token, SUGGEST_MOVE) == 0) {
+	else if (isKeyword(token, token_length, SUGGEST_MOVE, sizeof(SUGGEST_MOVE) - 1)) {
 		sp_cmd.cmd = SP_SUGGEST_MOVE;
 	}
-	else if (strcmp(token, UNDO_MOVE) == 0) {
+	else if (isKeyword(token, token_length, UNDO_MOVE, sizeof(UNDO_MOVE) - 1)) {
 		sp_cmd.cmd = SP_UNDO_MOVE;
 	}
-	else if (strcmp(token, QUIT) == 0) {
+	else if (isKeyword(token, token_length, QUIT, sizeof(QUIT) - 1)) {
 		sp_cmd.cmd = SP_QUIT;
 	}
-	else if (strcmp(token, RESTART_GAME) == 0) {
+	else if (isKeyword(token, token_length, RESTART_GAME, sizeof(RESTART_GAME) - 1)) {
 		sp_cmd.cmd = SP_RESTART;
 	}
 
 	// check if the string has ended
-	token = strtok(NULL, SEP);
-
-	if (token != NULL) {
+	if (nextToken(token + token_length, end, &token_length) != NULL) {
 		sp_cmd.cmd = SP_INVALID_LINE;
 		sp_cmd.validArg = false;
 	}
 
 	return sp_cmd;
-}
\ No newline at end of file
+}
+
+SPCommand spParserPraseLine(const char* str) {
+	if (str == NULL) {
+		return spParserParseCommand(NULL, 0);
+	}
+
+	return spParserParseCommand(str, lineLength(str));
+}
+
+int spParserParseLines(const char* buffer, size_t size, SPCommand* commands, int maxCommands, size_t* consumed) {
+	const char *line = buffer, *end = buffer + size, *newline;
+	int count = 0;
+
+	if (consumed != NULL) {
+		*consumed = 0;
+	}
+
+	if (buffer == NULL || commands == NULL) {
+		return 0;
+	}
+
+	while (count < maxCommands && line < end && (newline = memchr(line, '\n', end - line)) != NULL) {
+		commands[count++] = spParserParseCommand(line, newline - line);
+		line = newline + 1;
+	}
+
+	if (consumed != NULL) {
+		*consumed = line - buffer;
+	}
+
+	return count;
+}
@@ -1,6 +1,7 @@
 #ifndef SPFIARPARSER_H_
 #define SPFIARPARSER_H_
 #include <stdbool.h>
+#include <stddef.h>
 
 //specify the maximum line length
 #define SP_MAX_LINE_LENGTH 1024
@@ -47,4 +48,33 @@ bool spParserIsInt(const char* str);
  */
 SPCommand spParserPraseLine(const char* str);
 
+/**
+ * Parses a line of the specified length, as spParserPraseLine does, without
+ * copying or changing it. The line need not be null terminated: it ends after
+ * length chars, at a null char or after SP_MAX_LINE_LENGTH chars, whichever
+ * comes first.
+ *
+ * @param str - the line
+ * @param length - the number of chars of the line
+ * @return
+ * The parsed line, as spParserPraseLine returns it. arg is 0 if validArg is false.
+ */
+SPCommand spParserParseCommand(const char* str, size_t length);
+
+/**
+ * Parses the lines of a buffer in place, a command per line, in a single pass.
+ * Every line is parsed as spParserParseCommand does. Only complete lines (ended
+ * by '\n') are parsed, so a stream can be parsed a buffer at a time: the rest of
+ * a buffer is the start of its next one. The buffer isn't changed.
+ *
+ * @param buffer - the buffer, need not be null terminated
+ * @param size - the number of chars in the buffer
+ * @param commands - the array to fill, in the order of the lines
+ * @param maxCommands - the length of commands
+ * @param consumed - if not NULL, set to the number of chars of the parsed lines
+ * @return
+ * The number of parsed commands, 0 if buffer or commands is NULL.
+ */
+int spParserParseLines(const char* buffer, size_t size, SPCommand* commands, int maxCommands, size_t* consumed);
+
 #endif
@@ -0,0 +1,304 @@
+#define _POSIX_C_SOURCE 200112L
+#include "SPGameRecord.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MAX_LEVEL_VALUE 255
+#define RESULT_BITS 0x03
+#define GEOMETRY_SHIFT 2
+#define GEOMETRY_BITS 0x07
+#define MODE_SHIFT 5
+#define MODE_BITS 0x07
+
+/*
+* Returns the number of bits of a move on a geometry.
+* Assumes geometry is not null.
+*
+* @param geometry the geometry
+* @return 3 if the columns fit in 3 bits, 4 otherwise
+*/
+static int getMoveBits(const SPFiarGeometry* geometry) {
+	return geometry->columns <= 8 ? 3 : 4;
+}
+
+/*
+* Returns the number of bytes of the packed moves of a record.
+*
+* @param length the number of moves
+* @param move_bits the bits of a move
+* @return the number of bytes
+*/
+static size_t getMovesSize(int length, int move_bits) {
+	return ((size_t)length * move_bits + 7) / 8;
+}
+
+/*
+* Returns the record result of a game.
+* Assumes game is not null.
+*
+* @param game the game
+* @return the result of the game
+*/
+static SP_GAME_RECORD_RESULT getGameResult(SPFiarGame* game) {
+	switch (spFiarCheckWinner(game)) {
+	case SP_FIAR_GAME_PLAYER_1_SYMBOL:
+		return SP_GAME_RECORD_PLAYER_1_WINS;
+	case SP_FIAR_GAME_PLAYER_2_SYMBOL:
+		return SP_GAME_RECORD_PLAYER_2_WINS;
+	case SP_FIAR_GAME_TIE_SYMBOL:
+		return SP_GAME_RECORD_DRAW;
+	default:
+		return SP_GAME_RECORD_UNFINISHED;
+	}
+}
+
+size_t spGameRecordEncode(SPFiarGame* game, const SPMinimaxConfig* config, unsigned int level,
+	unsigned char* dest, size_t size) {
+	SP_MINIMAX_MODE mode = (config == NULL) ? SP_MINIMAX_MODE_PLAIN : config->mode;
+	int i, length, discs = 0, move_bits, bit;
+	size_t record_size;
+
+	if ((void*)game == NULL || dest == NULL || level > MAX_LEVEL_VALUE) {
+		return 0;
+	}
+
+	for (i = 0; i < game->geometry->columns; i++) {
+		discs += (game->tops)[i];
+	}
+
+	// the first moves may have been dropped from a full history
+	if ((length = spArrayListSize(game->history)) != discs) {
+		return 0;
+	}
+
+	move_bits = getMoveBits(game->geometry);
+	record_size = SP_GAME_RECORD_HEADER_SIZE + getMovesSize(length, move_bits);
+
+	if (record_size > size) {
+		return 0;
+	}
+
+	dest[0] = (unsigned char)(getGameResult(game) | (game->geometry->id << GEOMETRY_SHIFT) | (mode << MODE_SHIFT));
+	dest[1] = (unsigned char)length;
+	dest[2] = (unsigned char)level;
+	memset(dest + SP_GAME_RECORD_HEADER_SIZE, 0, record_size - SP_GAME_RECORD_HEADER_SIZE);
+
+	for (i = 0; i < length; i++) {
+		bit = i * move_bits;
+
+		// a move may cross a byte boundary
+		dest[SP_GAME_RECORD_HEADER_SIZE + bit / 8] |= (unsigned char)(spArrayListGetAt(game->history, i) << (bit % 8));
+
+		if (bit % 8 + move_bits > 8) {
+			dest[SP_GAME_RECORD_HEADER_SIZE + bit / 8 + 1] |= (unsigned char)(spArrayListGetAt(game->history, i) >> (8 - bit % 8));
+		}
+	}
+
+	return record_size;
+}
+
+SPGameRecordWriter* spGameRecordWriterOpen(const char* path) {
+	unsigned char header[SP_GAME_RECORD_FILE_HEADER_SIZE] = { 0 };
+	SPGameRecordWriter* writer;
+
+	if (path == NULL) {
+		return NULL;
+	}
+
+	writer = (SPGameRecordWriter*)malloc(sizeof(SPGameRecordWriter));
+
+	if ((void*)writer == NULL) {
+		return NULL;
+	}
+
+	if ((writer->file = fopen(path, "wb")) == NULL) {
+		free(writer);
+		return NULL;
+	}
+
+	memcpy(header, SP_GAME_RECORD_MAGIC, strlen(SP_GAME_RECORD_MAGIC));
+	header[strlen(SP_GAME_RECORD_MAGIC)] = SP_GAME_RECORD_VERSION;
+
+	if (fwrite(header, 1, sizeof(header), writer->file) != sizeof(header)) {
+		fclose(writer->file);
+		free(writer);
+		return NULL;
+	}
+
+	writer->count = 0;
+
+	return writer;
+}
+
+SP_GAME_RECORD_MESSAGE spGameRecordWrite(SPGameRecordWriter* writer, SPFiarGame* game,
+	const SPMinimaxConfig* config, unsigned int level) {
+	unsigned char record[SP_GAME_RECORD_MAX_SIZE];
+	size_t size;
+
+	if ((void*)writer == NULL || (size = spGameRecordEncode(game, config, level, record, sizeof(record))) == 0) {
+		return SP_GAME_RECORD_INVALID_ARGUMENT;
+	}
+
+	if (fwrite(record, 1, size, writer->file) != size) {
+		return SP_GAME_RECORD_IO_ERROR;
+	}
+
+	writer->count++;
+
+	return SP_GAME_RECORD_SUCCESS;
+}
+
+SP_GAME_RECORD_MESSAGE spGameRecordWriterClose(SPGameRecordWriter* writer) {
+	int failed;
+
+	if ((void*)writer == NULL) {
+		return SP_GAME_RECORD_INVALID_ARGUMENT;
+	}
+
+	failed = ferror(writer->file) || fclose(writer->file) != 0;
+	free(writer);
+
+	return failed ? SP_GAME_RECORD_IO_ERROR : SP_GAME_RECORD_SUCCESS;
+}
+
+SPGameRecordReader* spGameRecordReaderOpen(const char* path) {
+	SPGameRecordReader* reader;
+	struct stat st;
+	void* data;
+	int fd;
+
+	if (path == NULL || (fd = open(path, O_RDONLY)) < 0) {
+		return NULL;
+	}
+
+	if (fstat(fd, &st) != 0 || st.st_size < SP_GAME_RECORD_FILE_HEADER_SIZE) {
+		close(fd);
+		return NULL;
+	}
+
+	data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping stays valid without the descriptor
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		return NULL;
+	}
+
+	if (memcmp(data, SP_GAME_RECORD_MAGIC, strlen(SP_GAME_RECORD_MAGIC)) != 0 ||
+		((const unsigned char*)data)[strlen(SP_GAME_RECORD_MAGIC)] != SP_GAME_RECORD_VERSION) {
+		munmap(data, (size_t)st.st_size);
+		return NULL;
+	}
+
+	reader = (SPGameRecordReader*)malloc(sizeof(SPGameRecordReader));
+
+	if ((void*)reader == NULL) {
+		munmap(data, (size_t)st.st_size);
+		return NULL;
+	}
+
+	// the records are read in order
+	posix_madvise(data, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+
+	reader->data = (const unsigned char*)data;
+	reader->size = (size_t)st.st_size;
+	reader->offset = SP_GAME_RECORD_FILE_HEADER_SIZE;
+	reader->count = 0;
+
+	return reader;
+}
+
+SP_GAME_RECORD_MESSAGE spGameRecordReaderNext(SPGameRecordReader* reader, SPGameRecord* record) {
+	const unsigned char* header;
+	int geometry_id, mode;
+	size_t size;
+
+	if ((void*)reader == NULL || (void*)record == NULL) {
+		return SP_GAME_RECORD_INVALID_ARGUMENT;
+	}
+
+	if (reader->offset == reader->size) {
+		return SP_GAME_RECORD_END;
+	}
+
+	if (reader->size - reader->offset < SP_GAME_RECORD_HEADER_SIZE) {
+		return SP_GAME_RECORD_INVALID_FORMAT;
+	}
+
+	header = reader->data + reader->offset;
+	geometry_id = (header[0] >> GEOMETRY_SHIFT) & GEOMETRY_BITS;
+	mode = (header[0] >> MODE_SHIFT) & MODE_BITS;
+
+	if (geometry_id >= SP_FIAR_N_GEOMETRIES || mode > SP_MINIMAX_MODE_MCTS) {
+		return SP_GAME_RECORD_INVALID_FORMAT;
+	}
+
+	record->result = (SP_GAME_RECORD_RESULT)(header[0] & RESULT_BITS);
+	record->geometry = spFiarGeometryGet((SP_FIAR_GEOMETRY_ID)geometry_id);
+	record->mode = (SP_MINIMAX_MODE)mode;
+	record->length = header[1];
+	record->level = header[2];
+	record->moves = header + SP_GAME_RECORD_HEADER_SIZE;
+
+	size = SP_GAME_RECORD_HEADER_SIZE + getMovesSize(record->length, getMoveBits(record->geometry));
+
+	if (record->length > record->geometry->rows * record->geometry->columns || reader->size - reader->offset < size) {
+		return SP_GAME_RECORD_INVALID_FORMAT;
+	}
+
+	reader->offset += size;
+	reader->count++;
+
+	return SP_GAME_RECORD_SUCCESS;
+}
+
+void spGameRecordReaderClose(SPGameRecordReader* reader) {
+	if ((void*)reader == NULL) {
+		return;
+	}
+
+	munmap((void*)reader->data, reader->size);
+	free(reader);
+}
+
+int spGameRecordGetMove(const SPGameRecord* record, int index) {
+	int move_bits, bit, value;
+
+	if ((void*)record == NULL || !(index >= 0 && index < record->length)) {
+		return -1;
+	}
+
+	move_bits = getMoveBits(record->geometry);
+	bit = index * move_bits;
+	value = record->moves[bit / 8] >> (bit % 8);
+
+	// a move may cross a byte boundary
+	if (bit % 8 + move_bits > 8) {
+		value |= record->moves[bit / 8 + 1] << (8 - bit % 8);
+	}
+
+	return value & ((1 << move_bits) - 1);
+}
+
+SP_GAME_RECORD_MESSAGE spGameRecordReplay(const SPGameRecord* record, SPFiarGame* game, int count) {
+	int i;
+
+	if ((void*)record == NULL || (void*)game == NULL || !(count >= 0 && count <= record->length)) {
+		return SP_GAME_RECORD_INVALID_ARGUMENT;
+	}
+
+	spFiarGameReset(game, record->geometry);
+
+	for (i = 0; i < count; i++) {
+		if (spFiarGameSetMove(game, spGameRecordGetMove(record, i)) != SP_FIAR_GAME_SUCCESS) {
+			return SP_GAME_RECORD_INVALID_FORMAT;
+		}
+	}
+
+	return SP_GAME_RECORD_SUCCESS;
+}
\ No newline at end of file
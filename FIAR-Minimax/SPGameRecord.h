@@ -0,0 +1,200 @@
+#ifndef SPGAMERECORD_H_
+#define SPGAMERECORD_H_
+#include <stdio.h>
+#include <stddef.h>
+#include "SPFIARGame.h"
+#include "SPMinimax.h"
+
+/**
+ * SPGameRecord Summary:
+ *
+ * A compact binary format of game archives, a file header followed by one record
+ * per game. A record is a header of 3 bytes and the columns of the moves packed at
+ * 3 bits per move (4 bits on the geometries of 9 columns), so a full classic game
+ * takes 19 bytes.
+ *
+ * The file header is the magic "FIAR", a version byte and 3 reserved bytes.
+ * The record header is:
+ *   byte 0 - the result (bits 0-1, see SP_GAME_RECORD_RESULT), the geometry id
+ *            (bits 2-4) and the engine mode (bits 5-7)
+ *   byte 1 - the number of moves
+ *   byte 2 - the engine level
+ * The moves follow, the first one in the lowest bits of the first byte.
+ *
+ * Archives are written as a stream and read from a read only memory mapping:
+ * the reader iterates the records in place, without any allocation per game.
+ *
+ * spGameRecordEncode        - Encodes a game as a record into a buffer
+ * spGameRecordWriterOpen    - Creates an archive file for writing
+ * spGameRecordWrite         - Appends a game to an archive
+ * spGameRecordWriterClose   - Finishes an archive and frees its writer
+ * spGameRecordReaderOpen    - Maps an archive file for reading
+ * spGameRecordReaderNext    - Reads the next record of an archive
+ * spGameRecordReaderClose   - Unmaps an archive and frees its reader
+ * spGameRecordGetMove       - Returns a move of a record
+ * spGameRecordReplay        - Replays the moves of a record on a game
+ */
+
+//Definitions
+#define SP_GAME_RECORD_MAGIC "FIAR"
+#define SP_GAME_RECORD_VERSION 1
+#define SP_GAME_RECORD_FILE_HEADER_SIZE 8
+#define SP_GAME_RECORD_HEADER_SIZE 3
+// the maximal size of an encoded record
+#define SP_GAME_RECORD_MAX_SIZE (SP_GAME_RECORD_HEADER_SIZE + \
+	(SP_FIAR_GAME_MAX_ROWS * SP_FIAR_GAME_MAX_COLUMNS * 4 + 7) / 8)
+
+/**
+ * Type used for returning error codes from record functions
+ */
+typedef enum sp_game_record_message_t {
+	SP_GAME_RECORD_INVALID_ARGUMENT,
+	SP_GAME_RECORD_INVALID_FORMAT, // a corrupt or truncated archive
+	SP_GAME_RECORD_IO_ERROR,
+	SP_GAME_RECORD_END,            // no more records
+	SP_GAME_RECORD_SUCCESS
+} SP_GAME_RECORD_MESSAGE;
+
+/**
+ * The result of a recorded game
+ */
+typedef enum sp_game_record_result_t {
+	SP_GAME_RECORD_UNFINISHED,
+	SP_GAME_RECORD_PLAYER_1_WINS,
+	SP_GAME_RECORD_PLAYER_2_WINS,
+	SP_GAME_RECORD_DRAW
+} SP_GAME_RECORD_RESULT;
+
+/**
+ * A record of an archive. The moves point into the mapping of the archive, so
+ * a record is valid until its reader is closed.
+ */
+typedef struct sp_game_record_t {
+	SP_GAME_RECORD_RESULT result;
+	const SPFiarGeometry* geometry;
+	SP_MINIMAX_MODE mode;
+	unsigned int level;
+	int length;                 // the number of moves
+	const unsigned char* moves; // the packed moves
+} SPGameRecord;
+
+typedef struct sp_game_record_writer_t {
+	FILE* file;
+	unsigned long count; // the number of records written
+} SPGameRecordWriter;
+
+typedef struct sp_game_record_reader_t {
+	const unsigned char* data; // the mapped archive
+	size_t size;
+	size_t offset;             // the offset of the next record
+	unsigned long count;       // the number of records read
+} SPGameRecordReader;
+
+/**
+ * Encodes a game as a record. The game must hold all of its moves from the empty
+ * board in its history.
+ *
+ * @param game - the game
+ * @param config - the engine configuration that played the game, NULL for the default
+ * @param level - the engine level that played the game, at most 255
+ * @param dest - the buffer to write the record to
+ * @param size - the size of dest, SP_GAME_RECORD_MAX_SIZE is always enough
+ * @return
+ * 0 if game or dest is NULL, the history of game doesn't hold all of its moves,
+ * level > 255 or dest is too small. Otherwise, the size of the record.
+ */
+size_t spGameRecordEncode(SPFiarGame* game, const SPMinimaxConfig* config, unsigned int level,
+	unsigned char* dest, size_t size);
+
+/**
+ * Creates an archive file, replacing an existing one, and writes its header.
+ *
+ * @param path - the path of the file
+ * @return
+ * NULL if path is NULL, the file can't be written or a memory allocation failure
+ * occurred. Otherwise, the writer of the archive.
+ */
+SPGameRecordWriter* spGameRecordWriterOpen(const char* path);
+
+/**
+ * Appends a game to an archive, see spGameRecordEncode.
+ *
+ * @param writer - the writer of the archive
+ * @param game - the game
+ * @param config - the engine configuration that played the game, NULL for the default
+ * @param level - the engine level that played the game
+ * @return
+ * SP_GAME_RECORD_INVALID_ARGUMENT - if writer is NULL or the game can't be encoded
+ * SP_GAME_RECORD_IO_ERROR         - if writing failed
+ * SP_GAME_RECORD_SUCCESS          - otherwise
+ */
+SP_GAME_RECORD_MESSAGE spGameRecordWrite(SPGameRecordWriter* writer, SPFiarGame* game,
+	const SPMinimaxConfig* config, unsigned int level);
+
+/**
+ * Flushes an archive, closes its file and frees its writer.
+ *
+ * @param writer - the writer, if NULL nothing happens
+ * @return
+ * SP_GAME_RECORD_INVALID_ARGUMENT - if writer is NULL
+ * SP_GAME_RECORD_IO_ERROR         - if flushing the file failed
+ * SP_GAME_RECORD_SUCCESS          - otherwise
+ */
+SP_GAME_RECORD_MESSAGE spGameRecordWriterClose(SPGameRecordWriter* writer);
+
+/**
+ * Maps an archive file for reading and checks its header.
+ *
+ * @param path - the path of the file
+ * @return
+ * NULL if path is NULL, the file can't be mapped, it isn't an archive or a memory
+ * allocation failure occurred. Otherwise, the reader of the archive, at its first record.
+ */
+SPGameRecordReader* spGameRecordReaderOpen(const char* path);
+
+/**
+ * Reads the next record of an archive.
+ *
+ * @param reader - the reader
+ * @param record - set to the record on success
+ * @return
+ * SP_GAME_RECORD_INVALID_ARGUMENT - if reader or record is NULL
+ * SP_GAME_RECORD_INVALID_FORMAT   - if the next record is corrupt or truncated
+ * SP_GAME_RECORD_END              - if there are no more records
+ * SP_GAME_RECORD_SUCCESS          - otherwise
+ */
+SP_GAME_RECORD_MESSAGE spGameRecordReaderNext(SPGameRecordReader* reader, SPGameRecord* record);
+
+/**
+ * Unmaps an archive and frees its reader. The records read become invalid.
+ *
+ * @param reader - the reader, if NULL nothing happens
+ */
+void spGameRecordReaderClose(SPGameRecordReader* reader);
+
+/**
+ * Returns a move of a record.
+ *
+ * @param record - the record
+ * @param index - the index of the move, 0-based
+ * @return
+ * -1 if record is NULL or index is out of range, the column of the move otherwise.
+ */
+int spGameRecordGetMove(const SPGameRecord* record, int index);
+
+/**
+ * Replays the first moves of a record on a game. The game is reset to the empty
+ * board of the geometry of the record first (see spFiarGameReset), so a single
+ * game can replay a whole archive.
+ *
+ * @param record - the record
+ * @param game - the game to replay on
+ * @param count - the number of moves to replay, at most the length of the record
+ * @return
+ * SP_GAME_RECORD_INVALID_ARGUMENT - if record or game is NULL or count is out of range
+ * SP_GAME_RECORD_INVALID_FORMAT   - if a move of the record is invalid
+ * SP_GAME_RECORD_SUCCESS          - otherwise
+ */
+SP_GAME_RECORD_MESSAGE spGameRecordReplay(const SPGameRecord* record, SPFiarGame* game, int count);
+
+#endif
\ No newline at end of file
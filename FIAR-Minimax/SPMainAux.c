@@ -1,35 +1,144 @@
 #include "SPMainAux.h"
+#include <stdarg.h>
 
-/**
-*  Gets a command from the user and removes trailing \n.
-*  @param cmd the command
-*  @return the command without trailing \n
+#define INITIAL_OUTPUT_SIZE 4096
+
+/*
+Prints a message of the game to the output of the session.
+@param session - the session
+@param format - the format of the message, as printf
 */
-static char* getCommandFromUserStripped(char * cmd) {
-	int i;
+static void print(SP_GAME_SESSION* session, const char* format, ...) {
+	SP_GAME_OUTPUT* output = &session->output;
+	va_list args, copied;
+	size_t capacity;
+	char* data;
+	int size;
+
+	if (output->discard || output->failed) {
+		return;
+	}
+
+	va_start(args, format);
 
-	if (fgets(cmd, SP_MAX_LINE_LENGTH + 1, stdin) == NULL) {
-		return NULL;
+	if (output->file != NULL) {
+		vfprintf(output->file, format, args);
+		va_end(args);
+		return;
 	}
 
-	for (i = 0; i < SP_MAX_LINE_LENGTH + 1 && cmd[i] != NULL_CHARACTER; i++) {
-		if (cmd[i] == '\n') {
-			cmd[i] = NULL_CHARACTER;
+	va_copy(copied, args);
+	size = vsnprintf(NULL, 0, format, copied);
+	va_end(copied);
+
+	if (size >= 0 && output->size + size + 1 > output->capacity) {
+		for (capacity = output->capacity > 0 ? output->capacity : INITIAL_OUTPUT_SIZE;
+			output->size + size + 1 > capacity; capacity *= 2);
+
+		if ((data = (char*)realloc(output->data, capacity)) == NULL) {
+			output->failed = true;
+			size = -1;
+		}
+		else {
+			output->data = data;
+			output->capacity = capacity;
 		}
 	}
 
-	return cmd;
+	if (size >= 0) {
+		vsnprintf(output->data + output->size, size + 1, format, args);
+		output->size += size;
+	}
+
+	va_end(args);
+}
+
+/*
+Prints a prompt of the game, if the session has prompts.
+@param session - the session
+@param message - the prompt
+*/
+static void prompt(SP_GAME_SESSION* session, const char* message) {
+	if (session->prompts) {
+		print(session, "%s", message);
+	}
+}
+
+/*
+Prints the board of the game, if the session has prompts.
+@param session - the session
+*/
+static void printBoard(SP_GAME_SESSION* session) {
+	if (session->prompts) {
+		spFiarGamePrintBoard(session->game);
+	}
+}
+
+/**
+*  Gets the next line of the input and parses it by spParserParseLines.
+*  A line of a file longer than SP_MAX_LINE_LENGTH is read in parts, a command each,
+*  as the interactive game always read it. A line of a script is cut by the parser.
+*  @param session - the session
+*  @param line - set to the line, without its '\n'
+*  @param length - set to the length of the line
+*  @param cmd - set to the parsed command
+*  @return false iff the input has ended
+*/
+static bool nextLine(SP_GAME_SESSION* session, const char** line, size_t* length, SPCommand* cmd) {
+	SP_GAME_INPUT* input = &session->input;
+	size_t consumed;
+
+	// a file is read a line at a time, after the prompt
+	if (input->size == 0 && input->file != NULL) {
+		if (fgets(input->line, SP_MAX_LINE_LENGTH + 1, input->file) == NULL) {
+			return false;
+		}
+
+		input->size = strlen(input->line);
+
+		// the rest of a long line is the next part, the last line may have no '\n'
+		if (input->size == 0 || input->line[input->size - 1] != '\n') {
+			input->line[input->size++] = '\n';
+		}
+
+		input->data = input->line;
+	}
+
+	if (spParserParseLines(input->data, input->size, cmd, 1, &consumed) == 0) {
+		return false;
+	}
+
+	*line = input->data;
+	*length = consumed - 1;
+	input->data += consumed;
+	input->size -= consumed;
+
+	return true;
+}
+
+/**
+*  Gets and parses the next command of the input.
+*  @param session - the session
+*  @param cmd - set to the parsed command
+*  @return false iff the input has ended
+*/
+static bool nextCommand(SP_GAME_SESSION* session, SPCommand* cmd) {
+	const char* line;
+	size_t length;
+
+	return nextLine(session, &line, &length, cmd);
 }
 
 
 /*
 Called when user wants to undo his move.
 Undoes 2 moves - the user move and the previous computer move.
-@param game - the game
+@param session - the session
 @return
-false iff there's no history 
+false iff there's no history
 */
-static bool undoUserMove(SPFiarGame* game) {
+static bool undoUserMove(SP_GAME_SESSION* session) {
+	SPFiarGame* game = session->game;
 	SP_FIAR_GAME_MESSAGE msg;
 
 	int computer_last_move = spArrayListGetLast(game->history),
@@ -43,21 +152,22 @@ static bool undoUserMove(SPFiarGame* game) {
 
 	spFiarGameUndoPrevMove(game);
 
-	printf("Remove disc: remove computer's disc at column %d\n", computer_last_move + 1);
-	printf("Remove disc: remove user's disc at column %d\n", user_last_move + 1);
+	print(session, REMOVE_COMPUTER_DISC_STRING, computer_last_move + 1);
+	print(session, REMOVE_USER_DISC_STRING, user_last_move + 1);
 
-	spFiarGamePrintBoard(game);
+	printBoard(session);
 
 	return true;
 }
 
 /*
 Called when user wants to undo his move after he won.
-@param game - the game
+@param session - the session
 @return
 false iff there's no history
 */
-static bool undoOnlyUserMove(SPFiarGame* game) {
+static bool undoOnlyUserMove(SP_GAME_SESSION* session) {
+	SPFiarGame* game = session->game;
 	SP_FIAR_GAME_MESSAGE msg;
 
 	int user_last_move = spArrayListGetLast(game->history);
@@ -68,54 +178,76 @@ static bool undoOnlyUserMove(SPFiarGame* game) {
 		return false;
 	}
 
-	printf("Remove disc: remove user's disc at column %d\n", user_last_move + 1);
+	print(session, REMOVE_USER_DISC_STRING, user_last_move + 1);
 
-	spFiarGamePrintBoard(game);
+	printBoard(session);
 
 	return true;
 }
 
 /*
 Called when the user adds a disc. Prints the relevant error message if an error occures.
-@param game - the game
+@param session - the session
 @param col - the column to put disc in
-@return 
+@return
 true iff disc successfully added to col
 */
-static bool userAddsDisc(SPFiarGame* game, int col) {
+static bool userAddsDisc(SP_GAME_SESSION* session, int col) {
+	SPFiarGame* game = session->game;
 
-	if (!(col >= 0 && col < SP_FIAR_GAME_N_COLUMNS)) {
-		error(ADD_DISC_NUM_ERR, NULL, 0);
+	if (!(col >= 0 && col < game->geometry->columns)) {
+		error(session, ADD_DISC_NUM_ERR, NULL, game->geometry->columns);
 		return false;
 	}
 
 	// column full
 	if (spFiarGameSetMove(game, col) == SP_FIAR_GAME_INVALID_MOVE) {
-		error(ADD_DISC_FULL_COLUMN_ERR, NULL, col + 1);
+		error(session, ADD_DISC_FULL_COLUMN_ERR, NULL, col + 1);
 		return false;
 	}
 
 	return true;
 }
 
+/*
+Searches the move of the computer, or the suggestion to the user.
+@param session - the session
+@param level - the level of the game
+@return
+the move or -1 if error occured
+*/
+static int searchMove(SP_GAME_SESSION* session, unsigned int level) {
+	SPMinimaxResult result;
+	int move;
+
+	if ((move = spMinimaxSuggestMoveWithConfig(session->game, level, &session->config, &result)) == -1) {
+		error(session, MEM_ERR, MALLOC, 0);
+		return move;
+	};
+
+	if (result.degraded)
+		print(session, DEGRADED_STRING);
+
+	return move;
+}
+
 /*
 Called when the Computer adds a disc. Prints the relevant error message if an error occures.
-@param game - the game
-@param col - the column to put disc in
+@param session - the session
+@param level - the level of the game
 @return
-true iff disc successfully added to col
+true iff disc successfully added
 */
-static bool addComputerDisc(SPFiarGame* game, unsigned int level) {
+static bool addComputerDisc(SP_GAME_SESSION* session, unsigned int level) {
 	int move;
 
-	if ((move = spMinimaxSuggestMove(game, level)) == -1) {
-		error(MEM_ERR, MALLOC, 0);
+	if ((move = searchMove(session, level)) == -1) {
 		return false;
-	};
+	}
 
-	spFiarGameSetMove(game, move);
+	spFiarGameSetMove(session->game, move);
 
-	printf("Computer move: add disc to column %d\n", move + 1);
+	print(session, COMPUTER_MOVE_STRING, move + 1);
 
 	return true;
 }
@@ -123,61 +255,126 @@ static bool addComputerDisc(SPFiarGame* game, unsigned int level) {
 
 /*
 Handles quit event.
-@param game - the game
+@param session - the session
 */
-static void quit(SPFiarGame* game) {
-	spFiarGameDestroy(game);
-	printf("Exiting...\n");
+static void quit(SP_GAME_SESSION* session) {
+	print(session, EXITING_STRING);
 }
 
 /*
 Handles restart event.
-@param game - the game
+@param session - the session
 */
-static void restart_game(SPFiarGame* game) {
-	spFiarGameDestroy(game);
-	printf("Game restarted!\n");
+static void restart_game(SP_GAME_SESSION* session) {
+	print(session, RESTARTED_STRING);
 }
 
 /*
 Called when user want a move suggestion.
-@param game - the game
+@param session - the session
 @param level - the level of the game
 @return
 the suggested move or -1 if error occured
 */
-static int suggestMoveToUser(SPFiarGame* game, unsigned int level) {
+static int suggestMoveToUser(SP_GAME_SESSION* session, unsigned int level) {
 	int move;
 
-	if ((move = spMinimaxSuggestMove(game, level)) == -1) {
-		error(MEM_ERR, MALLOC, 0);
+	if ((move = searchMove(session, level)) == -1) {
 		return move;
-	};
+	}
 
-	printf("Suggested move: drop a disc to column %d\n", move + 1);
+	print(session, SUGGESTED_MOVE_STRING, move + 1);
 
 	return move;
 }
 
+void init_session(SP_GAME_SESSION* session, FILE* input, FILE* output) {
+	memset(session, 0, sizeof(SP_GAME_SESSION));
+	session->input.file = input;
+	session->output.file = output;
+	session->prompts = true;
+	spMinimaxConfigInit(&session->config);
+	session->geometry = spFiarGeometryGet(SP_FIAR_GEOMETRY_DEFAULT);
+}
+
+void destroy_session(SP_GAME_SESSION* session) {
+	spFiarGameDestroy(session->game);
+	free(session->output.data);
+	session->game = NULL;
+	memset(&session->output, 0, sizeof(SP_GAME_OUTPUT));
+}
+
+bool parse_engine_option(const char* option, const char* value, SP_GAME_SESSION* session) {
+	SPMinimaxConfig* config = &session->config;
+
+	if (strcmp(option, MODE_OPTION) == 0) {
+		return spMinimaxParseMode(value, &config->mode);
+	}
+
+	if (strcmp(option, THREADS_OPTION) == 0 && spParserIsInt(value)) {
+		config->threads = atoi(value);
+		return config->threads >= 1 && config->threads <= SP_MCTS_MAX_THREADS;
+	}
+
+	if (strcmp(option, GEOMETRY_OPTION) == 0) {
+		return (void*)(session->geometry = spFiarGeometryFind(value)) != NULL;
+	}
+
+	if (strcmp(option, LEVELS_OPTION) == 0) {
+		return spMinimaxParseLevels(value, &config->levels);
+	}
+
+	if (strcmp(option, MEMORY_OPTION) == 0 && spParserIsInt(value) && atoi(value) > 0) {
+		// the limit is given in megabytes
+		config->memoryLimit = (unsigned long)atoi(value) << 20;
+		return true;
+	}
+
+	return false;
+}
+
+bool parse_engine_options(int argc, char* argv[], SP_GAME_SESSION* session) {
+	int i;
+	bool valid = true;
+
+	// every option is followed by its value
+	for (i = 1; i < argc && valid; i += 2) {
+		valid = i + 1 < argc && parse_engine_option(argv[i], argv[i + 1], session);
+	}
+
+	if (!valid) {
+		printf("Usage: %s [%s plain|pvs|mtdf|mcts] [%s <n>] [%s 7x6|8x7|9x7|connect5] [%s depth|nodes] [%s <MB>]\n",
+			argv[0], MODE_OPTION, THREADS_OPTION, GEOMETRY_OPTION, LEVELS_OPTION, MEMORY_OPTION);
+	}
+
+	return valid;
+}
 
-unsigned int init() {
-	char cmd[SP_MAX_LINE_LENGTH + 1], *token;
+unsigned int init(SP_GAME_SESSION* session) {
+	char cmd[SP_MAX_LINE_LENGTH + 1];
+	const char* line;
+	size_t length;
+	SPCommand cmd_parsed;
 	unsigned int level;
 
 	while (true) {
-		printf("Please enter the difficulty level between [1-7]:\n");
+		prompt(session, ENTER_LEVEL_STRING);
 
-		if (getCommandFromUserStripped(cmd) == NULL) {
-			error(CMD_INVALID_ERR, NULL, 0);
+		if (!nextLine(session, &line, &length, &cmd_parsed)) {
+			error(session, CMD_INVALID_ERR, NULL, 0);
 			return EXIT;
 		}
 
+		// the level is read from the line itself
+		length = length < SP_MAX_LINE_LENGTH ? length : SP_MAX_LINE_LENGTH;
+		memcpy(cmd, line, length);
+		cmd[length] = NULL_CHARACTER;
+
 		if (spParserIsInt(cmd)) {
-			token = strtok(cmd, SEP);
-			level = atoi(token);
+			level = atoi(cmd);
 
 			if (!(level >= MIN_LEVEL && level <= MAX_LEVEL)) {
-				error(INIT_ERR, NULL, 0);
+				error(session, INIT_ERR, NULL, 0);
 			}
 
 			else {
@@ -186,40 +383,37 @@ unsigned int init() {
 		}
 
 		else {
-			if (spParserPraseLine(cmd).cmd == SP_QUIT) {
-				quit(NULL);
+			if (cmd_parsed.cmd == SP_QUIT) {
+				quit(session);
 				return EXIT;
 			}
 
-			error(CMD_INVALID_ERR, NULL, 0);
+			error(session, CMD_INVALID_ERR, NULL, 0);
 		}
 	}
 }
 
 /*
 Called when the game has ended and handles it.
-@param game - the game
+@param session - the session
 @param winner - the winner
 @return
-QUIT_GAME if the user wants to finish the game, 
-RESTART if the user wants to restart, 
+QUIT_GAME if the user wants to finish the game,
+RESTART if the user wants to restart,
 CONTINUE_GAME_MOVE_UNDONE if the user undone it's previous move
 */
-static GAME_HAS_ENDED_MESSAGE gameHasEndedEvent(SPFiarGame* game, char winner) {
-	char cmd[SP_MAX_LINE_LENGTH + 1];
+static GAME_HAS_ENDED_MESSAGE gameHasEndedEvent(SP_GAME_SESSION* session, char winner) {
 	SPCommand cmd_parsed;
 
-	printf("Please enter 'quit' to exit or 'restart' to start a new game!\n");
+	prompt(session, GAME_ENDED_STRING);
 
 	do {
 
-		if (getCommandFromUserStripped(cmd) == NULL) {
-			error(CMD_INVALID_ERR, NULL, 0);
+		if (!nextCommand(session, &cmd_parsed)) {
+			error(session, CMD_INVALID_ERR, NULL, 0);
 			return QUIT_GAME;
 		}
 
-		cmd_parsed = spParserPraseLine(cmd);
-
 		switch (cmd_parsed.cmd)
 		{
 		case SP_QUIT:
@@ -228,15 +422,15 @@ static GAME_HAS_ENDED_MESSAGE gameHasEndedEvent(SPFiarGame* game, char winner) {
 			return RESTART;
 		case SP_UNDO_MOVE:
 			if (winner == SP_FIAR_GAME_PLAYER_1_SYMBOL) { // the user won
-				if (!undoOnlyUserMove(game)) {
-					error(UNDO_MOVE_ERR, NULL, 0);
+				if (!undoOnlyUserMove(session)) {
+					error(session, UNDO_MOVE_ERR, NULL, 0);
 					return QUIT_GAME;
 				}
 			}
 
 			else { // computer won or tie
-				if (!undoUserMove(game)) {
-					error(UNDO_MOVE_ERR, NULL, 0);
+				if (!undoUserMove(session)) {
+					error(session, UNDO_MOVE_ERR, NULL, 0);
 					return QUIT_GAME;
 				}
 			}
@@ -244,10 +438,10 @@ static GAME_HAS_ENDED_MESSAGE gameHasEndedEvent(SPFiarGame* game, char winner) {
 			return CONTINUE_GAME_MOVE_UNDONE;
 		case SP_ADD_DISC:
 		case SP_SUGGEST_MOVE:
-			error(GAME_OVER_ERR, NULL, 0);
+			error(session, GAME_OVER_ERR, NULL, 0);
 			break;
 		default:
-			error(CMD_INVALID_ERR, NULL, 0);
+			error(session, CMD_INVALID_ERR, NULL, 0);
 			break;
 		}
 
@@ -256,33 +450,34 @@ static GAME_HAS_ENDED_MESSAGE gameHasEndedEvent(SPFiarGame* game, char winner) {
 
 /*
 Prints the relevant message when the game has ended.
+@param session - the session
 @param winner - the winner symbol
 */
-static void printGameHasEndedMessage(char winner) {
+static void printGameHasEndedMessage(SP_GAME_SESSION* session, char winner) {
 	if (winner == SP_FIAR_GAME_PLAYER_1_SYMBOL) {
-		printf("Game over: you win\n");
+		print(session, USER_WINS_STRING);
 	}
 
 	else if (winner == SP_FIAR_GAME_PLAYER_2_SYMBOL) {
-		printf("Game over: computer wins\n");
+		print(session, COMPUTER_WINS_STRING);
 	}
 
 	// tie
 	else {
-		printf("Game over: it's a tie\n");
+		print(session, TIE_STRING);
 	}
 }
 
 /*
 Handles a parsed user commands.
+@param session - the session
 @param cmd_parsed - the parsed command
-@param game - the game
 @param level - the level
 @param winner - the winner status
 @return
 A struct contains the winner status and a message.
 */
-SP_WINNER_AND_MSG handleUserCommand(SPCommand cmd_parsed, SPFiarGame* game, unsigned int level, char winner) {
+SP_WINNER_AND_MSG handleUserCommand(SP_GAME_SESSION* session, SPCommand cmd_parsed, unsigned int level, char winner) {
 	SP_WINNER_AND_MSG ret_struct;
 
 	ret_struct.winner = winner;
@@ -291,27 +486,26 @@ SP_WINNER_AND_MSG handleUserCommand(SPCommand cmd_parsed, SPFiarGame* game, unsi
 	switch (cmd_parsed.cmd)
 	{
 	case SP_UNDO_MOVE:
-		if (!undoUserMove(game))
-			error(UNDO_MOVE_ERR, NULL, 0);
+		if (!undoUserMove(session))
+			error(session, UNDO_MOVE_ERR, NULL, 0);
 		else
-			printf(MAKE_NEXT_MOVE_STRING);
+			prompt(session, MAKE_NEXT_MOVE_STRING);
 		break;
 	case SP_QUIT:
-		quit(game);
+		quit(session);
 		ret_struct.msg = QUIT_GAME;
 		break;
 	case SP_RESTART:
-		restart_game(game);
+		restart_game(session);
 		ret_struct.msg = RESTART;
 		break;
 	case SP_ADD_DISC:
-		// error occured while adding disc 
-		if (!userAddsDisc(game, cmd_parsed.arg - 1))
+		// error occured while adding disc
+		if (!userAddsDisc(session, cmd_parsed.arg - 1))
 			break;
 
-		if ((ret_struct.winner = spFiarCheckWinner(game)) == NULL_CHARACTER) {
-			if (!addComputerDisc(game, level)) {
-				spFiarGameDestroy(game);
+		if ((ret_struct.winner = spFiarCheckWinner(session->game)) == NULL_CHARACTER) {
+			if (!addComputerDisc(session, level)) {
 				ret_struct.msg = QUIT_GAME;
 				break;
 			}
@@ -319,57 +513,60 @@ SP_WINNER_AND_MSG handleUserCommand(SPCommand cmd_parsed, SPFiarGame* game, unsi
 
 		// user didn't win, maybe computer won
 		if (ret_struct.winner == NO_WINNER)
-			ret_struct.winner = spFiarCheckWinner(game);
+			ret_struct.winner = spFiarCheckWinner(session->game);
 
-		spFiarGamePrintBoard(game);
+		printBoard(session);
 
 		// still no winner
 		if (ret_struct.winner == NO_WINNER)
-			printf(MAKE_NEXT_MOVE_STRING);
+			prompt(session, MAKE_NEXT_MOVE_STRING);
 		break;
 	case SP_SUGGEST_MOVE:
-		if (suggestMoveToUser(game, level) == -1) {
-			spFiarGameDestroy(game);
+		if (suggestMoveToUser(session, level) == -1) {
 			ret_struct.msg = QUIT_GAME;
 			break;
 		}
 		break;
 	default:
-		error(CMD_INVALID_ERR, NULL, 0);
+		error(session, CMD_INVALID_ERR, NULL, 0);
 		break;
 	}
 
 	return ret_struct;
 }
 
-GAME_HAS_ENDED_MESSAGE run_game(unsigned int level) {
-	SPFiarGame* game = spFiarGameCreate(HISTORY_SIZE);
-	char winner, cmd[SP_MAX_LINE_LENGTH + 1];
+GAME_HAS_ENDED_MESSAGE run_game(SP_GAME_SESSION* session, unsigned int level) {
+	char winner;
 	SPCommand cmd_parsed;
 	GAME_HAS_ENDED_MESSAGE msg;
 	SP_WINNER_AND_MSG win_msg_struct;
 
-	if ((void*)game == NULL) {
-		error(MEM_ERR, MALLOC, 0);
+	// the game of a session is reused by its next games
+	if ((void*)session->game == NULL) {
+		session->game = spFiarGameCreateWithGeometry(HISTORY_SIZE, session->geometry);
+	}
+	else {
+		spFiarGameReset(session->game, session->geometry);
+	}
+
+	if ((void*)session->game == NULL) {
+		error(session, MEM_ERR, MALLOC, 0);
 		return QUIT_GAME;
 	}
 
-	spFiarGamePrintBoard(game);
+	printBoard(session);
 
 	do {
 		winner = NO_WINNER;
-		printf(MAKE_NEXT_MOVE_STRING);
+		prompt(session, MAKE_NEXT_MOVE_STRING);
 
 		do {
-			if (getCommandFromUserStripped(cmd) == NULL) {
-				spFiarGameDestroy(game);
-				error(CMD_INVALID_ERR, NULL, 0);
+			if (!nextCommand(session, &cmd_parsed)) {
+				error(session, CMD_INVALID_ERR, NULL, 0);
 				return QUIT_GAME;
 			}
 
-			cmd_parsed = spParserPraseLine(cmd);
-
-			win_msg_struct = handleUserCommand(cmd_parsed, game, level, winner);
+			win_msg_struct = handleUserCommand(session, cmd_parsed, level, winner);
 
 			winner = win_msg_struct.winner;
 
@@ -378,44 +575,44 @@ GAME_HAS_ENDED_MESSAGE run_game(unsigned int level) {
 
 		} while (winner == NULL_CHARACTER);
 
-		printGameHasEndedMessage(winner);
-	
-	} while ((msg = gameHasEndedEvent(game, winner)) == CONTINUE_GAME_MOVE_UNDONE);
+		printGameHasEndedMessage(session, winner);
+
+	} while ((msg = gameHasEndedEvent(session, winner)) == CONTINUE_GAME_MOVE_UNDONE);
 
-	if (msg == RESTART) 
-		restart_game(game);
+	if (msg == RESTART)
+		restart_game(session);
 
-	else if (msg == QUIT_GAME) 
-		quit(game);
+	else if (msg == QUIT_GAME)
+		quit(session);
 
 	return msg;
 }
 
-void error(SP_ERROR_TYPE err, const char* bad_func_name, int col) {
+void error(SP_GAME_SESSION* session, SP_ERROR_TYPE err, const char* bad_func_name, int col) {
 	switch (err)
 	{
 	case MEM_ERR:
-		printf("Error: %s has failed", bad_func_name);
+		print(session, MEM_ERR_STRING, bad_func_name);
 		break;
 	case INIT_ERR:
-		printf("Error: invalid level (should be between 1 to 7)\n");
+		print(session, INIT_ERR_STRING);
 		break;
 	case CMD_INVALID_ERR:
-		printf("Error: invalid command\n");
+		print(session, CMD_INVALID_ERR_STRING);
 		break;
 	case ADD_DISC_NUM_ERR:
-		printf("Error: column number must be in range 1-7\n");
+		print(session, ADD_DISC_NUM_ERR_STRING, col);
 		break;
 	case ADD_DISC_FULL_COLUMN_ERR:
-		printf("Error: column %d is full\n", col);
+		print(session, ADD_DISC_FULL_COLUMN_ERR_STRING, col);
 		break;
 	case UNDO_MOVE_ERR:
-		printf("Error: cannot undo previous move!\n");
+		print(session, UNDO_MOVE_ERR_STRING);
 		break;
 	case GAME_OVER_ERR:
-		printf("Error: the game is over\n");
+		print(session, GAME_OVER_ERR_STRING);
 		break;
 	default:
 		break;
 	}
-}
\ No newline at end of file
+}
@@ -6,6 +6,7 @@
 #include <string.h>
 #include "SPFIARParser.h"
 #include "SPMinimax.h"
+#include "SPMcts.h"
 #include "SPFIARParserAdditionalHeaders.h"
 
 #define MIN_LEVEL 1
@@ -16,14 +17,49 @@
 #define MALLOC "malloc"
 #define HISTORY_SIZE 20
 #define MAKE_NEXT_MOVE_STRING "Please make the next move:\n"
+#define ENTER_LEVEL_STRING "Please enter the difficulty level between [1-7]:\n"
+#define GAME_ENDED_STRING "Please enter 'quit' to exit or 'restart' to start a new game!\n"
+#define COMPUTER_MOVE_STRING "Computer move: add disc to column %d\n"
+#define SUGGESTED_MOVE_STRING "Suggested move: drop a disc to column %d\n"
+#define REMOVE_COMPUTER_DISC_STRING "Remove disc: remove computer's disc at column %d\n"
+#define REMOVE_USER_DISC_STRING "Remove disc: remove user's disc at column %d\n"
+#define USER_WINS_STRING "Game over: you win\n"
+#define COMPUTER_WINS_STRING "Game over: computer wins\n"
+#define TIE_STRING "Game over: it's a tie\n"
+#define EXITING_STRING "Exiting...\n"
+#define RESTARTED_STRING "Game restarted!\n"
+#define MEM_ERR_STRING "Error: %s has failed"
+#define INIT_ERR_STRING "Error: invalid level (should be between 1 to 7)\n"
+#define CMD_INVALID_ERR_STRING "Error: invalid command\n"
+#define ADD_DISC_NUM_ERR_STRING "Error: column number must be in range 1-%d\n"
+#define ADD_DISC_FULL_COLUMN_ERR_STRING "Error: column %d is full\n"
+#define UNDO_MOVE_ERR_STRING "Error: cannot undo previous move!\n"
+#define GAME_OVER_ERR_STRING "Error: the game is over\n"
+#define MODE_OPTION "--mode"
+#define GEOMETRY_OPTION "--geometry"
+#define THREADS_OPTION "--threads"
+#define LEVELS_OPTION "--levels"
+#define MEMORY_OPTION "--memory"
+#define DEGRADED_STRING "Note: the search was reduced to fit its memory\n"
 
 /*
 SPMainAux summary:
 	This module contains all the relevant function for handling the game run.
 
+	The games of a session read their commands from an input source, the standard
+	input of the interactive game or a script in memory (see SPReplay.h), and print
+	their messages to an output sink, a file or a growing buffer. Every line is
+	parsed by spParserParseLines. A line of a file longer than SP_MAX_LINE_LENGTH
+	is read in parts of SP_MAX_LINE_LENGTH chars, each a command, while a line of a
+	script is cut.
+
+	init_session - Initializes a session with the default engine configuration.
+	destroy_session - Frees all memory resources associated with a session.
 	init - Handles the initialization of the game.
 	error - Handles errors which occure during the game. Prints the relevant message.
 	run_game - Runs the game with the desired level.
+	parse_engine_option - Sets an engine option of a session.
+	parse_engine_options - Sets the engine configuration from the command line.
 	
 */
 
@@ -54,30 +90,111 @@ typedef struct t_winner_and_message {
 	GAME_HAS_ENDED_MESSAGE msg;
 } SP_WINNER_AND_MSG;
 
+/*
+The input source of a session, a line at a time: the lines of a file, or those of
+a script in memory, each ended by '\n'.
+*/
+typedef struct t_game_input {
+	FILE* file;                          // the file of the lines, NULL for a script
+	char line[SP_MAX_LINE_LENGTH + 2];   // the last line read from the file, ended by '\n'
+	const char* data;                    // the lines left: the script, or the line read from the file
+	size_t size;
+} SP_GAME_INPUT;
+
+/*
+The output sink of a session: a file, or a buffer that grows as needed.
+*/
+typedef struct t_game_output {
+	FILE* file;                          // the file of the output, NULL to keep it in the buffer
+	char* data;
+	size_t size;
+	size_t capacity;
+	bool failed;                         // a memory allocation failure occurred, the buffer is cut
+	bool discard;                        // nothing is printed or kept
+} SP_GAME_OUTPUT;
+
+/*
+A session of games: their input and output, their engine and their board.
+*/
+typedef struct t_game_session {
+	SP_GAME_INPUT input;
+	SP_GAME_OUTPUT output;
+	bool prompts;                        // print the prompts and the boards, to the standard output
+	SPMinimaxConfig config;              // the engine of the computer moves and the suggestions
+	const SPFiarGeometry* geometry;      // the board of the games
+	SPFiarGame* game;                    // the current or last game, NULL before the first one
+} SP_GAME_SESSION;
+
 //put auxiliary functions and constants used by the main function here.
 
+/*
+Initializes a session with the default engine configuration and board, with prompts.
+@param session - the session
+@param input - the file of the commands, NULL for a script: session->input.data and
+               session->input.size are then to be set to its lines
+@param output - the file of the output, NULL to keep it in session->output
+*/
+void init_session(SP_GAME_SESSION* session, FILE* input, FILE* output);
+
+/*
+Frees all memory resources associated with a session: its game and its output buffer.
+The files of the session are not closed.
+@param session - the session
+*/
+void destroy_session(SP_GAME_SESSION* session);
+
 /* 
 Handles the initialization of the game.
+@param session - the session
 @return
-the game level.
+the game level, EXIT if the user quits or the input ends.
 */
-unsigned int init();
+unsigned int init(SP_GAME_SESSION* session);
 
 /*
 Handles errors which occure during the game. Prints the relevant message.
+@param session - the session
 @param err - the error type
 @param bad_fund_name - optional, the name of the system function that caused error
-@param col - optional, the index of the column that is full while trying to add disc to
+@param col - optional, the index of the column that is full while trying to add disc to,
+              or the number of columns for ADD_DISC_NUM_ERR
 */
-void error(SP_ERROR_TYPE err, const char* bad_func_name, int col);
+void error(SP_GAME_SESSION* session, SP_ERROR_TYPE err, const char* bad_func_name, int col);
 
 /*
-Runs the game with the desired level.
+Runs the game with the desired level. The game is session->game, kept when the
+function returns.
+@param session - the session
 @param level - the game level
 @return
-QUIT_GAME - if the user wants to quit
+QUIT_GAME - if the user wants to quit, the input ends or an error occured
 RESTART - if the user wants to restart the game
 */
-GAME_HAS_ENDED_MESSAGE run_game(unsigned int level);
+GAME_HAS_ENDED_MESSAGE run_game(SP_GAME_SESSION* session, unsigned int level);
+
+/*
+Sets an engine option of a session. The options are "--mode <plain|pvs|mtdf|mcts>",
+the search algorithm of the computer, "--threads <n>", the threads of the mcts mode,
+"--geometry <7x6|8x7|9x7|connect5>", the board of the games (see SPFIARGeometry.h),
+"--levels <depth|nodes>", the meaning of the levels, and "--memory <MB>", the memory
+limit of a search (see SPMinimax.h).
+@param option - the option
+@param value - the value of the option
+@param session - the session
+@return
+true iff the option is one of them and its value is valid
+*/
+bool parse_engine_option(const char* option, const char* value, SP_GAME_SESSION* session);
+
+/*
+Sets the engine configuration of a session from the command line arguments, the
+options of parse_engine_option. Prints the usage if the arguments are invalid.
+@param argc - the number of arguments
+@param argv - the arguments, argv[0] is the program name
+@param session - the session
+@return
+true iff the arguments are valid
+*/
+bool parse_engine_options(int argc, char* argv[], SP_GAME_SESSION* session);
 
 #endif
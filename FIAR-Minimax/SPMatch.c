@@ -0,0 +1,192 @@
+#define _POSIX_C_SOURCE 200112L
+#include "SPMatch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SPMinimax.h"
+#include "SPMcts.h"
+#include "SPFIARParser.h"
+#include "SPFIARCodec.h"
+
+#define MATCH_HISTORY_SIZE SP_FIAR_CODEC_MAX_MOVES
+#define MATCH_SEED 0x2545F4914F6CDD1DULL
+#define MATCH_MAX_MODE_NAME 16
+
+/*
+* An engine of the match and its results.
+*/
+typedef struct sp_match_engine_t {
+	const char* name;
+	SPMinimaxConfig config;
+	unsigned int level;
+	int wins;
+	int draws;
+	int losses;
+	unsigned long moves;
+	double ms;
+} SPMatchEngine;
+
+/*
+* Parses an engine, "<mode>:<level>".
+* @param str the engine
+* @param engine set to the engine on success
+* @return true iff str is a valid engine
+*/
+static bool parseEngine(const char* str, SPMatchEngine* engine) {
+	char mode[MATCH_MAX_MODE_NAME];
+	const char* separator = strchr(str, ':');
+
+	if (separator == NULL || separator - str >= MATCH_MAX_MODE_NAME || !spParserIsInt(separator + 1)) {
+		return false;
+	}
+
+	memcpy(mode, str, separator - str);
+	mode[separator - str] = '\0';
+	spMinimaxConfigInit(&engine->config);
+	engine->name = str;
+	engine->level = (unsigned int)atoi(separator + 1);
+	engine->wins = engine->draws = engine->losses = 0;
+	engine->moves = 0;
+	engine->ms = 0;
+
+	return spMinimaxParseMode(mode, &engine->config.mode) && engine->level >= 1 && engine->level <= MATCH_MAX_LEVEL;
+}
+
+/*
+* Builds the random opening of a pair of games, a string of 1-based columns.
+* @param pair the index of the pair
+* @param geometry the geometry of the games
+* @param opening the opening, of MATCH_OPENING_MOVES + 1 characters at least
+*/
+static void makeOpening(int pair, const SPFiarGeometry* geometry, char* opening) {
+	unsigned long long random = MATCH_SEED ^ ((unsigned long long)(pair + 1) * 0x9E3779B97F4A7C15ULL);
+	int i;
+
+	for (i = 0; i < MATCH_OPENING_MOVES; i++) {
+		random ^= random >> 12;
+		random ^= random << 25;
+		random ^= random >> 27;
+		opening[i] = (char)('1' + (random * 2685821657736338717ULL >> 33) % geometry->columns);
+	}
+
+	opening[MATCH_OPENING_MOVES] = '\0';
+}
+
+/*
+* Plays a game between two engines from an opening and counts its result.
+* @param engines the engines, engines[0] moves first after the opening
+* @param opening the opening
+* @param geometry the geometry of the game
+* @return the winner (0 or 1), 2 for a tie, -1 on failure
+*/
+static int playGame(SPMatchEngine* engines[2], const char* opening, const SPFiarGeometry* geometry) {
+	struct timespec start, end;
+	SPFiarGame* game;
+	char winner;
+	int turn = 0, move;
+
+	if ((game = spFiarCodecDecodeMoves(opening, geometry, MATCH_HISTORY_SIZE)) == NULL) {
+		return -1;
+	}
+
+	// the engines alternate whatever the length of the opening
+	while ((winner = spFiarCheckWinner(game)) == '\0') {
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		move = spMinimaxSuggestMoveWithConfig(game, engines[turn]->level, &engines[turn]->config, NULL);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		if (move == -1 || spFiarGameSetMove(game, move) != SP_FIAR_GAME_SUCCESS) {
+			spFiarGameDestroy(game);
+			return -1;
+		}
+
+		engines[turn]->ms += (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1000000.0;
+		engines[turn]->moves++;
+		turn ^= 1;
+	}
+
+	spFiarGameDestroy(game);
+
+	if (winner == SP_FIAR_GAME_TIE_SYMBOL) {
+		engines[0]->draws++;
+		engines[1]->draws++;
+		return 2;
+	}
+
+	// the last move won the game
+	engines[turn ^ 1]->wins++;
+	engines[turn]->losses++;
+
+	return turn ^ 1;
+}
+
+int spMatchMain(int argc, char* argv[]) {
+	const SPFiarGeometry* geometry = spFiarGeometryGet(SP_FIAR_GEOMETRY_DEFAULT);
+	SPMatchEngine engines[2], *players[2];
+	char opening[MATCH_OPENING_MOVES + 1];
+	SP_MINIMAX_LEVELS levels = SP_MINIMAX_LEVELS_DEPTH;
+	int games = MATCH_DEFAULT_GAMES, threads = 1, game, winner, i;
+	double points;
+	bool valid = argc >= 3 && parseEngine(argv[1], &engines[0]) && parseEngine(argv[2], &engines[1]);
+
+	// every option is followed by its value
+	for (i = 3; i < argc && valid; i += 2) {
+		if (i + 1 == argc) {
+			valid = false;
+		}
+		else if (strcmp(argv[i], MATCH_GAMES_OPTION) == 0 && spParserIsInt(argv[i + 1])) {
+			valid = (games = atoi(argv[i + 1])) > 0;
+		}
+		else if (strcmp(argv[i], MATCH_THREADS_OPTION) == 0 && spParserIsInt(argv[i + 1])) {
+			threads = atoi(argv[i + 1]);
+			valid = threads >= 1 && threads <= SP_MCTS_MAX_THREADS;
+		}
+		else if (strcmp(argv[i], MATCH_GEOMETRY_OPTION) == 0) {
+			valid = (geometry = spFiarGeometryFind(argv[i + 1])) != NULL;
+		}
+		else if (strcmp(argv[i], MATCH_LEVELS_OPTION) == 0) {
+			valid = spMinimaxParseLevels(argv[i + 1], &levels);
+		}
+		else {
+			valid = false;
+		}
+	}
+
+	if (!valid) {
+		printf("Usage: %s <mode>:<level> <mode>:<level> [%s <n>] [%s <n>] [%s 7x6|8x7|9x7|connect5] [%s depth|nodes]\n",
+			argv[0], MATCH_GAMES_OPTION, MATCH_THREADS_OPTION, MATCH_GEOMETRY_OPTION, MATCH_LEVELS_OPTION);
+		printf("The modes are plain, pvs, mtdf and mcts, the levels 1-%d.\n", MATCH_MAX_LEVEL);
+		return 1;
+	}
+
+	engines[0].config.threads = engines[1].config.threads = threads;
+	engines[0].config.levels = engines[1].config.levels = levels;
+	games += games % 2;
+	printf("geometry %s\n", geometry->name);
+
+	for (game = 0; game < games; game++) {
+		makeOpening(game / 2, geometry, opening);
+		players[0] = &engines[game % 2];
+		players[1] = &engines[1 - game % 2];
+
+		if ((winner = playGame(players, opening, geometry)) == -1) {
+			printf("Error: game %d failed\n", game + 1);
+			return 1;
+		}
+
+		printf("game %d opening %s first %s result %s\n", game + 1, opening, players[0]->name,
+			winner == 2 ? "draw" : players[winner]->name);
+	}
+
+	printf("\n%-16s %6s %6s %6s %8s %12s %12s\n", "engine", "wins", "draws", "losses", "points", "ms/move", "points/s");
+
+	for (i = 0; i < 2; i++) {
+		points = engines[i].wins + engines[i].draws / 2.0;
+		printf("%-16s %6d %6d %6d %8.1f %12.3f %12.3f\n", engines[i].name, engines[i].wins, engines[i].draws,
+			engines[i].losses, points, engines[i].moves > 0 ? engines[i].ms / engines[i].moves : 0.0,
+			engines[i].ms > 0 ? points * 1000.0 / engines[i].ms : 0.0);
+	}
+
+	return 0;
+}
@@ -0,0 +1,42 @@
+#ifndef SPMATCH_H_
+#define SPMATCH_H_
+
+#define MATCH_COMMAND "match"
+#define MATCH_GAMES_OPTION "--games"
+#define MATCH_THREADS_OPTION "--threads"
+#define MATCH_GEOMETRY_OPTION "--geometry"
+#define MATCH_LEVELS_OPTION "--levels"
+#define MATCH_DEFAULT_GAMES 20
+#define MATCH_MAX_LEVEL 12
+// the random moves of an opening
+#define MATCH_OPENING_MOVES 2
+
+/**
+ * SPMatch Summary:
+ *
+ * A match between two engines, each a search mode and a level, to compare their
+ * strength and speed. The games start from random openings of a few moves and
+ * every opening is played twice, each engine starting once, so neither engine
+ * gets the better openings. The openings are the same in every run.
+ *
+ * A line is printed per game, then the result of every engine: its wins, draws,
+ * losses, points (a win is 1, a draw 1/2) and the milliseconds of wall clock time
+ * it took per move, and its points per second of search.
+ *
+ * spMatchMain  - Plays the match
+ */
+
+/**
+ * Plays the match. Usage: match <mode>:<level> <mode>:<level> [--games <n>]
+ * [--threads <n>] [--geometry <7x6|8x7|9x7|connect5>] [--levels <depth|nodes>]
+ * The games are rounded up to an even number, the threads are those of the Monte
+ * Carlo tree search. The levels are depths or node budgets (see SP_MINIMAX_LEVELS).
+ *
+ * @param argc - the number of arguments, including the command name
+ * @param argv - the arguments, argv[0] is the command name
+ * @return
+ * 0 on success, 1 if the arguments are invalid or a search failed
+ */
+int spMatchMain(int argc, char* argv[]);
+
+#endif
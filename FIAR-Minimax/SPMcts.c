@@ -0,0 +1,418 @@
+#include "SPMcts.h"
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include "SPTrace.h"
+
+#define EXPLORATION 1.4
+#define SEED 0x9E3779B97F4A7C15ULL
+#define SEED_STEP 0xD1B54A32D192ED03ULL
+#define NOT_EXPANDED -1
+#define EXPANDING -2
+#define DRAW -1
+#define N_DIRECTIONS 4
+#define MAX_PATH (SP_FIAR_GAME_MAX_ROWS * SP_FIAR_GAME_MAX_COLUMNS + 1)
+
+// the counters of the tree are shared by the threads of a search
+#define ATOMIC_LOAD(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define ATOMIC_ADD(p, v) __atomic_fetch_add(p, v, __ATOMIC_RELAXED)
+
+/*
+* A node of the tree, the position after its move.
+*/
+typedef struct sp_mcts_node_t {
+	int visits;
+	int points;                   // 2 per win and 1 per draw of the player who made the move
+	int virtual_loss;             // the threads walking through the node
+	int first_child;              // NOT_EXPANDED, EXPANDING or the index of the first child
+	signed char move;
+	unsigned char n_children;
+} SPMctsNode;
+
+/*
+* A position on bitboards: the bit of the cell (row, col) is col * rows + row.
+*/
+typedef struct sp_mcts_board_t {
+	unsigned long long discs[2];  // the discs of the player to move at the root [0] and the other [1]
+	int heights[SP_FIAR_GAME_MAX_COLUMNS];
+	int turn;                     // the player to move
+	int moves;
+} SPMctsBoard;
+
+/*
+* A search, shared by its threads.
+*/
+typedef struct sp_mcts_t {
+	const SPFiarGeometry* geometry;
+	SPMctsBoard root;
+	unsigned long long start_masks[N_DIRECTIONS]; // the cells whose span in the direction is on the board
+	int shifts[N_DIRECTIONS];                     // the bit distance of the next cell in the direction
+	int order[SP_FIAR_GAME_MAX_COLUMNS];          // the columns from the middle outwards
+	SPMctsNode* nodes;
+	int capacity;
+	int used;
+	long remaining;                               // the playouts left
+} SPMcts;
+
+/*
+* A thread of a search.
+*/
+typedef struct sp_mcts_thread_t {
+	SPMcts* mcts;
+	unsigned long long random;    // the state of the random generator
+	pthread_t thread;
+} SPMctsThread;
+
+/*
+* Returns the next random number of a thread, by xorshift64*.
+* @param t the thread
+* @return the number
+*/
+static unsigned long long nextRandom(SPMctsThread* t) {
+	t->random ^= t->random >> 12;
+	t->random ^= t->random << 25;
+	t->random ^= t->random >> 27;
+
+	return t->random * 2685821657736338717ULL;
+}
+
+/*
+* Checks if discs have span cells in a row, column or diagonal.
+* @param m the search
+* @param discs the discs
+* @return true iff there is such a span
+*/
+static bool hasSpan(SPMcts* m, unsigned long long discs) {
+	unsigned long long cells;
+	int d, k;
+
+	for (d = 0; d < N_DIRECTIONS; d++) {
+		cells = discs & m->start_masks[d];
+
+		for (k = 1; k < m->geometry->span && cells != 0; k++) {
+			cells &= discs >> (k * m->shifts[d]);
+		}
+
+		if (cells != 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+* Drops a disc of the player to move in a column, which must not be full.
+* @param m the search
+* @param board the board
+* @param col the column
+*/
+static void playMove(SPMcts* m, SPMctsBoard* board, int col) {
+	board->discs[board->turn] |= 1ULL << (col * m->geometry->rows + board->heights[col]);
+	board->heights[col]++;
+	board->moves++;
+	board->turn ^= 1;
+}
+
+/*
+* Plays random moves to the end of the game.
+* @param m the search
+* @param t the thread
+* @param board the board to play on
+* @return the winner, DRAW for a tie
+*/
+static int playout(SPMcts* m, SPMctsThread* t, SPMctsBoard* board) {
+	int legal[SP_FIAR_GAME_MAX_COLUMNS], n_legal, col, cells = m->geometry->rows * m->geometry->columns;
+
+	while (board->moves < cells) {
+		for (col = 0, n_legal = 0; col < m->geometry->columns; col++) {
+			if (board->heights[col] < m->geometry->rows) {
+				legal[n_legal++] = col;
+			}
+		}
+
+		playMove(m, board, legal[nextRandom(t) % n_legal]);
+
+		if (hasSpan(m, board->discs[board->turn ^ 1])) {
+			return board->turn ^ 1;
+		}
+	}
+
+	return DRAW;
+}
+
+/*
+* Adds the children of a leaf, unless another thread does or the pool is full.
+* @param m the search
+* @param leaf the index of the leaf
+* @param board the position of the leaf
+*/
+static void expand(SPMcts* m, int leaf, SPMctsBoard* board) {
+	SPMctsNode* node = &m->nodes[leaf];
+	int expected = NOT_EXPANDED, first, n = 0, i;
+
+	if (!__atomic_compare_exchange_n(&node->first_child, &expected, EXPANDING, false,
+		__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+		return;
+	}
+
+	for (i = 0; i < m->geometry->columns; i++) {
+		n += board->heights[m->order[i]] < m->geometry->rows;
+	}
+
+	first = ATOMIC_ADD(&m->used, n);
+
+	if (first > m->capacity - n) {
+		ATOMIC_STORE(&node->first_child, NOT_EXPANDED);
+		return;
+	}
+
+	for (i = 0, n = 0; i < m->geometry->columns; i++) {
+		if (board->heights[m->order[i]] < m->geometry->rows) {
+			m->nodes[first + n].visits = 0;
+			m->nodes[first + n].points = 0;
+			m->nodes[first + n].virtual_loss = 0;
+			m->nodes[first + n].first_child = NOT_EXPANDED;
+			m->nodes[first + n].move = (signed char)m->order[i];
+			m->nodes[first + n].n_children = 0;
+			n++;
+		}
+	}
+
+	node->n_children = (unsigned char)n;
+
+	// publishes the children to the other threads
+	ATOMIC_STORE(&node->first_child, first);
+}
+
+/*
+* Selects the child of a node with the best UCB1 bound, an unvisited child first.
+* @param m the search
+* @param parent the node
+* @param first the index of its first child
+* @return the index of the child
+*/
+static int selectChild(SPMcts* m, SPMctsNode* parent, int first) {
+	SPMctsNode* child;
+	double log_visits, value, best_value = -1;
+	int i, n, best = first;
+
+	n = ATOMIC_LOAD(&parent->visits) + ATOMIC_LOAD(&parent->virtual_loss);
+	log_visits = log(n > 1 ? n : 1);
+
+	for (i = 0; i < parent->n_children; i++) {
+		child = &m->nodes[first + i];
+
+		// a virtual loss counts as a visit without points
+		n = ATOMIC_LOAD(&child->visits) + ATOMIC_LOAD(&child->virtual_loss);
+
+		if (n == 0) {
+			return first + i;
+		}
+
+		value = ATOMIC_LOAD(&child->points) / (2.0 * n) + EXPLORATION * sqrt(log_visits / n);
+
+		if (value > best_value) {
+			best_value = value;
+			best = first + i;
+		}
+	}
+
+	return best;
+}
+
+/*
+* Runs an iteration: selection, expansion, playout and backpropagation.
+* @param m the search
+* @param t the thread
+*/
+static void iterate(SPMcts* m, SPMctsThread* t) {
+	SPMctsBoard board = m->root;
+	int path[MAX_PATH], depth = 0, node = 0, first, winner = DRAW, mover, i;
+	bool ended = false;
+
+	path[0] = 0;
+	ATOMIC_ADD(&m->nodes[0].virtual_loss, 1);
+
+	while ((first = ATOMIC_LOAD(&m->nodes[node].first_child)) >= 0) {
+		node = selectChild(m, &m->nodes[node], first);
+		path[++depth] = node;
+		ATOMIC_ADD(&m->nodes[node].virtual_loss, 1);
+		playMove(m, &board, m->nodes[node].move);
+
+		if (hasSpan(m, board.discs[board.turn ^ 1])) {
+			winner = board.turn ^ 1;
+			ended = true;
+			break;
+		}
+
+		if (board.moves == m->geometry->rows * m->geometry->columns) {
+			ended = true;
+			break;
+		}
+	}
+
+	if (!ended) {
+		// a leaf is expanded on its second visit, most leaves are visited once
+		if (node == 0 || ATOMIC_LOAD(&m->nodes[node].visits) > 0) {
+			expand(m, node, &board);
+		}
+
+		winner = playout(m, t, &board);
+	}
+
+	for (i = depth; i >= 0; i--) {
+		// the root player made the moves of the odd depths
+		mover = i % 2 == 1 ? 0 : 1;
+		ATOMIC_ADD(&m->nodes[path[i]].points, winner == DRAW ? 1 : (winner == mover ? 2 : 0));
+		ATOMIC_ADD(&m->nodes[path[i]].visits, 1);
+		ATOMIC_ADD(&m->nodes[path[i]].virtual_loss, -1);
+	}
+}
+
+/*
+* Runs iterations until the playouts of the search are done. The thread routine.
+* @param arg the thread
+* @return NULL
+*/
+static void* runThread(void* arg) {
+	SPMctsThread* t = (SPMctsThread*)arg;
+	int iterations = 0;
+
+	SP_TRACE_BEGIN(mcts_thread);
+
+	while (__atomic_fetch_sub(&t->mcts->remaining, 1, __ATOMIC_RELAXED) > 0) {
+		iterate(t->mcts, t);
+		iterations++;
+	}
+
+	SP_TRACE_END(mcts_thread, iterations);
+
+	return NULL;
+}
+
+/*
+* Prepares a search of a game.
+* @param m the search to prepare
+* @param game the game
+*/
+static void initSearch(SPMcts* m, SPFiarGame* game) {
+	const SPFiarGeometry* geometry = game->geometry;
+	int directions[N_DIRECTIONS][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { -1, 1 } }; // (row, column) steps
+	int d, row, col, end_row, end_col;
+
+	m->geometry = geometry;
+	m->root.turn = 0;
+	m->root.moves = 0;
+	m->root.discs[0] = 0;
+	m->root.discs[1] = 0;
+
+	for (col = 0; col < geometry->columns; col++) {
+		m->root.heights[col] = (game->tops)[col];
+		m->root.moves += (game->tops)[col];
+
+		for (row = 0; row < (game->tops)[col]; row++) {
+			m->root.discs[(game->gameBoard)[row][col] == spFiarGameGetCurrentPlayer(game) ? 0 : 1] |=
+				1ULL << (col * geometry->rows + row);
+		}
+	}
+
+	for (d = 0; d < N_DIRECTIONS; d++) {
+		m->shifts[d] = directions[d][1] * geometry->rows + directions[d][0];
+		m->start_masks[d] = 0;
+
+		for (col = 0; col < geometry->columns; col++) {
+			for (row = 0; row < geometry->rows; row++) {
+				end_row = row + directions[d][0] * (geometry->span - 1);
+				end_col = col + directions[d][1] * (geometry->span - 1);
+
+				if (end_row >= 0 && end_row < geometry->rows && end_col < geometry->columns) {
+					m->start_masks[d] |= 1ULL << (col * geometry->rows + row);
+				}
+			}
+		}
+	}
+
+	for (col = 0; col < geometry->columns; col++) {
+		m->order[col] = col % 2 == 0 ? (geometry->columns - 1) / 2 - col / 2 : (geometry->columns - 1) / 2 + (col + 1) / 2;
+	}
+}
+
+unsigned long spMctsMaxPlayouts(const SPFiarGeometry* geometry, unsigned long memory) {
+	unsigned long nodes = memory / sizeof(SPMctsNode);
+
+	if ((void*)geometry == NULL || nodes < 1) {
+		return 0;
+	}
+
+	// the root and the children of every playout
+	return (nodes - 1) / geometry->columns;
+}
+
+int spMctsSearch(SPFiarGame* game, unsigned long playouts, int threads, SPMinimaxResult* result) {
+	SPMctsThread workers[SP_MCTS_MAX_THREADS];
+	SPMctsNode* child;
+	SPMcts m;
+	int i, started, best = -1;
+
+	if ((void*)game == NULL || spFiarCheckWinner(game) != '\0' || playouts == 0 ||
+		playouts > (unsigned long)(INT_MAX / SP_FIAR_GAME_MAX_COLUMNS) - 1 || threads < 1 || threads > SP_MCTS_MAX_THREADS) {
+		return -1;
+	}
+
+	initSearch(&m, game);
+
+	// an iteration adds the children of a node at most
+	m.capacity = 1 + (int)playouts * game->geometry->columns;
+	m.used = 1;
+	m.remaining = (long)playouts;
+
+	if ((m.nodes = (SPMctsNode*)malloc(m.capacity * sizeof(SPMctsNode))) == NULL) {
+		return -1;
+	}
+
+	m.nodes[0].visits = 0;
+	m.nodes[0].points = 0;
+	m.nodes[0].virtual_loss = 0;
+	m.nodes[0].first_child = NOT_EXPANDED;
+	m.nodes[0].move = -1;
+	m.nodes[0].n_children = 0;
+
+	for (i = 0; i < threads; i++) {
+		workers[i].mcts = &m;
+		workers[i].random = SEED ^ (SEED_STEP * (i + 1));
+	}
+
+	// the calling thread is the first one, a thread that can't be started is left out
+	for (started = 1; started < threads && pthread_create(&workers[started].thread, NULL, runThread, &workers[started]) == 0;
+		started++);
+
+	runThread(&workers[0]);
+
+	for (i = 1; i < started; i++) {
+		pthread_join(workers[i].thread, NULL);
+	}
+
+	for (i = 0; m.nodes[0].first_child >= 0 && i < m.nodes[0].n_children; i++) {
+		child = &m.nodes[m.nodes[0].first_child + i];
+
+		if (best == -1 || child->visits > m.nodes[best].visits) {
+			best = m.nodes[0].first_child + i;
+		}
+	}
+
+	if (best != -1 && result != NULL) {
+		result->move = m.nodes[best].move;
+		result->score = m.nodes[best].visits > 0 ?
+			(int)floor(1000.0 * ((double)m.nodes[best].points / m.nodes[best].visits - 1.0) + 0.5) : 0;
+		result->nodes = playouts;
+		result->degraded = false;
+	}
+
+	i = best != -1 ? m.nodes[best].move : -1;
+	free(m.nodes);
+
+	return i;
+}
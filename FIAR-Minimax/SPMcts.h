@@ -0,0 +1,58 @@
+#ifndef SPMCTS_H_
+#define SPMCTS_H_
+
+#include "SPFIARGame.h"
+#include "SPMinimaxSearch.h"
+
+// the playouts of a search of level 1, every level doubles them
+#define SP_MCTS_PLAYOUTS_PER_LEVEL 1000
+#define SP_MCTS_MAX_THREADS 64
+
+/**
+ * SPMcts Summary:
+ *
+ * A Monte Carlo tree search (UCT) of a game, an alternative to the minimax
+ * searches. Every iteration walks down the tree by the UCB1 bound, adds the
+ * children of the leaf it reaches and scores the leaf by a random playout to the
+ * end of the game. The move of the root that was visited most is the best move.
+ *
+ * The playouts run on bitboards of the game, a 64 bit mask per player with a bit
+ * per cell (rows * columns <= 64 on every geometry), without any allocation. The
+ * nodes of the tree are taken from a pool allocated once per search. The threads
+ * of a parallel search share the tree: its counters are updated atomically and a
+ * thread walking down a node adds a virtual loss to it, so the other threads
+ * prefer other nodes until its playout is counted.
+ *
+ * A search of a single thread is deterministic.
+ *
+ * spMctsSearch       - Searches a game
+ * spMctsMaxPlayouts  - Returns the most playouts a memory size allows
+ */
+
+/**
+ * Searches a game with a budget of playouts. The game is not changed.
+ *
+ * @param game - the game, which must not have ended
+ * @param playouts - the number of playouts, at least 1
+ * @param threads - the number of threads, at most SP_MCTS_MAX_THREADS
+ * @param result - if not NULL, set to the best move, its score and the number of
+ *                 playouts. The score is the mean result of the move for the player
+ *                 to move, from -1000 (always lost) to 1000 (always won).
+ * @return
+ * -1 if game is NULL or has ended, playouts or threads is out of range or a memory
+ * allocation failure occurred. Otherwise the best move, 0-based.
+ */
+int spMctsSearch(SPFiarGame* game, unsigned long playouts, int threads, SPMinimaxResult* result);
+
+/**
+ * Returns the most playouts of a search whose node pool fits a memory size. The
+ * pool has room for the children of every playout.
+ *
+ * @param geometry - the geometry of the searched games
+ * @param memory - the memory size in bytes
+ * @return
+ * the number of playouts, 0 if not even one fits or geometry is NULL
+ */
+unsigned long spMctsMaxPlayouts(const SPFiarGeometry* geometry, unsigned long memory);
+
+#endif
@@ -1,48 +1,554 @@
 #include "SPMinimax.h"
 #include <string.h>
 #include "SPMinimaxNode.h"
+#include "SPMinimaxTree.h"
+#include "SPMcts.h"
+#include "SPTrace.h"
+
+#define PLAIN_MODE_NAME "plain"
+#define PVS_MODE_NAME "pvs"
+#define MTDF_MODE_NAME "mtdf"
+#define MCTS_MODE_NAME "mcts"
+#define DEPTH_LEVELS_NAME "depth"
+#define NODES_LEVELS_NAME "nodes"
+// the deepest level whose playouts are derived by doubling
+#define MCTS_MAX_DOUBLINGS 10
+// the most playouts derived from a level, depth or node level alike
+#define MCTS_MAX_LEVEL_PLAYOUTS ((unsigned long)SP_MCTS_PLAYOUTS_PER_LEVEL << MCTS_MAX_DOUBLINGS)
+// the depth of the minimax search that replaces a tree search out of memory
+#define MCTS_FALLBACK_DEPTH 4
+// the memory of a node of the plain tree, whose pool may be twice its size
+#define PLAIN_NODE_BYTES (2 * SP_MINIMAX_TREE_NODE_BYTES)
+// a search visits less than 8^depth positions, its table needn't have more entries
+#define TABLE_BITS_PER_PLY 3
 
 int spMinimaxSuggestMove(SPFiarGame* currentGame, unsigned int maxDepth) {
+	return spMinimaxSuggestMoveWithConfig(currentGame, maxDepth, NULL, NULL);
+}
+
+void spMinimaxConfigInit(SPMinimaxConfig* config) {
+	if (config == NULL)
+		return;
+
+	config->mode = SP_MINIMAX_MODE_PLAIN;
+	config->tableSize = SP_MINIMAX_DEFAULT_TABLE_SIZE;
+	config->playouts = 0;
+	config->threads = 0;
+	config->levels = SP_MINIMAX_LEVELS_DEPTH;
+	config->memoryLimit = 0;
+}
+
+bool spMinimaxParseMode(const char* str, SP_MINIMAX_MODE* mode) {
+	if (str == NULL || mode == NULL)
+		return false;
+
+	if (strcmp(str, PLAIN_MODE_NAME) == 0)
+		*mode = SP_MINIMAX_MODE_PLAIN;
+	else if (strcmp(str, PVS_MODE_NAME) == 0)
+		*mode = SP_MINIMAX_MODE_PVS;
+	else if (strcmp(str, MTDF_MODE_NAME) == 0)
+		*mode = SP_MINIMAX_MODE_MTDF;
+	else if (strcmp(str, MCTS_MODE_NAME) == 0)
+		*mode = SP_MINIMAX_MODE_MCTS;
+	else
+		return false;
+
+	return true;
+}
+
+const char* spMinimaxModeName(SP_MINIMAX_MODE mode) {
+	switch (mode) {
+	case SP_MINIMAX_MODE_PVS:
+		return PVS_MODE_NAME;
+	case SP_MINIMAX_MODE_MTDF:
+		return MTDF_MODE_NAME;
+	case SP_MINIMAX_MODE_MCTS:
+		return MCTS_MODE_NAME;
+	default:
+		return PLAIN_MODE_NAME;
+	}
+}
+
+bool spMinimaxParseLevels(const char* str, SP_MINIMAX_LEVELS* levels) {
+	if (str == NULL || levels == NULL)
+		return false;
+
+	if (strcmp(str, DEPTH_LEVELS_NAME) == 0)
+		*levels = SP_MINIMAX_LEVELS_DEPTH;
+	else if (strcmp(str, NODES_LEVELS_NAME) == 0)
+		*levels = SP_MINIMAX_LEVELS_NODES;
+	else
+		return false;
+
+	return true;
+}
+
+unsigned long spMinimaxLevelBudget(unsigned int level) {
+	if (level < 1)
+		level = 1;
+	else if (level > SP_MINIMAX_MAX_NODE_LEVEL)
+		level = SP_MINIMAX_MAX_NODE_LEVEL;
+
+	return SP_MINIMAX_LEVEL_NODES << (SP_MINIMAX_LEVEL_NODES_SHIFT * (level - 1));
+}
+
+/*
+* Runs the plain minimax algorithm: builds the full tree and scores it.
+* @param game - the root game, with an empty history
+* @param maxDepth - the depth of the tree
+* @param current_player - the identity of the player to move
+* @param result - if not NULL, set to the outcome of the search
+* @return the best move, -1 if an allocation failure occurred
+*/
+static int plainSuggestMove(SPFiarGame* game, unsigned int maxDepth, SP_PlayerA current_player, SPMinimaxResult* result) {
+	SPMinimaxTree* tree;
+	int move;
+
+	SP_TRACE_BEGIN(build);
+	tree = spMinimaxTreeCreate(SP_MINIMAX_TREE_INITIAL_CAPACITY, current_player);
+
+	if ((void*)tree == NULL)
+		return -1;
+
+	if (spMinimaxTreeBuild(tree, game, maxDepth) != SP_MINIMAX_NODE_SUCCESS) {
+		spMinimaxTreeDestroy(tree);
+		return -1;
+	}
+
+	SP_TRACE_END(build, (int)maxDepth);
+	SP_TRACE_BEGIN(score);
+	spMinimaxTreeScore(tree);
+	move = spMinimaxTreeBestMove(tree);
+	SP_TRACE_END(score, (int)maxDepth);
+
+	if (result != NULL) {
+		result->move = move;
+		result->score = tree->scores[0];
+		result->nodes = tree->size;
+	}
+
+	spMinimaxTreeDestroy(tree);
+
+	return move;
+}
+
+/*
+* Runs a search of a minimax mode to a depth.
+* @param game - the root game, with an empty history
+* @param depth - the depth of the search
+* @param mode - the mode, not the Monte Carlo tree search
+* @param table - the transposition table, may be NULL
+* @param nodeLimit - the node limit of the search, 0 for none. The plain search has none.
+* @param current_player - the identity of the player to move
+* @param result - if not NULL, set to the outcome of the search
+* @return the best move, -1 if an allocation failure occurred or the node limit was reached
+*/
+static int searchDepth(SPFiarGame* game, unsigned int depth, SP_MINIMAX_MODE mode, SPTransTable* table,
+		unsigned long nodeLimit, SP_PlayerA current_player, SPMinimaxResult* result) {
+	switch (mode) {
+	case SP_MINIMAX_MODE_PVS:
+		return spMinimaxSearchPvs(game, depth, table, nodeLimit, result);
+	case SP_MINIMAX_MODE_MTDF:
+		return spMinimaxSearchMtdf(game, depth, table, nodeLimit, result);
+	default:
+		return plainSuggestMove(game, depth, current_player, result);
+	}
+}
+
+/*
+* Deepens the searches of a minimax mode one depth after the other, until a node
+* budget is spent. A search that reaches the rest of the budget stops and is
+* discarded, the move is that of the deepest search completed. The plain search
+* can't stop early, so it goes one depth deeper only if its tree surely fits the
+* rest of the budget and the memory limit: a tree has at most columns + 1 times
+* the nodes of the tree one depth shallower. The first depth is always completed.
+* @param game - the root game, with an empty history
+* @param maxDepth - the deepest depth to search
+* @param mode - the mode, not the Monte Carlo tree search
+* @param table - the transposition table, shared by the depths, may be NULL
+* @param budget - the node budget
+* @param memoryLimit - the memory limit of the plain tree in bytes, 0 for none
+* @param current_player - the identity of the player to move
+* @param degraded - set to true if the memory limit stopped the deepening
+* @param result - if not NULL, set to the outcome of the deepest search completed,
+*                 with the nodes of all of the searches
+* @return the best move, -1 if an allocation failure occurred at the first depth
+*/
+static int budgetSuggestMove(SPFiarGame* game, unsigned int maxDepth, SP_MINIMAX_MODE mode, SPTransTable* table,
+		unsigned long budget, unsigned long memoryLimit, SP_PlayerA current_player, bool* degraded,
+		SPMinimaxResult* result) {
+	unsigned long columns = (unsigned long)game->geometry->columns;
+	SPMinimaxResult iteration, best;
+	unsigned long used = 0;
+	unsigned int depth;
+
+	iteration.nodes = 0;
+	best.move = -1;
+	best.score = 0;
+
+	for (depth = 1; depth <= maxDepth && used < budget; depth++) {
+		if (mode == SP_MINIMAX_MODE_PLAIN && depth > 1 && iteration.nodes > (budget - used) / (columns + 1))
+			break;
+
+		if (mode == SP_MINIMAX_MODE_PLAIN && depth > 1 && memoryLimit > 0 &&
+			iteration.nodes > memoryLimit / PLAIN_NODE_BYTES / (columns + 1)) {
+			*degraded = true;
+			break;
+		}
+
+		SP_TRACE_BEGIN(iteration);
+		iteration.nodes = 0;
+
+		if (searchDepth(game, depth, mode, table, depth == 1 ? 0 : budget - used, current_player, &iteration) == -1) {
+			used += iteration.nodes;
+			break;
+		}
+
+		SP_TRACE_END(iteration, (int)depth);
+		used += iteration.nodes;
+		best = iteration;
+	}
+
+	if (result != NULL) {
+		result->move = best.move;
+		result->score = best.score;
+		result->nodes = used;
+	}
+
+	return best.move;
+}
+
+/*
+* Checks if the plain tree of a depth surely fits a memory limit: every node of
+* the tree has a child per column at most.
+* @param geometry - the geometry of the game
+* @param depth - the depth of the tree
+* @param memoryLimit - the limit in bytes, 0 for none
+* @return true iff the tree fits
+*/
+static bool plainTreeFits(const SPFiarGeometry* geometry, unsigned int depth, unsigned long memoryLimit) {
+	unsigned long nodes = 1, level = 1, max_nodes = memoryLimit / PLAIN_NODE_BYTES;
+	unsigned int d;
+
+	if (memoryLimit == 0)
+		return true;
+
+	for (d = 0; d < depth && nodes <= max_nodes; d++) {
+		level *= (unsigned long)geometry->columns;
+		nodes += level;
+	}
+
+	return nodes <= max_nodes;
+}
+
+/*
+* Creates the transposition table of a search, halving its entries until it fits
+* a memory limit and can be allocated. A shallow search gets a smaller table than
+* asked, so that it doesn't clear a large one for a few positions.
+* @param size - the entries of the table
+* @param depth - the depth of the search
+* @param memoryLimit - the limit in bytes, 0 for none
+* @param degraded - set to true if the table is smaller than the search needs or missing
+* @return the table, NULL if no table fits or can be allocated
+*/
+static SPTransTable* createTable(unsigned long size, unsigned int depth, unsigned long memoryLimit, bool* degraded) {
+	SPTransTable* table = NULL;
+	unsigned long entries = 1, asked;
+
+	if (depth * TABLE_BITS_PER_PLY < 8 * sizeof(unsigned long) && (1UL << (depth * TABLE_BITS_PER_PLY)) < size)
+		size = 1UL << (depth * TABLE_BITS_PER_PLY);
+
+	// the entries of spTransTableCreate
+	while (entries < size)
+		entries <<= 1;
+
+	asked = entries;
+
+	while (memoryLimit > 0 && entries > 0 && entries * sizeof(SPTransTableEntry) > memoryLimit)
+		entries >>= 1;
+
+	while (entries > 0 && (table = spTransTableCreate(entries)) == NULL)
+		entries >>= 1;
+
+	if (entries < asked)
+		*degraded = true;
+
+	return table;
+}
+
+/*
+* Gives a legal move without any search or allocation, the nearest one to the
+* middle column. The last resort of a search out of memory.
+* @param game - the game
+* @param result - if not NULL, set to the move, a 0 score and 0 nodes, degraded
+* @return the move, -1 if the board is full
+*/
+static int fallbackSuggestMove(SPFiarGame* game, SPMinimaxResult* result) {
+	int columns = game->geometry->columns, move = -1, col, i;
+
+	for (i = 0; i < columns && move == -1; i++) {
+		col = i % 2 == 0 ? (columns - 1) / 2 - i / 2 : (columns - 1) / 2 + (i + 1) / 2;
+
+		if (spFiarGameIsValidMove(game, col))
+			move = col;
+	}
+
+	if (result != NULL) {
+		result->move = move;
+		result->score = 0;
+		result->nodes = 0;
+		result->degraded = true;
+	}
+
+	return move;
+}
+
+/*
+* Copies the game at the root of a search, with an empty history that has room
+* for the moves of the search.
+* @param game - the game
+* @param maxDepth - the depth of the search
+* @return the copy, NULL if an allocation failure occurred
+*/
+static SPFiarGame* copyRootGame(SPFiarGame* game, unsigned int maxDepth) {
+	// copy the current game and clean the history for space
+	SPFiarGame* copied_game = spFiarGameCopy(game);
+
+	if (copied_game == NULL) 
+		return NULL;
+
+	while (spArrayListRemoveLast(copied_game->history) != SP_ARRAY_LIST_EMPTY);
+
+	// the search undoes its moves through the history, it must have room for all of them
+	if ((unsigned int)spArrayListMaxCapacity(copied_game->history) < maxDepth) {
+		spArrayListDestroy(copied_game->history);
+
+		if ((copied_game->history = spArrayListCreate(maxDepth)) == NULL) {
+			free(copied_game);
+			return NULL;
+		}
+	}
+
+	return copied_game;
+}
+
+/*
+* Counts the empty cells of a game, the moves left to the end of the game at most.
+* @param game - the game
+* @return the number of empty cells
+*/
+static unsigned int countEmptyCells(SPFiarGame* game) {
+	unsigned int count = 0;
+	int col;
+
+	for (col = 0; col < game->geometry->columns; col++)
+		count += game->geometry->rows - (game->tops)[col];
+
+	return count;
+}
+
+/*
+* Searches a forced block with the Monte Carlo tree search, which may miss it: the
+* position after the block is searched, and the block gets the score of the best
+* reply negated.
+* @param game - the game, whose player to move must block a single threat
+* @param block - the blocking move
+* @param playouts - the number of playouts, at least 1
+* @param threads - the number of threads
+* @param result - if not NULL, set to the block, its score and the number of playouts
+* @return the block, -1 if an allocation failure occurred
+*/
+static int mctsSearchBlock(SPFiarGame* game, int block, unsigned long playouts, int threads, SPMinimaxResult* result) {
+	SPFiarGame* child = spFiarGameCopy(game);
+	SPMinimaxResult reply;
+
+	if (child == NULL)
+		return -1;
+
+	spFiarGameSetMove(child, block);
+	reply.score = 0;
+	reply.nodes = 0;
+
+	// a block that fills the board ends the game in a tie
+	if (spFiarCheckWinner(child) == NO_WINNER && spMctsSearch(child, playouts, threads, &reply) == -1) {
+		spFiarGameDestroy(child);
+		return -1;
+	}
+
+	spFiarGameDestroy(child);
+
+	if (result != NULL) {
+		result->move = block;
+		result->score = -reply.score;
+		result->nodes = reply.nodes;
+		result->degraded = false;
+	}
+
+	return block;
+}
+
+int spMinimaxSuggestMoveWithConfig(SPFiarGame* currentGame, unsigned int maxDepth,
+		const SPMinimaxConfig* config, SPMinimaxResult* result) {
 	SP_PlayerA current_player;
-	SPMinimaxNode *root;
+	SPMinimaxConfig default_config;
 	SPFiarGame* copied_game;
-	int move;
+	SPTransTable* table = NULL;
+	SP_MINIMAX_MODE mode;
+	unsigned long budget = 0, playouts, max_playouts;
+	bool degraded = false;
+	int move, forced;
 
 	if ((void*)currentGame == NULL || maxDepth <= 0) 
 		return -1;
 
+	if (config == NULL) {
+		spMinimaxConfigInit(&default_config);
+		config = &default_config;
+	}
+
+	// an immediate win needs no search, a single threat to block is searched for its score
+	if ((forced = spGetForcedMove(currentGame)) != -1 &&
+		spCountImmediateWins(currentGame, spFiarGameGetCurrentPlayer(currentGame), NULL) > 0) {
+		if (result != NULL) {
+			result->move = forced;
+			result->score = SP_MINIMAX_WIN_SCORE - 1;
+			result->nodes = 0;
+			result->degraded = false;
+		}
+
+		return forced;
+	}
+
+	// a node level searches as deep as its budget allows
+	if (config->levels == SP_MINIMAX_LEVELS_NODES) {
+		budget = spMinimaxLevelBudget(maxDepth);
+	}
+
+	mode = config->mode;
+
+	// the tree search works on its own bitboards, it needs no copy of the game
+	if (mode == SP_MINIMAX_MODE_MCTS) {
+		playouts = config->playouts > 0 ? config->playouts : (budget > 0 ?
+			(budget < MCTS_MAX_LEVEL_PLAYOUTS ? budget : MCTS_MAX_LEVEL_PLAYOUTS) :
+			(unsigned long)SP_MCTS_PLAYOUTS_PER_LEVEL << (maxDepth - 1 < MCTS_MAX_DOUBLINGS ? maxDepth - 1 : MCTS_MAX_DOUBLINGS));
+
+		// the node pool of the tree must fit the memory limit
+		if (config->memoryLimit > 0 &&
+			playouts > (max_playouts = spMctsMaxPlayouts(currentGame->geometry, config->memoryLimit))) {
+			playouts = max_playouts;
+			degraded = true;
+		}
+
+		SP_TRACE_BEGIN(mcts);
+
+		if (playouts == 0)
+			move = -1;
+		else if (forced != -1)
+			move = mctsSearchBlock(currentGame, forced, playouts, config->threads > 1 ? config->threads : 1, result);
+		else
+			move = spMctsSearch(currentGame, playouts, config->threads > 1 ? config->threads : 1, result);
+
+		SP_TRACE_END(mcts, (int)maxDepth);
+
+		if (move != -1) {
+			if (result != NULL)
+				result->degraded = degraded;
+
+			return move;
+		}
+
+		// out of memory, a shallow search that allocates nothing plays instead
+		degraded = true;
+		mode = SP_MINIMAX_MODE_PVS;
+		maxDepth = MCTS_FALLBACK_DEPTH;
+	}
+
+	if (budget > 0) {
+		maxDepth = countEmptyCells(currentGame);
+	}
+
+	SP_TRACE_BEGIN(setup);
+
 	if (spFiarGameGetCurrentPlayer(currentGame) == SP_FIAR_GAME_PLAYER_1_SYMBOL) 
 		current_player = Player1;
 
 	else 
 		current_player = Player2;
 
-	// copy the current game and clean the history for space. Assumes history >= max depth
-	copied_game = spFiarGameCopy(currentGame);
+	if ((copied_game = copyRootGame(currentGame, maxDepth)) == NULL)
+		return fallbackSuggestMove(currentGame, result);
 
-	if (copied_game == NULL) 
-		return -1;
+	// a plain tree that may not fit is replaced by a search that allocates nothing, with the same move and score
+	if (mode == SP_MINIMAX_MODE_PLAIN && budget == 0 &&
+		!plainTreeFits(currentGame->geometry, maxDepth, config->memoryLimit)) {
+		mode = SP_MINIMAX_MODE_PVS;
+		degraded = true;
+	}
 
-	while (spArrayListRemoveLast(copied_game->history) != SP_ARRAY_LIST_EMPTY);
+	if (mode != SP_MINIMAX_MODE_PLAIN && !degraded && config->tableSize > 0) {
+		// without a table the search is still correct, only slower
+		table = createTable(config->tableSize, maxDepth, config->memoryLimit, &degraded);
+	}
 
-	root = spMinimaxNodeCreate(ROOT_NO_MOVE, MAX_NODE, current_player);
+	SP_TRACE_END(setup, (int)maxDepth);
+	SP_TRACE_BEGIN(search);
 
-	if ((void*)root == NULL) {
-		spFiarGameDestroy(copied_game);
-		return -1;
+	if (budget > 0)
+		move = budgetSuggestMove(copied_game, maxDepth, mode, table, budget, config->memoryLimit,
+			current_player, &degraded, result);
+	else
+		move = searchDepth(copied_game, maxDepth, mode, table, 0, current_player, result);
+
+	// the plain tree ran out of memory, the search that allocates nothing gives its move
+	if (move == -1 && mode == SP_MINIMAX_MODE_PLAIN) {
+		degraded = true;
+
+		if (budget > 0)
+			move = budgetSuggestMove(copied_game, maxDepth, SP_MINIMAX_MODE_PVS, NULL, budget, 0,
+				current_player, &degraded, result);
+		else
+			move = searchDepth(copied_game, maxDepth, SP_MINIMAX_MODE_PVS, NULL, 0, current_player, result);
 	}
 
-	if (spBuildNodeSubtree(root, copied_game, maxDepth) != SP_MINIMAX_NODE_SUCCESS) {
-		spFiarGameDestroy(copied_game);
-		spMinimaxNodeDestroy(root);
+	SP_TRACE_END(search, (int)maxDepth);
+	spTransTableDestroy(table);
+	spFiarGameDestroy(copied_game);
+
+	if (result != NULL)
+		result->degraded = degraded;
+
+	return move;
+}
+
+int spMinimaxAnalyzeMoves(SPFiarGame* currentGame, unsigned int maxDepth, const SPMinimaxConfig* config,
+		SPMinimaxLine lines[SP_FIAR_GAME_MAX_COLUMNS], SPMinimaxResult* result) {
+	SPMinimaxConfig default_config;
+	SPFiarGame* copied_game;
+	SPTransTable* table = NULL;
+	bool degraded = false;
+	int count;
+
+	if ((void*)currentGame == NULL || (void*)lines == NULL || maxDepth <= 0)
 		return -1;
+
+	if (config == NULL) {
+		spMinimaxConfigInit(&default_config);
+		config = &default_config;
 	}
 
-	spCalculateNodeScore(root, copied_game);
-	move = spGetMinimaxBestMove(root, copied_game);
+	if ((copied_game = copyRootGame(currentGame, maxDepth)) == NULL)
+		return -1;
 
-	spMinimaxSubtreeDestroy(root);
+	// the root moves share the table, without one they are searched apart
+	if (config->tableSize > 0)
+		table = createTable(config->tableSize, maxDepth, config->memoryLimit, &degraded);
+
+	count = spMinimaxSearchMultiPv(copied_game, maxDepth, table, 0, lines, result);
+	spTransTableDestroy(table);
 	spFiarGameDestroy(copied_game);
 
-	return move;
-}
\ No newline at end of file
+	if (count != -1 && result != NULL)
+		result->degraded = degraded;
+
+	return count;
+}
@@ -1,7 +1,59 @@
 #ifndef SPMINIMAX_H_
 #define SPMINIMAX_H_
 
+#include <stdbool.h>
 #include "SPFIARGame.h"
+#include "SPMinimaxSearch.h"
+
+// default number of entries of the transposition table of a search
+#define SP_MINIMAX_DEFAULT_TABLE_SIZE (1UL << 18)
+// the node budget of the first node level, every level has 4 times the budget of the previous one
+#define SP_MINIMAX_LEVEL_NODES 250UL
+#define SP_MINIMAX_LEVEL_NODES_SHIFT 2
+// the highest node level, higher levels have its budget
+#define SP_MINIMAX_MAX_NODE_LEVEL 16
+
+/**
+ * The search algorithm of the engine. All minimax modes give the same move and
+ * score, the Monte Carlo tree search plays by sampling and scores by its own scale.
+ */
+typedef enum sp_minimax_mode_t {
+	SP_MINIMAX_MODE_PLAIN, // the full tree of spMinimaxTreeBuild
+	SP_MINIMAX_MODE_PVS,   // principal variation search, see spMinimaxSearchPvs
+	SP_MINIMAX_MODE_MTDF,  // MTD(f), see spMinimaxSearchMtdf
+	SP_MINIMAX_MODE_MCTS   // Monte Carlo tree search, see spMctsSearch
+} SP_MINIMAX_MODE;
+
+/**
+ * The meaning of the level of a search. A depth level is the depth of the search,
+ * so its cost varies with the position. A node level is a budget of nodes (see
+ * spMinimaxLevelBudget): the search deepens one depth after the other until the
+ * budget is spent, and gives the move of the deepest depth it completed. The
+ * node counts don't depend on the machine, so neither does the move, and the cost
+ * of a move is bounded by the budget.
+ */
+typedef enum sp_minimax_levels_t {
+	SP_MINIMAX_LEVELS_DEPTH,
+	SP_MINIMAX_LEVELS_NODES
+} SP_MINIMAX_LEVELS;
+
+/**
+ * The configuration of the engine. A search that would exceed the memory limit,
+ * or fails to allocate its memory, degrades instead of failing: the transposition
+ * table is halved until it fits, the plain tree is replaced by a principal
+ * variation search without a table (same move and score, no allocation), the
+ * playouts of the Monte Carlo tree search are cut to fit its node pool, and a
+ * tree search that still can't allocate plays by a shallow minimax search. The
+ * limit bounds the memory of the search, not that of the process.
+ */
+typedef struct sp_minimax_config_t {
+	SP_MINIMAX_MODE mode;
+	unsigned long tableSize; // entries of the transposition table, 0 for no table
+	unsigned long playouts;  // playouts of the Monte Carlo tree search, 0 to derive them from the depth
+	int threads;             // threads of the Monte Carlo tree search, 0 for a single one
+	SP_MINIMAX_LEVELS levels;
+	unsigned long memoryLimit; // bytes of the trees, tables and pools of a search, 0 for no limit
+} SPMinimaxConfig;
 
 /**
  * Given a game state, this function evaluates the best move according to
@@ -13,10 +65,112 @@
  * @param maxDepth - The maximum depth of the miniMax algorithm
  * @return
  * -1 if either currentGame is NULL or maxDepth <= 0.
- * On success the function returns a number between [0,SP_FIAR_GAME_N_COLUMNS -1]
+ * On success the function returns a number between [0,currentGame->geometry->columns -1]
  * which is the best move for the current player.
  */
 int spMinimaxSuggestMove(SPFiarGame* currentGame,
 		unsigned int maxDepth);
 
+/**
+ * Same as spMinimaxSuggestMove, with the search algorithm of the configuration.
+ *
+ * @param currentGame - The current game state
+ * @param maxDepth - The maximum depth of the miniMax algorithm, or the level
+ *                   of the node budget if the configuration has node levels
+ * @param config - The configuration, NULL for the default one
+ * @param result - if not NULL, set to the move, score and node count of the search.
+ *                 A move that wins at once is not searched, it gets 0 nodes and
+ *                 the win score. A forced block is searched like any position, the
+ *                 minimax searches only expand the block at the root, and the Monte
+ *                 Carlo tree search searches the position after the block. The Monte Carlo
+ *                 tree search sets the score and node count of spMctsSearch, its
+ *                 playouts are SP_MCTS_PLAYOUTS_PER_LEVEL << (maxDepth - 1), or
+ *                 the budget of a node level, unless the configuration sets them.
+ *                 Either way a level gets at most SP_MCTS_PLAYOUTS_PER_LEVEL << 10
+ *                 playouts, those of level 11 or node level 7, whose node pool
+ *                 takes 140 to 190 MB depending on the geometry.
+ *                 The nodes of a node level are those of all of its depths. It is
+ *                 degraded if the search was cut down to fit its memory.
+ * @return
+ * -1 if either currentGame is NULL or maxDepth <= 0. An allocation failure degrades
+ * the search, down to the legal move nearest to the middle if even the copy of the
+ * game fails.
+ * On success the function returns a number between [0,currentGame->geometry->columns -1]
+ * which is the best move for the current player.
+ */
+int spMinimaxSuggestMoveWithConfig(SPFiarGame* currentGame, unsigned int maxDepth,
+		const SPMinimaxConfig* config, SPMinimaxResult* result);
+
+/**
+ * Scores every move of a game with its principal variation, by a single multi-PV
+ * search (see spMinimaxSearchMultiPv) sharing the transposition table of the
+ * configuration, limited to its memory. The search mode and the level meaning of
+ * the configuration are ignored: maxDepth is the depth of the search. The current
+ * game state doesn't change by this function including the history of previous moves.
+ *
+ * @param currentGame - The current game state
+ * @param maxDepth - The depth of the search
+ * @param config - The configuration, NULL for the default one
+ * @param lines - set to the moves with their scores and principal variations,
+ *                in column order
+ * @param result - if not NULL, set to the best move, its score and the node count
+ *                 of the search. It is degraded if the table was cut down to fit
+ *                 its memory.
+ * @return
+ * -1 if either currentGame or lines is NULL, maxDepth <= 0, the game is over or an
+ * allocation failure occurred. Otherwise, the number of moves.
+ */
+int spMinimaxAnalyzeMoves(SPFiarGame* currentGame, unsigned int maxDepth, const SPMinimaxConfig* config,
+		SPMinimaxLine lines[SP_FIAR_GAME_MAX_COLUMNS], SPMinimaxResult* result);
+
+/**
+ * Sets a configuration to the default one: the plain tree search with depth levels, a
+ * transposition table of SP_MINIMAX_DEFAULT_TABLE_SIZE entries for the other modes
+ * and a single thread of playouts derived from the depth for the Monte Carlo mode,
+ * without a memory limit.
+ *
+ * @param config - the configuration, nothing happens if it is NULL
+ */
+void spMinimaxConfigInit(SPMinimaxConfig* config);
+
+/**
+ * Parses the name of a search mode: "plain", "pvs", "mtdf" or "mcts".
+ *
+ * @param str - the name
+ * @param mode - set to the mode on success
+ * @return
+ * true iff str is the name of a mode
+ */
+bool spMinimaxParseMode(const char* str, SP_MINIMAX_MODE* mode);
+
+/**
+ * Parses the name of a level meaning: "depth" or "nodes".
+ *
+ * @param str - the name
+ * @param levels - set to the level meaning on success
+ * @return
+ * true iff str is the name of a level meaning
+ */
+bool spMinimaxParseLevels(const char* str, SP_MINIMAX_LEVELS* levels);
+
+/**
+ * Returns the node budget of a node level: SP_MINIMAX_LEVEL_NODES for level 1,
+ * 4 times more for every level above, up to SP_MINIMAX_MAX_NODE_LEVEL. Level 7,
+ * the highest difficulty level of the game, has 1024000 nodes.
+ *
+ * @param level - the level, 1 at least
+ * @return
+ * the budget
+ */
+unsigned long spMinimaxLevelBudget(unsigned int level);
+
+/**
+ * Returns the name of a search mode, as accepted by spMinimaxParseMode.
+ *
+ * @param mode - the mode
+ * @return
+ * the name of the mode
+ */
+const char* spMinimaxModeName(SP_MINIMAX_MODE mode);
+
 #endif
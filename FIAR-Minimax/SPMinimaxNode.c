@@ -1,492 +1,229 @@
 #include "SPMinimaxNode.h"
 #include <string.h>
+#include <pthread.h>
 
-SPMinimaxNode* spMinimaxNodeCreate(int move, SP_MINIMAX_NODE_TYPE type, SP_PlayerA player_A_identity) {
-	int i;
-	SPMinimaxNode* node;
-	
-	if (!(move >= ROOT_NO_MOVE && move < SP_FIAR_GAME_N_COLUMNS)) {
-		return NULL;
-	}
-
-	node = (SPMinimaxNode*)(malloc(sizeof(SPMinimaxNode)));
-
-	if ((void*)node == NULL) {
-		return NULL;
-	}
-	
-	if ((void*)(node->children) == NULL) {
-		free(node);
-		return NULL;
-	}
-
-	node->move = move;
-	node->type = type;
-	
-	// set 0 children
-	for (i = 0; i < SP_FIAR_GAME_N_COLUMNS; i++) {
-		*(node->children + i) = NULL;
-	}
-
-	node->score_defined = false;
-	node->player_A_identity = player_A_identity;
-
-	return node;
-}
-
-void spMinimaxNodeDestroy(SPMinimaxNode* node) {
-	if ((void*)node == NULL) {
-		return;
-	}
-
-	free(node);
-}
+/* the values of the span patterns (3^span of them) of the geometries of each span, built once by buildPatternTables */
+static int patterns_span_4[81];
+static int patterns_span_5[243];
+static pthread_once_t patterns_once = PTHREAD_ONCE_INIT;
 
 /**
-*  For node of type max returns min, and the opposite.
-*  Suppose node != null
-*  @param node - the node
+*  Returns the symbol of the player who is not the current player.
+*  Suppose game != null
+*  @param game - the game
 *  @return
-*  SP_MINIMAX_NODE_TYPE - the opposite type
+*  the symbol of the opponent of the current player
 */
-static SP_MINIMAX_NODE_TYPE getOppositeType(SPMinimaxNode* node) {
-	if (node->type == MAX_NODE) {
-		return MIN_NODE;
+static char getOpponentSymbol(SPFiarGame* game) {
+	if (spFiarGameGetCurrentPlayer(game) == SP_FIAR_GAME_PLAYER_1_SYMBOL) {
+		return SP_FIAR_GAME_PLAYER_2_SYMBOL;
 	}
 
-	return MAX_NODE;
+	return SP_FIAR_GAME_PLAYER_1_SYMBOL;
 }
 
-SP_MINIMAX_NODE_MESSAGE spBuildNodeSubtree(SPMinimaxNode* node, SPFiarGame* game, unsigned int depth) {
-	int i;
-	SPMinimaxNode* child_node;
-	SP_MINIMAX_NODE_MESSAGE msg;
-
-	if ((void*)node == NULL || (void*)game == NULL || depth == 0) {
-		return SP_MINIMAX_NODE_INVALID_ARGUMENT;
-	}
+int spCountImmediateWins(SPFiarGame* game, char symbol, int* first_col) {
+	int i, count = 0;
 
-	// set the node move
-	if (node->move != ROOT_NO_MOVE) {
-		spFiarGameSetMove(game, node->move);
+	if (first_col != NULL) {
+		*first_col = -1;
 	}
 
-	// check if the game has ended
-	if (spFiarCheckWinner(game) != NO_WINNER) {
-		spFiarGameUndoPrevMove(game);
-		return SP_MINIMAX_NODE_SUCCESS;
+	if ((void*)game == NULL) {
+		return 0;
 	}
 
-	// valid node and depth > 0
-	for (i = 0; i < SP_FIAR_GAME_N_COLUMNS; i++) {
-		if (spFiarGameIsValidMove(game, i)) {
-			
-			child_node = spMinimaxNodeCreate(i, getOppositeType(node), node->player_A_identity);
-
-			if ((void*)child_node == NULL) 
-				return SP_MINIMAX_NODE_MEM_ERR;
-
-			// give birth to the child
-			*(node->children + i) = child_node;
-
-			// recurse
-			msg = spBuildNodeSubtree(child_node, game, depth - 1);
-
-			if (msg == SP_MINIMAX_NODE_MEM_ERR) {
-				spMinimaxSubtreeDestroy(child_node);
-				return SP_MINIMAX_NODE_MEM_ERR;
+	for (i = 0; i < game->geometry->columns; i++) {
+		if (spFiarGameIsWinningMove(game, i, symbol)) {
+			if (count == 0 && first_col != NULL) {
+				*first_col = i;
 			}
+
+			count++;
 		}
 	}
-	
-	// undo move
-	if (node->move != ROOT_NO_MOVE) {
-		spFiarGameUndoPrevMove(game);
-	}
 
-	return SP_MINIMAX_NODE_SUCCESS;
+	return count;
 }
 
-void spMinimaxSubtreeDestroy(SPMinimaxNode* node) {
-	int i;
+int spGetForcedMove(SPFiarGame* game) {
+	int col;
 
-	if ((void*)node == NULL) {
-		return;
+	if ((void*)game == NULL || spFiarCheckWinner(game) != NO_WINNER) {
+		return -1;
 	}
 
-	for (i = 0; i < SP_FIAR_GAME_N_COLUMNS; i++) {
-		if ((void*)(*(node->children + i)) != NULL) {
-			spMinimaxSubtreeDestroy(*(node->children + i));
-		}
+	if (spCountImmediateWins(game, spFiarGameGetCurrentPlayer(game), &col) > 0) {
+		return col;
 	}
 
-	spMinimaxNodeDestroy(node);
-}
-
-int spCalculateNodeScore(SPMinimaxNode* node, SPFiarGame* game) {
-	int val, i, nextval; // index
-	
-	if ((void*)node == NULL || (void*)game == NULL) {
-		return 0;
-	}
-
-	// set the node move
-	if (node->move != ROOT_NO_MOVE) {
-		spFiarGameSetMove(game, node->move);
+	if (spCountImmediateWins(game, getOpponentSymbol(game), &col) == 1) {
+		return col;
 	}
 
-	if (isLeaf(node)) {
-		val = spCalculateLeafScore(node, game);
-
-		// undo move
-		if (node->move != ROOT_NO_MOVE) {
-			spFiarGameUndoPrevMove(game);
-		}
+	return -1;
+}
 
-		return val;
+int spGetWinScore(char winner, SP_PlayerA player_A_identity, int ply) {
+	if ((winner == SP_FIAR_GAME_PLAYER_1_SYMBOL) == (player_A_identity == Player1)) {
+		return SP_MINIMAX_WIN_SCORE - ply;
 	}
 
-	// get to the first non-null child
-	for (i = 0; i < SP_FIAR_GAME_N_COLUMNS && (void*)(*(node->children + i)) == NULL; i++);
+	return -(SP_MINIMAX_WIN_SCORE - ply);
+}
 
-	val = spCalculateNodeScore(*(node->children + i), game);
-	//index = i;
+int spGetThreatParityScore(SPFiarGame* game, SP_THREAT_PARITY_RESULT result, SP_PlayerA player_A_identity) {
+	int ply, j;
 
-	if (node->type == MAX_NODE) {
-		for (i = i + 1; i < SP_FIAR_GAME_N_COLUMNS; i++) {
-			if ((void*)(*(node->children + i)) != NULL) {
-				nextval = spCalculateNodeScore(*(node->children + i), game);
-				if (nextval > val) {
-					val = nextval;
-					//index = i;
-				}
-			}
-		}
-	}
-
-	else { // min node
-		for (i = i + 1; i < SP_FIAR_GAME_N_COLUMNS; i++) {
-			if ((void*)(*(node->children + i)) != NULL) {
-				nextval = spCalculateNodeScore(*(node->children + i), game);
-				if (nextval < val) {
-					val = nextval;
-					//index = i;
-				}
-			}
-		}
+	if ((void*)game == NULL || result == SP_THREAT_PARITY_DRAW) {
+		return 0;
 	}
 
-	node->score = val;
-	node->score_defined = true;
+	// the distance of the win isn't known, the win comes by the time the board is full
+	ply = spArrayListSize(game->history) + game->geometry->rows * game->geometry->columns;
 
-	// undo move
-	if (node->move != ROOT_NO_MOVE) {
-		spFiarGameUndoPrevMove(game);
+	for (j = 0; j < game->geometry->columns; j++) {
+		ply -= (game->tops)[j];
 	}
 
-	return val;
+	return spGetWinScore(result == SP_THREAT_PARITY_PLAYER_1_WINS ? SP_FIAR_GAME_PLAYER_1_SYMBOL : SP_FIAR_GAME_PLAYER_2_SYMBOL,
+		player_A_identity, ply);
 }
 
-/*
-*  Gets the value of the given characer.
-*  @param symbol the character
-*  @return 
-*  1 for Player1 character, -1 for Player2 character, 0 o/w
-*/
-static int spGetSymbolValue(char symbol) {
-	if (symbol == SP_FIAR_GAME_PLAYER_1_SYMBOL) {
-		return 1;
-	}
+void spGetNodeExpansion(SPFiarGame* game, bool is_root, unsigned int depth, SP_PlayerA player_A_identity,
+	SPMinimaxExpansion* expansion) {
+	int forced_col, win_col, threats, wins;
+	SP_THREAT_PARITY_RESULT proof;
 
-	if (symbol == SP_FIAR_GAME_PLAYER_2_SYMBOL) {
-		return -1;
+	if ((void*)game == NULL || (void*)expansion == NULL) {
+		return;
 	}
 
-	return 0;
-}
-
-/*
-*  Calculates the minimax algorithm value of the given histogram.
-*  Assume histogram is of length SIZE_OF_HISTOGRAM.
-*  @param histogram - the histogram
-*  @param playerA_identity - the identity of player A
-*  @return
-*  The minimax algorithm value of the given histogram.
-*/
-static int spCalculateValFromHistogram(int histogram[SIZE_OF_HISTOGRAM], SP_PlayerA playerA_identity) {
-	int weights[] = WEIGHTS, result_arr[(SP_FIAR_GAME_SPAN - 1) * 2];
-	int i, result = 0;
-
-	/*
-	// -4 score was found
-	if (histogram[0] > 0) {
-		if (playerA_identity == Player1) {
-			return INT_MIN;
-		}
+	expansion->is_leaf = true;
+	expansion->score_defined = false;
+	expansion->first_col = 0;
+	expansion->last_col = game->geometry->columns - 1;
 
-		return INT_MAX;
+	// no more depth or the game has ended
+	if (depth == 0 || spFiarCheckWinner(game) != NO_WINNER) {
+		return;
 	}
 
-	
-	// 4 score was found
-	if (histogram[SIZE_OF_HISTOGRAM - 1] > 0) {
-		if (playerA_identity == Player1) {
-			return INT_MAX;
-		}
+	threats = spCountImmediateWins(game, getOpponentSymbol(game), &forced_col);
+	wins = spCountImmediateWins(game, spFiarGameGetCurrentPlayer(game), &win_col);
 
-		return INT_MIN;
+	// the score is known without children (the root always gets children for the best move)
+	if (!is_root && (threats > 1 || wins > 0)) {
+		return;
 	}
-	*/
 
-	// get the relevant results from the histogram
-	for (i = 0; i < (SP_FIAR_GAME_SPAN - 1) * 2; i++) {
-		if (i < SP_FIAR_GAME_SPAN - 1) {
-			result_arr[i] = histogram[i + 1];
-		}
-		else {
-			result_arr[i] = histogram[i + 2];
-		}
+	// a deep subtree is not needed if the result is proven statically
+	if (!is_root && depth >= SP_THREAT_PARITY_MIN_DEPTH &&
+		(proof = spThreatParityAnalyze(game)) != SP_THREAT_PARITY_UNKNOWN) {
+		expansion->score = spGetThreatParityScore(game, proof, player_A_identity);
+		expansion->score_defined = true;
+		return;
 	}
 
-	for (i = 0; i < (SP_FIAR_GAME_SPAN - 1) * 2; i++) {
-		result += weights[i] * result_arr[i];
-	}
+	expansion->is_leaf = false;
 
-	if (playerA_identity == Player2) {
-		result = -1 * result;
+	// a win at once beats any other move, blocking included
+	if (wins > 0) {
+		expansion->first_col = win_col;
+		expansion->last_col = win_col;
 	}
 
-	return result;
-}
-
-/*
-Populates the histogram according to all of the column spans.
-@param histogram - the histogram (assumes of SIZE_OF_HISTOGRAM length)
-@param game - the game
-*/
-static void populateHistogramWithColSpans(int histogram[], SPFiarGame* game) {
-	int span_val, i, j, m;
-
-	// check col spans
-	for (j = 0; j < SP_FIAR_GAME_N_COLUMNS; j++) {
-
-		for (i = 0; i < SP_FIAR_GAME_N_ROWS - SP_FIAR_GAME_SPAN + 1; i++) {
-			span_val = 0;
-
-			for (m = 0; m < SP_FIAR_GAME_SPAN; m++) {
-				span_val += spGetSymbolValue(game->gameBoard[i + m][j]);
-			}
-
-			histogram[span_val + SP_FIAR_GAME_SPAN]++;
-		}
+	// a single threat must be blocked, any other move loses at once
+	else if (threats == 1) {
+		expansion->first_col = forced_col;
+		expansion->last_col = forced_col;
 	}
-}
-
-/*
-Populates the histogram according to all of the rows spans.
-@param histogram - the histogram (assumes of SIZE_OF_HISTOGRAM length)
-@param game - the game
-*/
-static void populateHistogramWithRowSpans(int histogram[], SPFiarGame* game) {
-	int span_val, i, j, m;
-
-	// check rows spans
-	for (i = 0; i < SP_FIAR_GAME_N_ROWS; i++) {
-
-		for (j = 0; j < SP_FIAR_GAME_N_COLUMNS - SP_FIAR_GAME_SPAN + 1; j++) {
-			span_val = 0;
 
-			for (m = 0; m < SP_FIAR_GAME_SPAN; m++) {
-				span_val += spGetSymbolValue(game->gameBoard[i][j + m]);
-			}
-
-			histogram[span_val + SP_FIAR_GAME_SPAN]++;
-		}
+	// in a mirror symmetric position the right half mirrors the left half
+	else if (spFiarGameIsMirrorSymmetric(game)) {
+		expansion->last_col = (game->geometry->columns - 1) / 2;
 	}
 }
 
 /*
-Populates the histogram according to all of the left diagonal spans.
-@param histogram - the histogram (assumes of SIZE_OF_HISTOGRAM length)
-@param game - the game
+*  Fills the pattern table of a span (see evaluateSpans of SPFIARGeometry.h): the value
+*  of a pattern is the weight of its number of player 1 discs minus its number of
+*  player 2 discs. A span without that difference or full of one player's discs (a
+*  win, which the evaluation never sees) is worth 0. The value of a pattern could as
+*  well depend on where its discs and empty cells are.
+*  @param patterns - the table, of 3^span entries
+*  @param span - the span, 4 or 5
+*  @param weights - the weights of the differences -(span - 1), ..., -1, 1, ..., span - 1
 */
-static void populateHistogramWithLeftDiagSpans(int histogram[], SPFiarGame* game) {
-	int span_val, i, j, k, m;
-
-	// check diagonals of type '\'
-		// checking the diagonals start with the last column
-	for (i = SP_FIAR_GAME_N_ROWS - 1; i >= 0; i--) {
-
-		// go diagonaly left up
-		for (j = SP_FIAR_GAME_N_COLUMNS - 1, k = i; j >= 0 && k < SP_FIAR_GAME_N_ROWS; j--, k++) {
-			// check if the span is within range
-			if (j - (SP_FIAR_GAME_SPAN - 1) >= 0 && k + SP_FIAR_GAME_SPAN - 1 < SP_FIAR_GAME_N_ROWS) {
-				span_val = 0;
+static void fillPatternTable(int patterns[], int span, const int weights[]) {
+	int pattern, count = 1, digits, sum, i;
 
-				for (m = 0; m < SP_FIAR_GAME_SPAN; m++) {
-					span_val += spGetSymbolValue(game->gameBoard[k + m][j - m]);
-				}
-
-				histogram[span_val + SP_FIAR_GAME_SPAN]++;
-			}
-		}
+	for (i = 0; i < span; i++) {
+		count *= 3;
 	}
 
-	// checking the diagonals start with the bottom row
-	for (j = 0; j < SP_FIAR_GAME_N_COLUMNS - 1; j++) {
-
-		// go diagonaly left up
-		for (i = 0, k = j; i < SP_FIAR_GAME_N_ROWS && k >= 0; k--, i++) {
-			// check if the span is within range
-			if (k - (SP_FIAR_GAME_SPAN - 1) >= 0 && i + SP_FIAR_GAME_SPAN - 1 < SP_FIAR_GAME_N_ROWS) {
-				span_val = 0;
-
-				for (m = 0; m < SP_FIAR_GAME_SPAN; m++) {
-					span_val += spGetSymbolValue(game->gameBoard[i + m][k - m]);
-				}
+	for (pattern = 0; pattern < count; pattern++) {
+		for (sum = 0, digits = pattern, i = 0; i < span; i++, digits /= 3) {
+			sum += digits % 3 == 1 ? 1 : (digits % 3 == 2 ? -1 : 0);
+		}
 
-				histogram[span_val + SP_FIAR_GAME_SPAN]++;
-			}
+		if (sum == 0 || sum == span || sum == -span) {
+			patterns[pattern] = 0;
+		}
+		else {
+			patterns[pattern] = weights[sum < 0 ? sum + span - 1 : sum + span - 2];
 		}
 	}
 }
 
 /*
-Populates the histogram according to all of the right diagonal spans.
-@param histogram - the histogram (assumes of SIZE_OF_HISTOGRAM length)
-@param game - the game
+*  Fills the pattern tables of both spans from the weights of SPEvalWeights.h.
 */
-static void populateHistogramWithRightDiagSpans(int histogram[], SPFiarGame* game) {
-	int span_val, i, j, k, m;
-
-	// check diagonals of type /
-	// checking the diagonals start with the first column
-	for (i = SP_FIAR_GAME_N_ROWS - 1; i >= 0; i--) {
-
-		// go diagonaly right up
-		for (j = 0, k = i; j < SP_FIAR_GAME_N_COLUMNS && k < SP_FIAR_GAME_N_ROWS; j++, k++) {
-			// check if there is k + 3, j + 3 is within range
-			if (j + SP_FIAR_GAME_SPAN - 1 < SP_FIAR_GAME_N_COLUMNS && k + SP_FIAR_GAME_SPAN - 1 < SP_FIAR_GAME_N_ROWS) {
-				span_val = 0;
-
-				for (m = 0; m < SP_FIAR_GAME_SPAN; m++) {
-					span_val += spGetSymbolValue(game->gameBoard[k + m][j + m]);
-				}
+static void buildPatternTables(void) {
+	int weights_span_4[] = WEIGHTS, weights_span_5[] = WEIGHTS_SPAN_5;
 
-				histogram[span_val + SP_FIAR_GAME_SPAN]++;
-			}
-		}
-	}
-
-	// checking the diagonals start with the bottom row (except first column - already passed)
-	for (j = 1; j < SP_FIAR_GAME_N_COLUMNS; j++) {
-
-		// go diagonaly right up
-		for (i = 0, k = j; i < SP_FIAR_GAME_N_ROWS && k < SP_FIAR_GAME_N_COLUMNS; k++, i++) {
-			// check if there is k + 3, j + 3 is within range
-			if (i + SP_FIAR_GAME_SPAN - 1 < SP_FIAR_GAME_N_ROWS && k + SP_FIAR_GAME_SPAN - 1 < SP_FIAR_GAME_N_COLUMNS) {
-				span_val = 0;
-
-				for (m = 0; m < SP_FIAR_GAME_SPAN; m++) {
-					span_val += spGetSymbolValue(game->gameBoard[i + m][k + m]);
-				}
-
-				histogram[span_val + SP_FIAR_GAME_SPAN]++;
-			}
-		}
-	}
+	fillPatternTable(patterns_span_4, 4, weights_span_4);
+	fillPatternTable(patterns_span_5, 5, weights_span_5);
 }
 
-int spCalculateLeafScore(SPMinimaxNode* leaf, SPFiarGame* game) {
-	int i, val; 
-	int histogram[SIZE_OF_HISTOGRAM]; // -4, -3, -2, -1, 0, 1, 2, 3, 4
+int spCalculateGameScore(SPFiarGame* game, SP_PlayerA player_A_identity) {
+	int ply, val;
 	char winner;
 	
-	if ((void*)leaf == NULL || (void*)game == NULL || !isLeaf(leaf)) 
+	if ((void*)game == NULL) 
 		return 0;
 
-	// check if the game has ended
-	switch (winner = spFiarCheckWinner(game)) {
-
-	case SP_FIAR_GAME_TIE_SYMBOL:
-		val = 0;
-		break;
-
-	case SP_FIAR_GAME_PLAYER_1_SYMBOL:
-		if (leaf->player_A_identity == Player1) 
-			val = INT_MAX;
-		else 
-			val = INT_MIN;
-		break;
-
-	case SP_FIAR_GAME_PLAYER_2_SYMBOL:
-		if (leaf->player_A_identity == Player1) 
-			val = INT_MIN;
-		else 
-			val = INT_MAX;
-		break;
-
-	default:
-		break;
-	}
-
-	// return if the game has ended
-	if (winner != NO_WINNER) {
-		leaf->score = val;
-		leaf->score_defined = true;
-
-		return val;
-	}
+	ply = spArrayListSize(game->history);
 
-	// set array to zero
-	for (i = 0; i < SIZE_OF_HISTOGRAM; i++) {
-		histogram[i] = 0;
-	}
+	// check if the game has ended, by the last move
+	winner = spFiarCheckWinner(game);
 
-	populateHistogramWithColSpans(histogram, game);
-	populateHistogramWithRowSpans(histogram, game);
-	populateHistogramWithRightDiagSpans(histogram, game);
-	populateHistogramWithLeftDiagSpans(histogram, game);
-		
-	val = spCalculateValFromHistogram(histogram, leaf->player_A_identity);
-
-	leaf->score = val;
-	leaf->score_defined = true;
-
-	return val;
-}
-
-bool isLeaf(SPMinimaxNode* node) {
-	int i;
-
-	if ((void*)node == NULL) {
-		return false;
+	if (winner == SP_FIAR_GAME_TIE_SYMBOL) {
+		return 0;
 	}
 
-	for (i = 0; i < SP_FIAR_GAME_N_COLUMNS; i++) {
-		if ((void*)(*(node->children + i)) != NULL) {
-			return false;
+	// the player to move wins at once, or loses to a double threat
+	if (winner == NO_WINNER) {
+		if (spCountImmediateWins(game, spFiarGameGetCurrentPlayer(game), NULL) > 0) {
+			winner = spFiarGameGetCurrentPlayer(game);
+			ply += 1;
 		}
-	}
-	
-	return true;
-}
-
-int spGetMinimaxBestMove(SPMinimaxNode* node, SPFiarGame* game) {
-	int i;
 
-	if ((void*)node == NULL || (void*)game == NULL || !(node->score_defined)) {
-		return -1;
+		else if (spCountImmediateWins(game, getOpponentSymbol(game), NULL) > 1) {
+			winner = getOpponentSymbol(game);
+			ply += 2;
+		}
 	}
 
-	// check if game already ended
-	if (spFiarCheckWinner(game) != NO_WINNER) {
-		return -1;
+	// return if the game has ended
+	if (winner != NO_WINNER) {
+		return spGetWinScore(winner, player_A_identity, ply);
 	}
 
-	// get index to the desired position
-	for (i = 0; i < SP_FIAR_GAME_N_COLUMNS &&
-		((void*)(*(node->children + i)) == NULL || (*(node->children + i))->score != node->score); i++);
+	// the column, row and both diagonal spans, a table lookup each
+	pthread_once(&patterns_once, buildPatternTables);
+	val = game->geometry->evaluateSpans((const char (*)[SP_FIAR_GAME_MAX_COLUMNS])game->gameBoard,
+		game->geometry->span == 5 ? patterns_span_5 : patterns_span_4);
 
-	return i;
-}
\ No newline at end of file
+	return player_A_identity == Player2 ? -val : val;
+}
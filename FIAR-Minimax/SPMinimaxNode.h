@@ -2,11 +2,14 @@
 #define SPMINIMAXNODE_H_
 
 #define NO_WINNER '\0'
-#define SIZE_OF_HISTOGRAM 9
-#define WEIGHTS { -5, -2, -1, 1, 2, 5 }
+#define SIZE_OF_HISTOGRAM (2 * SP_FIAR_GAME_MAX_SPAN + 1)
 #define ROOT_NO_MOVE -1
+// the score of a win at the root, a win p plies after the root scores SP_MINIMAX_WIN_SCORE - p
+#define SP_MINIMAX_WIN_SCORE 1000000
 
 #include "SPFIARGame.h"
+#include "SPThreatParity.h"
+#include "SPEvalWeights.h"
 #include <limits.h>
 #include <stdlib.h>
 
@@ -15,27 +18,19 @@
 /** 
 * SPMinimaxNode summary:
 *
-* A container represents a Minimax tree node. The node has score, type, move that it represents, 
-* the identity of player A and pointers to the children.
+* The nodes of the minimax tree, shared by every search over it: how a node is
+* expanded and how a leaf is scored. The tree itself is never allocated node by
+* node, the plain search builds it in a pool (see SPMinimaxTree.h) and the
+* alpha-beta searches walk it (see SPMinimaxSearch.h).
 *
-* spMinimaxNodeCreate      - Creates a minimax node of the required type with associated game instance.
-* spMinimaxNodeDestroy     - Destroys the minimax node and frees all memory associated with it.
-* spBuildNodeSubtree       - Builds the minimax node subtree to the specified depth.
-* spMinimaxSubtreeDestroy  - Destroys the subtree rooted in node.
-* spCalculateNodeScore     - Calculates the score of the specified node.
-* spCalculateLeafScore     - Calculates the score the specified leaf.
-* isLeaf				   - Returns true iff the node is a leaf.
-* spGetMinimaxBestMove      - Returns the best move for the game which the input node represents.
+* spCountImmediateWins     - Counts the columns in which a symbol wins at once.
+* spGetForcedMove          - Returns the move forced by an immediate win or a single threat.
+* spGetNodeExpansion       - Decides which children a node gets.
+* spGetWinScore            - Returns the score of a win at a distance from the root.
+* spGetThreatParityScore   - Converts a proven threat parity result to a score.
+* spCalculateGameScore     - Calculates the score of a game position.
 */
 
-/*
-* The type of the node.
-*/
-typedef enum sp_minimax_node_type_t {
-	MAX_NODE,
-	MIN_NODE
-} SP_MINIMAX_NODE_TYPE;
-
 /*
 *  Enum for player A symbol identity.
 */
@@ -44,15 +39,16 @@ typedef enum sp_player_A {
 	Player2
 } SP_PlayerA;
 
-typedef struct sp_minimax_node_t {
-	int score;
-	bool score_defined;
-	SP_MINIMAX_NODE_TYPE type;
-	int move;
-	struct sp_minimax_node_t *children[SP_FIAR_GAME_N_COLUMNS];
-	SP_PlayerA player_A_identity;
-	
-} SPMinimaxNode;
+/*
+*  The way a node is expanded, see spGetNodeExpansion.
+*/
+typedef struct sp_minimax_expansion_t {
+	bool is_leaf;       // the node gets no children
+	bool score_defined; // the score of the leaf is already proven
+	int score;          // the proven score, if score_defined
+	int first_col;      // the children are the valid columns in [first_col, last_col]
+	int last_col;
+} SPMinimaxExpansion;
 
 /*
 *  Enum for errors.
@@ -64,80 +60,86 @@ typedef enum sp_minimax_node_message_t {
 } SP_MINIMAX_NODE_MESSAGE;
 
 /**
-*  Creates a minimax node of the required type with associated game instance.
-*  @param game - the game to associate with the node
-*  @param type - the type of the node
+*  Decides how a node of the minimax tree is expanded, in the position of the game
+*  after the node's move. Every search over the tree has to expand nodes the same
+*  way in order to get the same scores.
+*
+*  A node is a leaf if depth == 0 or the game has ended. A non-root node whose
+*  player can win at once, or faces two immediate threats, is a leaf too (its score
+*  is known). With at least SP_THREAT_PARITY_MIN_DEPTH plies left, a non-root node
+*  whose result is proven by spThreatParityAnalyze is a leaf with a defined score.
+*  Otherwise a root that can win at once only gets its first winning child, a node
+*  facing a single immediate threat only gets the blocking child,
+*  and a node in a mirror symmetric position only gets the columns up to the middle
+*  one (the mirrored moves have the same score and are never chosen over them).
+*
+*  @param game - the game, after the move of the node
+*  @param is_root - true iff the node is the root, the root never is a known leaf
+*  @param depth - the depth left for the node
 *  @param player_A_identity - the identity of player A
-*  @return
-*  NULL, if an allocation error occurred or game  == NULL.
-*  The minimax node otherwise.
+*  @param expansion - the result, nothing happens if it is NULL
 */
-SPMinimaxNode* spMinimaxNodeCreate(int move, SP_MINIMAX_NODE_TYPE type, SP_PlayerA player_A_identity);
+void spGetNodeExpansion(SPFiarGame* game, bool is_root, unsigned int depth, SP_PlayerA player_A_identity,
+	SPMinimaxExpansion* expansion);
 
 /**
-*  Destroys the minimax node and frees all memory associated with it.
-*  If the node is NULL, nothing happens.
-*  @param node - the node to destroy
-*/
-void spMinimaxNodeDestroy(SPMinimaxNode* node);
-
-/**
-*  Builds the minimax node subtree to the specified depth.
-*  @param node - the node to build subtree to
-*  @param depth - depth to recurse (0 means no more)
-*  @param game - the game to make the node's move in 
+*  Returns the score for player A of a win p plies after the root. Faster wins score
+*  higher and slower losses score higher, so the search prefers them.
+*  @param winner - the symbol of the winner
+*  @param player_A_identity - the identity of player A
+*  @param ply - the number of moves from the root to the win
 *  @return
-*  SP_MINIMAX_NODE_INVALID_ARGUMENT, if node == NULL or depth < 0
-*  SP_MINIMAX_NODE_MEM_ERR if allocation fails
-*  SP_MINIMAX_NODE_SUCCESS otherwise.
-*/
-SP_MINIMAX_NODE_MESSAGE spBuildNodeSubtree(SPMinimaxNode* node, SPFiarGame* game, unsigned int depth);
-
-/**
-*  Destroys the subtree rooted in node.
-*  If the node is NULL, nothing happens.
-*  @param node - the root of the subtree
+*  SP_MINIMAX_WIN_SCORE - ply if player A wins, -(SP_MINIMAX_WIN_SCORE - ply) otherwise.
 */
-void spMinimaxSubtreeDestroy(SPMinimaxNode* node);
+int spGetWinScore(char winner, SP_PlayerA player_A_identity, int ply);
 
 /**
-*  Calculates the score of the specified node.
-*  @param node - the node to calculate score for.
-*  @param game - the game to make the node's move in
+*  Converts a proven threat parity result to a score for player A. A proven win
+*  scores as a win once every empty cell is taken: its ply is that of the game,
+*  the size of its history as for every other score, plus the empty cells. The
+*  distance is a bound, the win may come sooner, never later.
+*  @param game - the game the result was proven for
+*  @param result - the proven result, not SP_THREAT_PARITY_UNKNOWN
+*  @param player_A_identity - the identity of player A
 *  @return
-*  undefined, if node == NULL
-*  the score of the node otherwise.
+*  the score of the proven result
 */
-int spCalculateNodeScore(SPMinimaxNode* node, SPFiarGame* game);
+int spGetThreatParityScore(SPFiarGame* game, SP_THREAT_PARITY_RESULT result, SP_PlayerA player_A_identity);
 
 /**
-*  Calculates the score the specified leaf.
-*  @param node - the node to calculate score for.
-*  @param game - the game associated with the leaf
+*  Calculates the score of the game position for player A, the score of a leaf.
+*  Besides a finished game, a position where the player to move can win at once
+*  or faces two immediate threats gets the score of that win or loss. Wins and
+*  losses are scored by spGetWinScore, the ply of a position is the size of the game
+*  history, which is empty at the root.
+*  @param game - the game
+*  @param player_A_identity - the identity of player A
 *  @return
-*  undefined, if leaf == NULL or is not a real leaf
-*  the score of the node otherwise.
+*  0, if game == NULL
+*  the score of the position otherwise.
 */
-int spCalculateLeafScore(SPMinimaxNode* leaf, SPFiarGame* game);
+int spCalculateGameScore(SPFiarGame* game, SP_PlayerA player_A_identity);
 
 /**
-*  Returns true iff the node is a leaf.
-*  @param node - the node to check
+*  Counts the columns in which a disc of the specified symbol would complete a FIAR.
+*  @param game - the game
+*  @param symbol - the symbol of the disc
+*  @param first_col - if not NULL, set to the first such column or -1 if there is none
 *  @return
-*  true iff the node is a leaf 
+*  0 if game == NULL
+*  the number of winning columns otherwise.
 */
-bool isLeaf(SPMinimaxNode* node);
+int spCountImmediateWins(SPFiarGame* game, char symbol, int* first_col);
 
 /**
-*  Returns the best move for the game which the input node represents.
-*  This function has to be called after the tree nodes have scores calculated.
-*  @param node - the root node
-*  @param game - the root game
+*  Returns the move the current player is forced to make: a column that wins at
+*  once, or otherwise the only column that blocks a single immediate threat of
+*  the opponent. Needs no search, only a scan of the column tops.
+*  @param game - the game
 *  @return
-*  The column number (0-based) of the best move if node->val_defined == True and node != NULL
-*  and the game hasn't ended.
-*  -1 otherwise
+*  The column number (0-based) of the forced move.
+*  -1 if game == NULL, the game is over or the position has no forced move.
 */
-int spGetMinimaxBestMove(SPMinimaxNode* root, SPFiarGame* game);
+int spGetForcedMove(SPFiarGame* game);
 
 #endif
\ No newline at end of file
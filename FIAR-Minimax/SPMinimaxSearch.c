@@ -0,0 +1,560 @@
+#include "SPMinimaxSearch.h"
+#include "SPMinimaxNode.h"
+#include "SPTrace.h"
+
+// bounds of the search windows, outside of the range of the scores
+#define SEARCH_INF ((long long)INT_MAX + 1)
+#define SEARCH_NEG_INF ((long long)INT_MIN - 1)
+
+/*
+* The principal variations of the nodes on the current path, by their ply from
+* the root: a node copies the line of its best child after its move.
+*/
+typedef struct sp_search_pv_t {
+	signed char moves[SP_MINIMAX_MAX_PV + 1][SP_MINIMAX_MAX_PV];
+	int length[SP_MINIMAX_MAX_PV + 1];
+} SPSearchPv;
+
+/*
+* The state of a running search.
+*/
+typedef struct sp_search_t {
+	SPFiarGame* game;
+	SPTransTable* table;
+	SP_PlayerA player_A_identity;
+	bool pvs;            // search the children after the first one with zero windows
+	unsigned long nodes;
+	unsigned long node_limit; // 0 for none
+	bool aborted;        // the node limit was reached, the search unwinds
+	SPSearchPv* pv;      // NULL unless the principal variations are collected
+	int root_ply;        // the moves of the history at the root
+} SPSearch;
+
+/*
+* Fills the columns in the order children are searched: from the middle column
+* outwards, the better moves come first.
+*
+* @param order the array to fill, of length columns
+* @param columns the number of columns
+*/
+static void getColumnOrder(int order[SP_FIAR_GAME_MAX_COLUMNS], int columns) {
+	int i;
+
+	for (i = 0; i < columns; i++) {
+		if (i % 2 == 0) {
+			order[i] = (columns - 1) / 2 - i / 2;
+		}
+		else {
+			order[i] = (columns - 1) / 2 + (i + 1) / 2;
+		}
+	}
+}
+
+/*
+* Collects the children moves of a node, first_move first.
+*
+* @param s the search
+* @param expansion the expansion of the node
+* @param first_move the move to search first, -1 for none
+* @param in_order true to keep the column order (at the root)
+* @param moves the array of moves to fill
+* @return the number of moves
+*/
+static int getChildrenMoves(SPSearch* s, SPMinimaxExpansion* expansion, int first_move, bool in_order,
+	int moves[SP_FIAR_GAME_MAX_COLUMNS]) {
+	int order[SP_FIAR_GAME_MAX_COLUMNS], i, col, count = 0;
+
+	if (in_order) {
+		for (i = 0; i < s->game->geometry->columns; i++) {
+			order[i] = i;
+		}
+	}
+	else {
+		getColumnOrder(order, s->game->geometry->columns);
+	}
+
+	if (first_move >= expansion->first_col && first_move <= expansion->last_col &&
+		spFiarGameIsValidMove(s->game, first_move)) {
+		moves[count++] = first_move;
+	}
+
+	for (i = 0; i < s->game->geometry->columns; i++) {
+		col = order[i];
+
+		if (col != first_move && col >= expansion->first_col && col <= expansion->last_col &&
+			spFiarGameIsValidMove(s->game, col)) {
+			moves[count++] = col;
+		}
+	}
+
+	return count;
+}
+
+/*
+* Sets the principal variation of a node to its best move followed by the line
+* of the child it leads to.
+*
+* @param pv the principal variations
+* @param ply the ply of the node from the root
+* @param move the best move of the node
+*/
+static void updatePv(SPSearchPv* pv, int ply, int move) {
+	int i;
+
+	pv->moves[ply][0] = (signed char)move;
+
+	for (i = 0; i < pv->length[ply + 1] && i + 1 < SP_MINIMAX_MAX_PV; i++) {
+		pv->moves[ply][i + 1] = pv->moves[ply + 1][i];
+	}
+
+	pv->length[ply] = i + 1;
+}
+
+/*
+* Searches a node with fail soft alpha-beta.
+*
+* @param s the search
+* @param depth the depth left
+* @param alpha the lower bound of the window
+* @param beta the upper bound of the window
+* @param max_node true iff player A is to move
+* @return the score of the node if it is within (alpha, beta), otherwise a bound
+*         on the side of the window it fell on
+*/
+static int searchNode(SPSearch* s, unsigned int depth, long long alpha, long long beta, bool max_node) {
+	SPMinimaxExpansion expansion;
+	SPTransTableEntry* entry = NULL;
+	SP_TRANS_TABLE_BOUND bound;
+	unsigned long long key = 0;
+	long long alpha_orig, beta_orig;
+	int moves[SP_FIAR_GAME_MAX_COLUMNS], count, i, val, best, best_move = -1, first_move = -1, ply, upper, lower;
+	bool mirrored = false;
+
+	// a search out of nodes unwinds without scores
+	if (s->node_limit != 0 && s->nodes >= s->node_limit) {
+		s->aborted = true;
+		return 0;
+	}
+
+	s->nodes++;
+	ply = spArrayListSize(s->game->history);
+
+	// the line of the node is empty until a child becomes its best one
+	if ((void*)(s->pv) != NULL) {
+		s->pv->length[ply - s->root_ply] = 0;
+	}
+
+	// positions without a key (too large a board) aren't cached
+	if (depth > 0 && (void*)(s->table) != NULL &&
+		(key = spTransTableGetKey(s->game, &mirrored)) != 0) {
+		entry = spTransTableProbe(s->table, key);
+	}
+
+	if ((void*)entry != NULL) {
+		// a score of the same depth is the score the tree would give
+		if (entry->depth == (int)depth) {
+			if (entry->bound == SP_TRANS_TABLE_EXACT ||
+				(entry->bound == SP_TRANS_TABLE_LOWER && entry->score >= beta) ||
+				(entry->bound == SP_TRANS_TABLE_UPPER && entry->score <= alpha)) {
+				return entry->score;
+			}
+		}
+
+		if (entry->move != -1) {
+			first_move = mirrored ? s->game->geometry->columns - 1 - entry->move : entry->move;
+		}
+	}
+
+	spGetNodeExpansion(s->game, false, depth, s->player_A_identity, &expansion);
+
+	if (expansion.is_leaf) {
+		return expansion.score_defined ? expansion.score : spCalculateGameScore(s->game, s->player_A_identity);
+	}
+
+	// mate distance pruning: no score beats the fastest win or the slowest loss from here
+	upper = SP_MINIMAX_WIN_SCORE - (max_node ? ply + 1 : ply + 2);
+	lower = -(SP_MINIMAX_WIN_SCORE - (max_node ? ply + 2 : ply + 1));
+
+	if (beta > upper) {
+		beta = upper;
+
+		if (alpha >= beta) {
+			return upper;
+		}
+	}
+
+	if (alpha < lower) {
+		alpha = lower;
+
+		if (alpha >= beta) {
+			return lower;
+		}
+	}
+
+	alpha_orig = alpha;
+	beta_orig = beta;
+	count = getChildrenMoves(s, &expansion, first_move, false, moves);
+	best = max_node ? INT_MIN : INT_MAX;
+
+	for (i = 0; i < count; i++) {
+		spFiarGameSetMove(s->game, moves[i]);
+
+		if (i == 0 || !s->pvs) {
+			val = searchNode(s, depth - 1, alpha, beta, !max_node);
+		}
+
+		// zero window test if the child can beat the best one, search again if it does
+		else if (max_node) {
+			val = searchNode(s, depth - 1, alpha, alpha + 1, false);
+
+			if (val > alpha && val < beta) {
+				val = searchNode(s, depth - 1, alpha, beta, false);
+			}
+		}
+		else {
+			val = searchNode(s, depth - 1, beta - 1, beta, true);
+
+			if (val < beta && val > alpha) {
+				val = searchNode(s, depth - 1, alpha, beta, true);
+			}
+		}
+
+		spFiarGameUndoPrevMove(s->game);
+
+		if (s->aborted) {
+			return 0;
+		}
+
+		if (best_move == -1 || (max_node && val > best) || (!max_node && val < best)) {
+			best = val;
+			best_move = moves[i];
+
+			if ((void*)(s->pv) != NULL) {
+				updatePv(s->pv, ply - s->root_ply, best_move);
+			}
+		}
+
+		if (max_node && best > alpha) {
+			alpha = best;
+		}
+		else if (!max_node && best < beta) {
+			beta = best;
+		}
+
+		if (alpha >= beta) {
+			break;
+		}
+	}
+
+	if ((void*)(s->table) != NULL && key != 0) {
+		if (best <= alpha_orig) {
+			bound = SP_TRANS_TABLE_UPPER;
+		}
+		else if (best >= beta_orig) {
+			bound = SP_TRANS_TABLE_LOWER;
+		}
+		else {
+			bound = SP_TRANS_TABLE_EXACT;
+		}
+
+		spTransTableStore(s->table, key, best, bound, depth,
+			mirrored ? s->game->geometry->columns - 1 - best_move : best_move);
+	}
+
+	return best;
+}
+
+/*
+* Prepares a search of the game and the children moves of its root, in column order.
+*
+* @param s the search to prepare
+* @param game the game
+* @param depth the depth of the search
+* @param table the transposition table
+* @param node_limit the node limit, 0 for none
+* @param moves the array of root moves to fill
+* @return the number of root moves, 0 if the search can't be made
+*/
+static int initSearch(SPSearch* s, SPFiarGame* game, unsigned int depth, SPTransTable* table,
+	unsigned long node_limit, int moves[SP_FIAR_GAME_MAX_COLUMNS]) {
+	SPMinimaxExpansion expansion;
+
+	if ((void*)game == NULL || depth == 0) {
+		return 0;
+	}
+
+	s->game = game;
+	s->table = table;
+	s->nodes = 1;
+	s->node_limit = node_limit;
+	s->aborted = false;
+	s->pvs = true;
+	s->pv = NULL;
+	s->root_ply = spArrayListSize(game->history);
+	s->player_A_identity = spFiarGameGetCurrentPlayer(game) == SP_FIAR_GAME_PLAYER_1_SYMBOL ? Player1 : Player2;
+
+	spGetNodeExpansion(game, true, depth, s->player_A_identity, &expansion);
+
+	if (expansion.is_leaf) {
+		return 0;
+	}
+
+	return getChildrenMoves(s, &expansion, -1, true, moves);
+}
+
+/*
+* Sets the result of a search.
+*
+* @param s the search
+* @param result the result to set, may be NULL
+* @param move the best move
+* @param score the score of the root
+*/
+static void setResult(SPSearch* s, SPMinimaxResult* result, int move, int score) {
+	if (result == NULL) {
+		return;
+	}
+
+	result->move = move;
+	result->score = score;
+	result->nodes = s->nodes;
+	result->degraded = false;
+}
+
+int spMinimaxSearchPvs(SPFiarGame* game, unsigned int maxDepth, SPTransTable* table, unsigned long nodeLimit,
+	SPMinimaxResult* result) {
+	SPSearch s;
+	int moves[SP_FIAR_GAME_MAX_COLUMNS], count, i, val, best = INT_MIN, best_move = -1;
+
+	if ((count = initSearch(&s, game, maxDepth, table, nodeLimit, moves)) == 0) {
+		return -1;
+	}
+
+	// in column order, a child is taken only if it beats the best so far
+	for (i = 0; i < count; i++) {
+		SP_TRACE_BEGIN(root_move);
+		spFiarGameSetMove(game, moves[i]);
+
+		if (i == 0) {
+			val = searchNode(&s, maxDepth - 1, SEARCH_NEG_INF, SEARCH_INF, false);
+		}
+		else {
+			val = searchNode(&s, maxDepth - 1, best, (long long)best + 1, false);
+
+			if (val > best) {
+				val = searchNode(&s, maxDepth - 1, best, SEARCH_INF, false);
+			}
+		}
+
+		spFiarGameUndoPrevMove(game);
+
+		if (s.aborted) {
+			break;
+		}
+
+		if (i == 0 || val > best) {
+			best = val;
+			best_move = moves[i];
+		}
+
+		SP_TRACE_END(root_move, moves[i] + 1);
+	}
+
+	if (s.aborted) {
+		setResult(&s, result, -1, 0);
+		return -1;
+	}
+
+	setResult(&s, result, best_move, best);
+
+	return best_move;
+}
+
+int spMinimaxSearchMtdf(SPFiarGame* game, unsigned int maxDepth, SPTransTable* table, unsigned long nodeLimit,
+	SPMinimaxResult* result) {
+	SPSearch s;
+	int moves[SP_FIAR_GAME_MAX_COLUMNS], count, i, val, g = 0, best_move = -1;
+	long long lower = SEARCH_NEG_INF, upper = SEARCH_INF, beta;
+
+	if ((count = initSearch(&s, game, maxDepth, table, nodeLimit, moves)) == 0) {
+		return -1;
+	}
+
+	s.pvs = false;
+
+	// narrow the bounds of the root score with zero windows until they meet
+	while (lower < upper && !s.aborted) {
+		SP_TRACE_BEGIN(mtdf_pass);
+		beta = (g == lower) ? (long long)g + 1 : g;
+		g = INT_MIN;
+
+		for (i = 0; i < count; i++) {
+			spFiarGameSetMove(game, moves[i]);
+			val = searchNode(&s, maxDepth - 1, beta - 1, beta, false);
+			spFiarGameUndoPrevMove(game);
+
+			if (s.aborted) {
+				break;
+			}
+
+			if (val > g) {
+				g = val;
+			}
+
+			if (g >= beta) {
+				break;
+			}
+		}
+
+		if (g < beta) {
+			upper = g;
+		}
+		else {
+			lower = g;
+		}
+
+		SP_TRACE_END(mtdf_pass, g);
+	}
+
+	// the first child, in column order, that reaches the root score
+	for (i = 0; i < count && best_move == -1 && !s.aborted; i++) {
+		spFiarGameSetMove(game, moves[i]);
+
+		if (searchNode(&s, maxDepth - 1, (long long)g - 1, g, false) >= g) {
+			best_move = moves[i];
+		}
+
+		spFiarGameUndoPrevMove(game);
+	}
+
+	if (s.aborted) {
+		setResult(&s, result, -1, 0);
+		return -1;
+	}
+
+	setResult(&s, result, best_move, g);
+
+	return best_move;
+}
+
+/*
+* Sets a line of a multi-PV search from the principal variation its root move
+* searched, continued by the exact entries of the table where the search took a
+* score from it. The root move must be set in the game.
+*
+* @param s the search
+* @param line the line to set
+* @param move the root move
+* @param score the score of the root move
+* @param depth the depth of the search
+*/
+static void setLine(SPSearch* s, SPMinimaxLine* line, int move, int score, unsigned int depth) {
+	SPTransTableEntry* entry;
+	unsigned long long key;
+	bool mirrored;
+	int i, col, applied = 0;
+
+	line->move = move;
+	line->score = score;
+	line->pv[0] = (signed char)move;
+
+	for (i = 0; i < s->pv->length[1]; i++) {
+		line->pv[i + 1] = s->pv->moves[1][i];
+	}
+
+	line->length = i + 1;
+
+	for (i = 1; i < line->length; i++, applied++) {
+		spFiarGameSetMove(s->game, line->pv[i]);
+	}
+
+	// an exact entry of the same depth holds the best move the search found there
+	while ((unsigned int)line->length < depth && spFiarCheckWinner(s->game) == '\0' &&
+		(key = spTransTableGetKey(s->game, &mirrored)) != 0 &&
+		(void*)(entry = spTransTableProbe(s->table, key)) != NULL &&
+		entry->bound == SP_TRANS_TABLE_EXACT && entry->depth == (int)depth - line->length && entry->move != -1) {
+		col = mirrored ? s->game->geometry->columns - 1 - entry->move : entry->move;
+
+		if (!spFiarGameIsValidMove(s->game, col)) {
+			break;
+		}
+
+		spFiarGameSetMove(s->game, col);
+		applied++;
+		line->pv[line->length++] = (signed char)col;
+	}
+
+	while (applied-- > 0) {
+		spFiarGameUndoPrevMove(s->game);
+	}
+}
+
+int spMinimaxSearchMultiPv(SPFiarGame* game, unsigned int maxDepth, SPTransTable* table, unsigned long nodeLimit,
+	SPMinimaxLine lines[SP_FIAR_GAME_MAX_COLUMNS], SPMinimaxResult* result) {
+	SPSearch s;
+	SPSearchPv pv;
+	int moves[SP_FIAR_GAME_MAX_COLUMNS], mirror[SP_FIAR_GAME_MAX_COLUMNS], root_count, count = 0, col, val, i, j,
+		columns, best = INT_MIN, best_move = -1;
+	bool symmetric;
+
+	if ((root_count = initSearch(&s, game, maxDepth, table, nodeLimit, moves)) == 0) {
+		return -1;
+	}
+
+	s.pv = &pv;
+	columns = game->geometry->columns;
+	symmetric = spFiarGameIsMirrorSymmetric(game);
+
+	// every valid move gets a full window, so its score is exact
+	for (col = 0; col < columns && !s.aborted; col++) {
+		if (!spFiarGameIsValidMove(game, col)) {
+			continue;
+		}
+
+		mirror[columns - 1 - col] = count;
+
+		// in a mirror symmetric position the right half mirrors the left half
+		if (symmetric && col > (columns - 1) / 2) {
+			lines[count] = lines[mirror[col]];
+			lines[count].move = col;
+
+			for (j = 0; j < lines[count].length; j++) {
+				lines[count].pv[j] = (signed char)(columns - 1 - lines[count].pv[j]);
+			}
+
+			count++;
+			continue;
+		}
+
+		SP_TRACE_BEGIN(root_move);
+		spFiarGameSetMove(game, col);
+		val = searchNode(&s, maxDepth - 1, SEARCH_NEG_INF, SEARCH_INF, false);
+
+		if (!s.aborted) {
+			setLine(&s, lines + count, col, val, maxDepth);
+		}
+
+		spFiarGameUndoPrevMove(game);
+		count++;
+		SP_TRACE_END(root_move, col + 1);
+	}
+
+	if (s.aborted) {
+		setResult(&s, result, -1, 0);
+		return -1;
+	}
+
+	// the best move is that of spMinimaxSearchPvs, among the moves its root searches
+	for (i = 0; i < count; i++) {
+		for (j = 0; j < root_count && moves[j] != lines[i].move; j++);
+
+		if (j < root_count && (best_move == -1 || lines[i].score > best)) {
+			best = lines[i].score;
+			best_move = lines[i].move;
+		}
+	}
+
+	setResult(&s, result, best_move, best);
+
+	return count;
+}
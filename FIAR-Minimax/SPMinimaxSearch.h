@@ -0,0 +1,122 @@
+#ifndef SPMINIMAXSEARCH_H_
+#define SPMINIMAXSEARCH_H_
+
+#include "SPFIARGame.h"
+#include "SPTransTable.h"
+
+// the longest principal variation, the moves of a full board
+#define SP_MINIMAX_MAX_PV (SP_FIAR_GAME_MAX_ROWS * SP_FIAR_GAME_MAX_COLUMNS)
+
+/**
+ * SPMinimaxSearch Summary:
+ *
+ * Depth first alpha-beta searches over the same minimax tree spMinimaxTreeBuild
+ * builds (the nodes are expanded by spGetNodeExpansion and the leaves are scored
+ * by spCalculateGameScore), without allocating the tree. Both searches return the
+ * score and the move the full tree gives: the first column, in column order,
+ * whose score equals the root score.
+ *
+ * Wins are scored by their distance (see spGetWinScore), so a node can't score
+ * better than a win with its next move or worse than a loss right after it. The
+ * search window of a node is narrowed to these bounds (mate distance pruning),
+ * which cuts every line that can't beat a faster win already found.
+ *
+ * Scores are cached in a transposition table, if one is given. An entry is used
+ * for a cutoff only if it was found with the same remaining depth, so the cache
+ * never changes a score; entries of other depths still order the moves.
+ *
+ * A search may be given a node limit. It then stops as soon as it has visited
+ * that many nodes, without a result, so its cost is bounded whatever the position.
+ *
+ * A multi-PV search scores every root move instead of finding the best one: each
+ * is searched with a full window, so its score is exact, and with its principal
+ * variation, the line both players play from it. The root moves share the table,
+ * so a position reached by several of them is searched once.
+ *
+ * spMinimaxSearchPvs      - Principal variation search, zero windows after the first child
+ * spMinimaxSearchMtdf     - MTD(f), a sequence of zero window searches of the root
+ * spMinimaxSearchMultiPv  - Exact scores and principal variations of all root moves
+ */
+
+/**
+ * The outcome of a search
+ */
+typedef struct sp_minimax_result_t {
+	int move;            // the best move, -1 if there is none
+	int score;           // the score of the root for the player to move
+	unsigned long nodes; // the number of visited (or created) nodes
+	bool degraded;       // the search was cut down to fit its memory, see SPMinimaxConfig
+} SPMinimaxResult;
+
+/**
+ * A root move of a multi-PV search
+ */
+typedef struct sp_minimax_line_t {
+	int move;                          // the root move
+	int score;                         // its exact score for the player to move at the root
+	int length;                        // the number of moves of the principal variation
+	signed char pv[SP_MINIMAX_MAX_PV]; // the principal variation, starting with the root move
+} SPMinimaxLine;
+
+/**
+ * Runs a principal variation search of the specified game. The game must have
+ * room for maxDepth moves in its history, it is restored when the search ends.
+ *
+ * @param game - the game to search, the player to move is player A
+ * @param maxDepth - the depth of the search
+ * @param table - the transposition table, may be NULL
+ * @param nodeLimit - the maximal number of nodes to visit, 0 for no limit
+ * @param result - if not NULL, set to the outcome of the search. If the node
+ *                 limit is reached, the move is -1 and the nodes are those visited.
+ * @return
+ * -1 if either game is NULL, maxDepth == 0, the game is over or the node limit
+ * is reached. Otherwise, the best move for the player to move.
+ */
+int spMinimaxSearchPvs(SPFiarGame* game, unsigned int maxDepth, SPTransTable* table, unsigned long nodeLimit,
+	SPMinimaxResult* result);
+
+/**
+ * Runs an MTD(f) search of the specified game: the root score is found by zero
+ * window searches only, which rely on the transposition table to not search the
+ * same nodes again. The game must have room for maxDepth moves in its history,
+ * it is restored when the search ends.
+ *
+ * @param game - the game to search, the player to move is player A
+ * @param maxDepth - the depth of the search
+ * @param table - the transposition table, may be NULL (correct but slow)
+ * @param nodeLimit - the maximal number of nodes to visit, 0 for no limit
+ * @param result - if not NULL, set to the outcome of the search. If the node
+ *                 limit is reached, the move is -1 and the nodes are those visited.
+ * @return
+ * -1 if either game is NULL, maxDepth == 0, the game is over or the node limit
+ * is reached. Otherwise, the best move for the player to move.
+ */
+int spMinimaxSearchMtdf(SPFiarGame* game, unsigned int maxDepth, SPTransTable* table, unsigned long nodeLimit,
+	SPMinimaxResult* result);
+
+/**
+ * Runs a multi-PV search of the specified game: every valid move gets its exact
+ * score and principal variation, from a single search sharing the table. The
+ * score of a move is the score spMinimaxSearchPvs would give the root if that
+ * move were the only one. The moves a forced block or a mirror symmetric board
+ * spares the other searches are scored too, the mirror ones by mirroring. A principal variation ends at the depth of the search,
+ * at the end of the game, or where the search took a score from the table and
+ * the table no longer has the rest of the line. The game must have room for
+ * maxDepth moves in its history, it is restored when the search ends.
+ *
+ * @param game - the game to search, the player to move is player A
+ * @param maxDepth - the depth of the search
+ * @param table - the transposition table, may be NULL
+ * @param nodeLimit - the maximal number of nodes to visit, 0 for no limit
+ * @param lines - set to the valid moves, in column order
+ * @param result - if not NULL, set to the outcome of the search, as that of
+ *                 spMinimaxSearchPvs: the best move is the first column with the
+ *                 best score.
+ * @return
+ * -1 if either game is NULL, maxDepth == 0, the game is over or the node limit
+ * is reached. Otherwise, the number of valid moves.
+ */
+int spMinimaxSearchMultiPv(SPFiarGame* game, unsigned int maxDepth, SPTransTable* table, unsigned long nodeLimit,
+	SPMinimaxLine lines[SP_FIAR_GAME_MAX_COLUMNS], SPMinimaxResult* result);
+
+#endif
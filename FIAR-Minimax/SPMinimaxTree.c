@@ -0,0 +1,236 @@
+#include "SPMinimaxTree.h"
+#include <stdlib.h>
+
+/*
+* Grows the arrays of a tree to a capacity. An array already grown stays so when
+* another one fails, the capacity of the tree only changes on success.
+* @param tree the tree
+* @param capacity the new capacity, larger than the current one
+* @return true on success, false if an allocation failure occurred
+*/
+static bool growTree(SPMinimaxTree* tree, unsigned int capacity) {
+	void* arrays[5];
+
+	if ((arrays[0] = realloc(tree->scores, capacity * sizeof(int))) != NULL) {
+		tree->scores = (int*)arrays[0];
+	}
+
+	if ((arrays[1] = realloc(tree->first_child, capacity * sizeof(unsigned int))) != NULL) {
+		tree->first_child = (unsigned int*)arrays[1];
+	}
+
+	if ((arrays[2] = realloc(tree->child_count, capacity)) != NULL) {
+		tree->child_count = (unsigned char*)arrays[2];
+	}
+
+	if ((arrays[3] = realloc(tree->moves, capacity)) != NULL) {
+		tree->moves = (signed char*)arrays[3];
+	}
+
+	if ((arrays[4] = realloc(tree->flags, capacity)) != NULL) {
+		tree->flags = (unsigned char*)arrays[4];
+	}
+
+	if (arrays[0] == NULL || arrays[1] == NULL || arrays[2] == NULL || arrays[3] == NULL || arrays[4] == NULL) {
+		return false;
+	}
+
+	tree->capacity = capacity;
+
+	return true;
+}
+
+/*
+* Appends nodes to a tree, growing its arrays if needed.
+* @param tree the tree
+* @param count the number of nodes
+* @return the index of the first node, 0 if an allocation failure occurred
+*         (the root is the only node at 0 and is never appended to a tree with nodes)
+*/
+static unsigned int appendNodes(SPMinimaxTree* tree, unsigned int count) {
+	unsigned int capacity = tree->capacity, first;
+
+	while (capacity - tree->size < count) {
+		if (capacity > UINT_MAX / 2) {
+			return 0;
+		}
+
+		capacity *= 2;
+	}
+
+	if (capacity != tree->capacity && !growTree(tree, capacity)) {
+		return 0;
+	}
+
+	first = tree->size;
+	tree->size += count;
+
+	return first;
+}
+
+SPMinimaxTree* spMinimaxTreeCreate(unsigned int capacity, SP_PlayerA player_A_identity) {
+	SPMinimaxTree* tree;
+
+	if (capacity == 0) {
+		return NULL;
+	}
+
+	tree = (SPMinimaxTree*)calloc(1, sizeof(SPMinimaxTree));
+
+	if ((void*)tree == NULL) {
+		return NULL;
+	}
+
+	tree->player_A_identity = player_A_identity;
+
+	if (!growTree(tree, capacity)) {
+		spMinimaxTreeDestroy(tree);
+		return NULL;
+	}
+
+	return tree;
+}
+
+void spMinimaxTreeDestroy(SPMinimaxTree* tree) {
+	if ((void*)tree == NULL) {
+		return;
+	}
+
+	free(tree->scores);
+	free(tree->first_child);
+	free(tree->child_count);
+	free(tree->moves);
+	free(tree->flags);
+	free(tree);
+}
+
+/*
+* Builds the subtree of a node, whose move is set in the game. The children of a
+* node are appended together, then their subtrees are built one after the other.
+* @param tree the tree
+* @param node the index of the node
+* @param game the game
+* @param depth the depth left for the node
+* @param is_root true iff the node is the root
+* @return SP_MINIMAX_NODE_MEM_ERR if an allocation failed, SP_MINIMAX_NODE_SUCCESS otherwise
+*/
+static SP_MINIMAX_NODE_MESSAGE buildNode(SPMinimaxTree* tree, unsigned int node, SPFiarGame* game,
+	unsigned int depth, bool is_root) {
+	SPMinimaxExpansion expansion;
+	SP_MINIMAX_NODE_MESSAGE msg = SP_MINIMAX_NODE_SUCCESS;
+	unsigned int first, count = 0, i;
+	unsigned char child_flags;
+	int col;
+
+	spGetNodeExpansion(game, is_root, depth, tree->player_A_identity, &expansion);
+
+	// a leaf is scored in its position, a proven one already has its score
+	if (expansion.is_leaf) {
+		if (expansion.score_defined) {
+			tree->scores[node] = expansion.score;
+			tree->flags[node] |= SP_MINIMAX_TREE_PROVEN_LEAF;
+		}
+		else {
+			tree->scores[node] = spCalculateGameScore(game, tree->player_A_identity);
+		}
+
+		return SP_MINIMAX_NODE_SUCCESS;
+	}
+
+	for (col = expansion.first_col; col <= expansion.last_col; col++) {
+		if (spFiarGameIsValidMove(game, col)) {
+			count++;
+		}
+	}
+
+	if ((first = appendNodes(tree, count)) == 0) {
+		return SP_MINIMAX_NODE_MEM_ERR;
+	}
+
+	tree->first_child[node] = first;
+	tree->child_count[node] = (unsigned char)count;
+	child_flags = (tree->flags[node] & SP_MINIMAX_TREE_MAX_NODE) ? 0 : SP_MINIMAX_TREE_MAX_NODE;
+
+	for (col = expansion.first_col, i = first; col <= expansion.last_col; col++) {
+		if (spFiarGameIsValidMove(game, col)) {
+			tree->moves[i] = (signed char)col;
+			tree->flags[i] = child_flags;
+			tree->child_count[i] = 0;
+			i++;
+		}
+	}
+
+	for (i = first; i < first + count && msg == SP_MINIMAX_NODE_SUCCESS; i++) {
+		spFiarGameSetMove(game, tree->moves[i]);
+		msg = buildNode(tree, i, game, depth - 1, false);
+		spFiarGameUndoPrevMove(game);
+	}
+
+	return msg;
+}
+
+SP_MINIMAX_NODE_MESSAGE spMinimaxTreeBuild(SPMinimaxTree* tree, SPFiarGame* game, unsigned int depth) {
+	if ((void*)tree == NULL || (void*)game == NULL || tree->size != 0 || depth == 0) {
+		return SP_MINIMAX_NODE_INVALID_ARGUMENT;
+	}
+
+	tree->size = 1;
+	tree->moves[0] = ROOT_NO_MOVE;
+	tree->flags[0] = SP_MINIMAX_TREE_MAX_NODE;
+	tree->child_count[0] = 0;
+
+	return buildNode(tree, 0, game, depth, true);
+}
+
+int spMinimaxTreeScore(SPMinimaxTree* tree) {
+	unsigned int node, i, end;
+	int score;
+
+	if ((void*)tree == NULL || tree->size == 0) {
+		return 0;
+	}
+
+	// the children come after their parent, so a backward sweep meets them first
+	for (node = tree->size; node-- > 0;) {
+		if (tree->child_count[node] == 0) {
+			continue;
+		}
+
+		i = tree->first_child[node];
+		end = i + tree->child_count[node];
+		score = tree->scores[i];
+
+		if (tree->flags[node] & SP_MINIMAX_TREE_MAX_NODE) {
+			for (i++; i < end; i++) {
+				if (tree->scores[i] > score) {
+					score = tree->scores[i];
+				}
+			}
+		}
+		else {
+			for (i++; i < end; i++) {
+				if (tree->scores[i] < score) {
+					score = tree->scores[i];
+				}
+			}
+		}
+
+		tree->scores[node] = score;
+	}
+
+	return tree->scores[0];
+}
+
+int spMinimaxTreeBestMove(SPMinimaxTree* tree) {
+	unsigned int i, end;
+
+	if ((void*)tree == NULL || tree->size == 0 || tree->child_count[0] == 0) {
+		return -1;
+	}
+
+	end = tree->first_child[0] + tree->child_count[0];
+
+	for (i = tree->first_child[0]; i < end && tree->scores[i] != tree->scores[0]; i++);
+
+	return tree->moves[i];
+}
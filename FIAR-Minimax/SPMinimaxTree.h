@@ -0,0 +1,100 @@
+#ifndef SPMINIMAXTREE_H_
+#define SPMINIMAXTREE_H_
+#include <stdbool.h>
+#include "SPFIARGame.h"
+#include "SPMinimaxNode.h"
+
+// the nodes of a new tree, the pool doubles when it is full
+#define SP_MINIMAX_TREE_INITIAL_CAPACITY 1024
+// the bytes of a node in the pool, over all of its arrays
+#define SP_MINIMAX_TREE_NODE_BYTES (2 * sizeof(int) + 3 * sizeof(char))
+// the flags of a node
+#define SP_MINIMAX_TREE_MAX_NODE 0x1      // player A is to move
+#define SP_MINIMAX_TREE_PROVEN_LEAF 0x2   // a leaf whose score spGetNodeExpansion proved
+
+/**
+ * SPMinimaxTree Summary:
+ *
+ * The minimax tree of the plain search, kept in a contiguous pool: the nodes are
+ * expanded by spGetNodeExpansion and the leaves are scored by spCalculateGameScore.
+ * The pool is a struct of arrays indexed by node: the score, the index of the
+ * first child, the number of children, the move and the flags, 11 bytes per
+ * node. The children of a node are consecutive, so a node needs no
+ * pointers, and every child comes after its parent. The root is node 0.
+ *
+ * The leaves are scored while the tree is built, in the position they stand for,
+ * and the inner nodes are then scored by a single sweep of the arrays from the
+ * last node to the first, without the game.
+ *
+ * spMinimaxTreeCreate    - Creates an empty tree
+ * spMinimaxTreeDestroy   - Frees all memory resources associated with a tree
+ * spMinimaxTreeBuild     - Builds the tree of a game to a depth
+ * spMinimaxTreeScore     - Scores the inner nodes of a tree
+ * spMinimaxTreeBestMove  - Returns the best move of the root
+ */
+
+typedef struct sp_minimax_tree_t {
+	int* scores;                 // the scores for player A, those of inner nodes set by spMinimaxTreeScore
+	unsigned int* first_child;   // the index of the first child
+	unsigned char* child_count;  // 0 for a leaf
+	signed char* moves;          // the move of the node, ROOT_NO_MOVE for the root
+	unsigned char* flags;        // SP_MINIMAX_TREE_MAX_NODE | SP_MINIMAX_TREE_PROVEN_LEAF
+	unsigned int size;           // the number of nodes
+	unsigned int capacity;       // the nodes the arrays have room for
+	SP_PlayerA player_A_identity;
+} SPMinimaxTree;
+
+/**
+ * Creates an empty tree.
+ *
+ * @param capacity - the nodes to allocate room for, more are allocated as needed
+ * @param player_A_identity - the identity of player A, the player to move at the root
+ * @return
+ * NULL if either a memory allocation failure occurs or capacity == 0.
+ * Otherwise, a new empty tree.
+ */
+SPMinimaxTree* spMinimaxTreeCreate(unsigned int capacity, SP_PlayerA player_A_identity);
+
+/**
+ * Frees all memory resources associated with a tree. If tree == NULL nothing happens.
+ *
+ * @param tree - the tree
+ */
+void spMinimaxTreeDestroy(SPMinimaxTree* tree);
+
+/**
+ * Builds the tree of a game to a depth into an empty tree: the children of a node
+ * are those spGetNodeExpansion gives it, in column order. The leaves get their
+ * scores.
+ *
+ * @param tree - the tree, empty
+ * @param game - the root game, restored when the function returns
+ * @param depth - the depth of the tree
+ * @return
+ * SP_MINIMAX_NODE_INVALID_ARGUMENT if tree or game is NULL, the tree isn't empty or depth == 0
+ * SP_MINIMAX_NODE_MEM_ERR if an allocation fails, the tree keeps the nodes built so far
+ * SP_MINIMAX_NODE_SUCCESS otherwise
+ */
+SP_MINIMAX_NODE_MESSAGE spMinimaxTreeBuild(SPMinimaxTree* tree, SPFiarGame* game, unsigned int depth);
+
+/**
+ * Scores the inner nodes of a built tree, the maximum of the children of a max
+ * node and the minimum of those of a min node.
+ *
+ * @param tree - the tree
+ * @return
+ * 0 if tree is NULL or empty, the score of the root otherwise
+ */
+int spMinimaxTreeScore(SPMinimaxTree* tree);
+
+/**
+ * Returns the best move of the root of a scored tree: the first column whose
+ * child has the score of the root.
+ *
+ * @param tree - the tree
+ * @return
+ * -1 if tree is NULL or the root has no children, the best move otherwise
+ */
+int spMinimaxTreeBestMove(SPMinimaxTree* tree);
+
+#endif
@@ -0,0 +1,266 @@
+#define _POSIX_C_SOURCE 200112L
+#include "SPPerft.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SPFIARGame.h"
+#include "SPFIARParser.h"
+#include "SPFIARCodec.h"
+#include "SPThreadPool.h"
+
+#define PERFT_HISTORY_SIZE SP_FIAR_CODEC_MAX_MOVES
+// the subtrees of a split, at most columns ^ PERFT_SPLIT_DEPTH
+#define PERFT_MAX_TASKS (SP_FIAR_GAME_MAX_COLUMNS * SP_FIAR_GAME_MAX_COLUMNS)
+
+/*
+* The counts of the move sequences of the empty boards, by geometry and depth,
+* 0 where unknown. Computed by an independent implementation.
+*/
+static const unsigned long long KNOWN_COUNTS[SP_FIAR_N_GEOMETRIES][PERFT_MAX_KNOWN_DEPTH + 1] = {
+	// 7x6
+	{ 1ULL, 7ULL, 49ULL, 343ULL, 2401ULL, 16807ULL, 117649ULL, 823536ULL, 5673234ULL, 39394572ULL, 268031646ULL },
+	// 8x7
+	{ 1ULL, 8ULL, 64ULL, 512ULL, 4096ULL, 32768ULL, 262144ULL, 2097152ULL, 16553656ULL, 131465088ULL, 0ULL },
+	// 9x7
+	{ 1ULL, 9ULL, 81ULL, 729ULL, 6561ULL, 59049ULL, 531441ULL, 4782969ULL, 42569784ULL, 380622960ULL, 3348524340ULL },
+	// connect5
+	{ 1ULL, 9ULL, 81ULL, 729ULL, 6561ULL, 59049ULL, 531441ULL, 4782960ULL, 43046136ULL, 387399096ULL, 3476801016ULL }
+};
+
+/*
+* A subtree of a split: the moves to its root and its count.
+*/
+typedef struct sp_perft_task_t {
+	SPFiarGame* base;          // the position of the count, shared and not changed
+	int moves[PERFT_SPLIT_DEPTH];
+	int n_moves;
+	int depth;                 // the depth left after the moves
+	bool bulk;
+	unsigned long long count;
+	bool failed;
+} SPPerftTask;
+
+/*
+* Counts the move sequences of a length from a position.
+* @param game the position, restored on return
+* @param depth the length
+* @param bulk whether the moves of the last ply are counted without being made
+* @return the count
+*/
+static unsigned long long perft(SPFiarGame* game, int depth, bool bulk) {
+	unsigned long long count = 0;
+	int col;
+
+	if (depth == 0) {
+		return 1;
+	}
+
+	// a finished game has no moves
+	if (spFiarCheckWinner(game) != '\0') {
+		return 0;
+	}
+
+	for (col = 0; col < game->geometry->columns; col++) {
+		if (!spFiarGameIsValidMove(game, col)) {
+			continue;
+		}
+
+		if (bulk && depth == 1) {
+			count++;
+			continue;
+		}
+
+		spFiarGameSetMove(game, col);
+		count += perft(game, depth - 1, bulk);
+		spFiarGameUndoPrevMove(game);
+	}
+
+	return count;
+}
+
+/*
+* Lists the subtrees after the first plies of a position, as perft walks them.
+* @param game the position, restored on return
+* @param task the task of the current moves, copied into the list at a root
+* @param ply the number of moves made
+* @param plies the plies of the split
+* @param tasks the list
+* @param n_tasks the length of the list, updated
+*/
+static void listTasks(SPFiarGame* game, SPPerftTask* task, int ply, int plies, SPPerftTask* tasks, int* n_tasks) {
+	int col;
+
+	if (ply == plies) {
+		task->n_moves = ply;
+		tasks[(*n_tasks)++] = *task;
+		return;
+	}
+
+	if (spFiarCheckWinner(game) != '\0') {
+		return;
+	}
+
+	for (col = 0; col < game->geometry->columns; col++) {
+		if (spFiarGameIsValidMove(game, col)) {
+			task->moves[ply] = col;
+			spFiarGameSetMove(game, col);
+			listTasks(game, task, ply + 1, plies, tasks, n_tasks);
+			spFiarGameUndoPrevMove(game);
+		}
+	}
+}
+
+/*
+* Counts a subtree on a copy of its position. A task.
+* @param arg the task
+*/
+static void runTask(void* arg) {
+	SPPerftTask* task = (SPPerftTask*)arg;
+	SPFiarGame* game;
+	int i;
+
+	if ((game = spFiarGameCopy(task->base)) == NULL) {
+		task->failed = true;
+		return;
+	}
+
+	for (i = 0; i < task->n_moves; i++) {
+		spFiarGameSetMove(game, task->moves[i]);
+	}
+
+	task->count = perft(game, task->depth, task->bulk);
+	spFiarGameDestroy(game);
+}
+
+/*
+* Counts the move sequences of a length, split among the threads of a pool.
+* @param game the position, not changed
+* @param depth the length
+* @param bulk whether the moves of the last ply are counted without being made
+* @param pool the pool
+* @param divide whether to print the counts of the first moves
+* @param count set to the count on success
+* @return true on success, false on a memory allocation failure
+*/
+static bool countSplit(SPFiarGame* game, int depth, bool bulk, SPThreadPool* pool, bool divide,
+	unsigned long long* count) {
+	SPPerftTask tasks[PERFT_MAX_TASKS], task;
+	unsigned long long move_count = 0;
+	int plies = depth < PERFT_SPLIT_DEPTH ? depth : PERFT_SPLIT_DEPTH, n_tasks = 0, i;
+	bool succeeded = true;
+
+	task.base = game;
+	task.depth = depth - plies;
+	task.bulk = bulk;
+	task.count = 0;
+	task.failed = false;
+	listTasks(game, &task, 0, plies, tasks, &n_tasks);
+
+	for (i = 0; i < n_tasks; i++) {
+		spThreadPoolSubmit(pool, runTask, tasks + i);
+	}
+
+	spThreadPoolWait(pool);
+	*count = 0;
+
+	for (i = 0; i < n_tasks; i++) {
+		succeeded = succeeded && !tasks[i].failed;
+		*count += tasks[i].count;
+		move_count += tasks[i].count;
+
+		// the tasks of a first move are adjacent
+		if (divide && (i + 1 == n_tasks || tasks[i + 1].moves[0] != tasks[i].moves[0])) {
+			printf("  %d: %llu\n", tasks[i].moves[0] + 1, move_count);
+			move_count = 0;
+		}
+	}
+
+	return succeeded;
+}
+
+int spPerftMain(int argc, char* argv[]) {
+	const SPFiarGeometry* geometry = spFiarGeometryGet(SP_FIAR_GEOMETRY_DEFAULT);
+	const char* moves = "";
+	struct timespec start, end;
+	unsigned long long count, known;
+	SPThreadPool* pool;
+	SPFiarGame* game;
+	int depth, max_depth, threads = 0, i = 2;
+	bool bulk = true, divide = false, valid = argc >= 2 && spParserIsInt(argv[1]) && atoi(argv[1]) > 0, matched = true;
+	double ms;
+
+	if (valid && argc > 2 && strncmp(argv[2], "--", 2) != 0) {
+		moves = argv[2];
+		i = 3;
+	}
+
+	for (; i < argc && valid; i++) {
+		if (strcmp(argv[i], PERFT_DIVIDE_OPTION) == 0) {
+			divide = true;
+		}
+		else if (strcmp(argv[i], PERFT_NO_BULK_OPTION) == 0) {
+			bulk = false;
+		}
+		else if (i + 1 == argc) {
+			valid = false;
+		}
+		else if (strcmp(argv[i], PERFT_THREADS_OPTION) == 0 && spParserIsInt(argv[i + 1]) && atoi(argv[i + 1]) > 0) {
+			threads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], PERFT_GEOMETRY_OPTION) == 0) {
+			valid = (geometry = spFiarGeometryFind(argv[++i])) != NULL;
+		}
+		else {
+			valid = false;
+		}
+	}
+
+	if (!valid) {
+		printf("Usage: %s <depth> [<moves>] [%s <n>] [%s] [%s] [%s 7x6|8x7|9x7|connect5]\n", argv[0],
+			PERFT_THREADS_OPTION, PERFT_DIVIDE_OPTION, PERFT_NO_BULK_OPTION, PERFT_GEOMETRY_OPTION);
+		return 1;
+	}
+
+	if ((game = spFiarCodecDecodeMoves(moves, geometry, PERFT_HISTORY_SIZE)) == NULL) {
+		printf("Error: invalid position %s\n", moves);
+		return 1;
+	}
+
+	if ((pool = spThreadPoolCreate(threads, PERFT_MAX_TASKS)) == NULL) {
+		printf("Error: malloc has failed\n");
+		spFiarGameDestroy(game);
+		return 1;
+	}
+
+	max_depth = atoi(argv[1]);
+	printf("geometry %s position %s threads %d%s\n", geometry->name, moves[0] == '\0' ? "start" : moves,
+		pool->n_threads, bulk ? "" : " no-bulk");
+	printf("%5s %16s %10s %10s %s\n", "depth", "count", "ms", "M/s", "known");
+
+	for (depth = 1; depth <= max_depth && valid; depth++) {
+		if (divide && depth == max_depth) {
+			printf("divide %d\n", depth);
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		valid = countSplit(game, depth, bulk, pool, divide && depth == max_depth, &count);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		if (!valid) {
+			printf("Error: malloc has failed\n");
+			break;
+		}
+
+		ms = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1000000.0;
+		known = moves[0] == '\0' && depth <= PERFT_MAX_KNOWN_DEPTH ? KNOWN_COUNTS[geometry->id][depth] : 0;
+		matched = matched && (known == 0 || known == count);
+		printf("%5d %16llu %10.2f %10.2f %s\n", depth, count, ms, ms > 0 ? count / ms / 1000.0 : 0.0,
+			known == 0 ? "-" : (known == count ? "ok" : "MISMATCH"));
+	}
+
+	spThreadPoolDestroy(pool);
+	spFiarGameDestroy(game);
+
+	return valid && matched ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+#ifndef SPPERFT_H_
+#define SPPERFT_H_
+
+#define PERFT_COMMAND "perft"
+#define PERFT_THREADS_OPTION "--threads"
+#define PERFT_GEOMETRY_OPTION "--geometry"
+#define PERFT_DIVIDE_OPTION "--divide"
+#define PERFT_NO_BULK_OPTION "--no-bulk"
+// the plies played before the tree is split among the threads
+#define PERFT_SPLIT_DEPTH 2
+// the depths of the known counts of the empty boards
+#define PERFT_MAX_KNOWN_DEPTH 10
+
+/**
+ * SPPerft Summary:
+ *
+ * A benchmark and test of the move and win check layer of the game, without any
+ * evaluation: it counts the move sequences of a length from a position. A sequence
+ * ends at a win or a full board, so a game that ended before the length counts
+ * for nothing. The moves are made and undone with spFiarGameSetMove and
+ * spFiarGameUndoPrevMove on a single game, spFiarCheckWinner is the terminal test.
+ *
+ * With bulk counting, the default, the moves of the last ply are counted without
+ * being made. The subtrees after the first plies are counted by a thread pool,
+ * and the counts of the empty boards are checked against known counts.
+ *
+ * spPerftMain  - Runs the counter
+ */
+
+/**
+ * Runs the counter. Usage: perft <depth> [<moves>] [--threads <n>] [--divide]
+ * [--no-bulk] [--geometry <7x6|8x7|9x7|connect5>]
+ * The position is a move string (see SPFIARCodec.h), the empty board by default.
+ * Prints the count, time and speed of every depth up to the given one and
+ * whether a known count matches. --divide prints the counts of the first moves
+ * of the last depth.
+ *
+ * @param argc - the number of arguments, including the command name
+ * @param argv - the arguments, argv[0] is the command name
+ * @return
+ * 0 on success, 1 if the arguments are invalid, a count doesn't match its known
+ * one or a memory allocation failure occurred
+ */
+int spPerftMain(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,779 @@
+#define _POSIX_C_SOURCE 200112L
+#include "SPPositionIndex.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "SPFIARCodec.h"
+
+#define INITIAL_CAPACITY 1024
+// the items of a spilled run that the merge reads at a time
+#define RUN_BUFFER_ITEMS 4096
+
+/*
+* A position of a game, before the positions are grouped by key.
+*/
+typedef struct sp_index_item_t {
+	uint64_t key;
+	uint32_t game;
+	uint32_t result;
+} SPIndexItem;
+
+/*
+* A run of items sorted by key and game number, read by the merge: spilled to a
+* temporary file, or the last items of a worker in memory.
+*/
+typedef struct sp_index_run_t {
+	FILE* file;         // the temporary file of a spilled run, NULL for a run in memory
+	size_t unread;      // the items of the file not read yet
+	SPIndexItem* items; // the items read from the file, or all items of a run in memory
+	size_t head;        // the next item of items
+	size_t size;        // the number of items
+} SPIndexRun;
+
+/*
+* The work of a thread: every step-th game starting at a first one, and the
+* sorted items of their positions. Past max_items, the items are sorted and
+* spilled to a run in a temporary file.
+*/
+typedef struct sp_index_worker_t {
+	const SPGameRecord* records;
+	unsigned long n_records;
+	unsigned long first;
+	unsigned long step;
+	const SPFiarGeometry* geometry;
+	SPIndexItem* items;
+	size_t n_items;
+	size_t capacity;
+	size_t max_items;
+	SPIndexRun* runs;   // the spilled runs, in the order of their games
+	int n_runs;
+	size_t n_spilled;   // the items of all spilled runs
+	SP_POSITION_INDEX_MESSAGE msg;
+} SPIndexWorker;
+
+/*
+* Compares two items by key, then by game number.
+*/
+static int compareItems(const void* a, const void* b) {
+	const SPIndexItem *x = (const SPIndexItem*)a, *y = (const SPIndexItem*)b;
+
+	if (x->key != y->key) {
+		return x->key < y->key ? -1 : 1;
+	}
+
+	return (x->game > y->game) - (x->game < y->game);
+}
+
+/*
+* Sorts items by key, keeping the order of the items of a key. A radix sort
+* of the key bytes, the bytes that are the same in all keys are skipped.
+*
+* @param items the items
+* @param n_items the number of items
+* @return false iff a memory allocation failure occurred
+*/
+static bool sortItems(SPIndexItem* items, size_t n_items) {
+	size_t counts[256], i, sum, count;
+	SPIndexItem *buffer, *from = items, *to, *swap;
+	int shift, b;
+
+	if (n_items < 2) {
+		return true;
+	}
+
+	if ((buffer = (SPIndexItem*)malloc(n_items * sizeof(SPIndexItem))) == NULL) {
+		return false;
+	}
+
+	to = buffer;
+
+	for (shift = 0; shift < 64; shift += 8) {
+		memset(counts, 0, sizeof(counts));
+
+		for (i = 0; i < n_items; i++) {
+			counts[(from[i].key >> shift) & 0xFF]++;
+		}
+
+		if (counts[(from[0].key >> shift) & 0xFF] == n_items) {
+			continue;
+		}
+
+		for (sum = 0, b = 0; b < 256; b++) {
+			count = counts[b];
+			counts[b] = sum;
+			sum += count;
+		}
+
+		for (i = 0; i < n_items; i++) {
+			to[counts[(from[i].key >> shift) & 0xFF]++] = from[i];
+		}
+
+		swap = from;
+		from = to;
+		to = swap;
+	}
+
+	if (from != items) {
+		memcpy(items, from, n_items * sizeof(SPIndexItem));
+	}
+
+	free(buffer);
+
+	return true;
+}
+
+/*
+* Sorts the items of a worker and spills them to a new run in a temporary file.
+* Assumes worker is not null.
+*
+* @param worker the worker
+* @return the status of the spill
+*/
+static SP_POSITION_INDEX_MESSAGE spillItems(SPIndexWorker* worker) {
+	SPIndexRun* runs;
+	SPIndexRun* run;
+
+	if (!sortItems(worker->items, worker->n_items) ||
+		(runs = (SPIndexRun*)realloc(worker->runs, (worker->n_runs + 1) * sizeof(SPIndexRun))) == NULL) {
+		return SP_POSITION_INDEX_MEMORY_ERROR;
+	}
+
+	worker->runs = runs;
+	run = runs + worker->n_runs;
+	memset(run, 0, sizeof(SPIndexRun));
+
+	if ((run->file = tmpfile()) == NULL) {
+		return SP_POSITION_INDEX_IO_ERROR;
+	}
+
+	// the run is the worker's from now on, its file is closed with the worker
+	worker->n_runs++;
+	run->unread = worker->n_items;
+
+	if (fwrite(worker->items, sizeof(SPIndexItem), worker->n_items, run->file) != worker->n_items) {
+		return SP_POSITION_INDEX_IO_ERROR;
+	}
+
+	worker->n_spilled += worker->n_items;
+	worker->n_items = 0;
+
+	return SP_POSITION_INDEX_SUCCESS;
+}
+
+/*
+* Appends an item to the items of a worker, spilling them first if there are
+* max_items of them.
+* Assumes worker is not null.
+*
+* @param worker the worker
+* @param key the key of the position
+* @param game the game number
+* @param result the result of the game
+* @return the status of the append
+*/
+static SP_POSITION_INDEX_MESSAGE addItem(SPIndexWorker* worker, uint64_t key, uint32_t game, uint32_t result) {
+	SP_POSITION_INDEX_MESSAGE msg;
+	SPIndexItem* items;
+	size_t capacity;
+
+	if (worker->n_items == worker->max_items && (msg = spillItems(worker)) != SP_POSITION_INDEX_SUCCESS) {
+		return msg;
+	}
+
+	if (worker->n_items == worker->capacity) {
+		capacity = 2 * worker->capacity < worker->max_items ? 2 * worker->capacity : worker->max_items;
+
+		if ((items = (SPIndexItem*)realloc(worker->items, capacity * sizeof(SPIndexItem))) == NULL) {
+			return SP_POSITION_INDEX_MEMORY_ERROR;
+		}
+
+		worker->items = items;
+		worker->capacity = capacity;
+	}
+
+	worker->items[worker->n_items].key = key;
+	worker->items[worker->n_items].game = game;
+	worker->items[worker->n_items].result = result;
+	worker->n_items++;
+
+	return SP_POSITION_INDEX_SUCCESS;
+}
+
+/*
+* Replays the games of a worker, collects the keys of all of their positions
+* and sorts them. The thread routine of the build.
+*
+* @param arg the worker
+* @return NULL
+*/
+static void* runWorker(void* arg) {
+	SPIndexWorker* worker = (SPIndexWorker*)arg;
+	const SPGameRecord* record;
+	SPFiarGame* game;
+	unsigned long g;
+	int i;
+
+	worker->msg = SP_POSITION_INDEX_SUCCESS;
+	worker->capacity = INITIAL_CAPACITY;
+	worker->n_items = 0;
+
+	if ((worker->items = (SPIndexItem*)malloc(worker->capacity * sizeof(SPIndexItem))) == NULL ||
+		(game = spFiarGameCreateWithGeometry(SP_FIAR_CODEC_MAX_MOVES, worker->geometry)) == NULL) {
+		worker->msg = SP_POSITION_INDEX_MEMORY_ERROR;
+		return NULL;
+	}
+
+	for (g = worker->first; g < worker->n_records && worker->msg == SP_POSITION_INDEX_SUCCESS; g += worker->step) {
+		record = worker->records + g;
+
+		if (record->geometry != worker->geometry) {
+			continue;
+		}
+
+		spFiarGameReset(game, worker->geometry);
+
+		// the empty board and the position after every move
+		for (i = 0; i <= record->length && worker->msg == SP_POSITION_INDEX_SUCCESS; i++) {
+			if (i > 0 && spFiarGameSetMove(game, spGameRecordGetMove(record, i - 1)) != SP_FIAR_GAME_SUCCESS) {
+				worker->msg = SP_POSITION_INDEX_INVALID_ARCHIVE;
+			}
+			else {
+				worker->msg = addItem(worker, spFiarCodecEncodeKey(game), (uint32_t)g, (uint32_t)record->result);
+			}
+		}
+	}
+
+	spFiarGameDestroy(game);
+
+	// the items are added in the order of the games, which the sort keeps, the last ones stay in memory
+	if (worker->msg == SP_POSITION_INDEX_SUCCESS && !sortItems(worker->items, worker->n_items)) {
+		worker->msg = SP_POSITION_INDEX_MEMORY_ERROR;
+	}
+
+	return NULL;
+}
+
+/*
+* Reads all records of an archive.
+*
+* @param reader the reader of the archive
+* @param records set to the array of records, to be freed by the caller
+* @param n_records set to the number of records
+* @return the status of the read
+*/
+static SP_POSITION_INDEX_MESSAGE readRecords(SPGameRecordReader* reader, SPGameRecord** records, unsigned long* n_records) {
+	unsigned long capacity = INITIAL_CAPACITY;
+	SP_GAME_RECORD_MESSAGE msg;
+	SPGameRecord* grown;
+
+	*n_records = 0;
+
+	if ((*records = (SPGameRecord*)malloc(capacity * sizeof(SPGameRecord))) == NULL) {
+		return SP_POSITION_INDEX_MEMORY_ERROR;
+	}
+
+	while ((msg = spGameRecordReaderNext(reader, *records + *n_records)) == SP_GAME_RECORD_SUCCESS) {
+		if (++(*n_records) == capacity) {
+			if ((grown = (SPGameRecord*)realloc(*records, 2 * capacity * sizeof(SPGameRecord))) == NULL) {
+				return SP_POSITION_INDEX_MEMORY_ERROR;
+			}
+
+			*records = grown;
+			capacity *= 2;
+		}
+	}
+
+	return msg == SP_GAME_RECORD_END ? SP_POSITION_INDEX_SUCCESS : SP_POSITION_INDEX_INVALID_ARCHIVE;
+}
+
+/*
+* Reads the next items of a spilled run into its buffer.
+*
+* @param run the run, with unread items
+* @return false iff the file can't be read
+*/
+static bool readRun(SPIndexRun* run) {
+	run->head = 0;
+	run->size = run->unread < RUN_BUFFER_ITEMS ? run->unread : RUN_BUFFER_ITEMS;
+	run->unread -= run->size;
+
+	return fread(run->items, sizeof(SPIndexItem), run->size, run->file) == run->size;
+}
+
+/*
+* Compares the heads of two runs, see compareItems.
+*/
+static int compareRuns(const SPIndexRun* a, const SPIndexRun* b) {
+	return compareItems(a->items + a->head, b->items + b->head);
+}
+
+/*
+* Moves a run of a heap down to its place, the least head first.
+*
+* @param heap the runs of the heap, none of them empty
+* @param n_heap the number of runs of the heap
+* @param i the place of the run
+*/
+static void siftRun(SPIndexRun** heap, int n_heap, int i) {
+	SPIndexRun* run = heap[i];
+	int child;
+
+	while ((child = 2 * i + 1) < n_heap) {
+		if (child + 1 < n_heap && compareRuns(heap[child + 1], heap[child]) < 0) {
+			child++;
+		}
+
+		if (compareRuns(heap[child], run) >= 0) {
+			break;
+		}
+
+		heap[i] = heap[child];
+		i = child;
+	}
+
+	heap[i] = run;
+}
+
+/*
+* Merges the sorted runs of the workers, spilled and in memory, into the entries
+* and the game numbers of the index, by a heap of the runs. The entries are
+* written to the index and the game numbers to a file of their own, both in the
+* order of the keys.
+*
+* @param workers the workers
+* @param n_workers the number of workers
+* @param index the index file, after its header
+* @param postings the file of the game numbers
+* @param n_entries set to the number of entries
+* @return the status of the merge
+*/
+static SP_POSITION_INDEX_MESSAGE mergeItems(SPIndexWorker* workers, int n_workers, FILE* index, FILE* postings,
+	size_t* n_entries) {
+	SP_POSITION_INDEX_MESSAGE msg = SP_POSITION_INDEX_SUCCESS;
+	SPPositionIndexEntry entry;
+	const SPIndexItem* item;
+	SPIndexRun *runs, **heap, *run;
+	size_t n_postings = 0;
+	int w, r, n_runs = 0, n_heap = 0;
+
+	*n_entries = 0;
+
+	for (w = 0; w < n_workers; w++) {
+		n_runs += workers[w].n_runs + 1;
+	}
+
+	runs = (SPIndexRun*)calloc(n_runs, sizeof(SPIndexRun));
+	heap = (SPIndexRun**)malloc(n_runs * sizeof(SPIndexRun*));
+
+	if (runs == NULL || heap == NULL) {
+		free(runs);
+		free(heap);
+		return SP_POSITION_INDEX_MEMORY_ERROR;
+	}
+
+	for (n_runs = 0, w = 0; w < n_workers; w++) {
+		for (r = 0; r < workers[w].n_runs && msg == SP_POSITION_INDEX_SUCCESS; r++) {
+			runs[n_runs] = workers[w].runs[r];
+
+			if ((runs[n_runs].items = (SPIndexItem*)malloc(RUN_BUFFER_ITEMS * sizeof(SPIndexItem))) == NULL) {
+				msg = SP_POSITION_INDEX_MEMORY_ERROR;
+			}
+			else if (fseek(runs[n_runs].file, 0, SEEK_SET) != 0 || !readRun(runs + n_runs)) {
+				msg = SP_POSITION_INDEX_IO_ERROR;
+			}
+
+			n_runs++;
+		}
+
+		runs[n_runs].items = workers[w].items;
+		runs[n_runs++].size = workers[w].n_items;
+	}
+
+	for (r = 0; r < n_runs; r++) {
+		if (runs[r].size > 0) {
+			heap[n_heap++] = runs + r;
+		}
+	}
+
+	for (r = n_heap / 2 - 1; r >= 0; r--) {
+		siftRun(heap, n_heap, r);
+	}
+
+	while (n_heap > 0 && msg == SP_POSITION_INDEX_SUCCESS) {
+		run = heap[0];
+		item = run->items + run->head++;
+
+		if (*n_entries == 0 || entry.key != item->key) {
+			if (*n_entries > 0 && fwrite(&entry, sizeof(SPPositionIndexEntry), 1, index) != 1) {
+				msg = SP_POSITION_INDEX_IO_ERROR;
+			}
+
+			memset(&entry, 0, sizeof(SPPositionIndexEntry));
+			entry.key = item->key;
+			entry.first = (uint32_t)n_postings;
+			(*n_entries)++;
+		}
+
+		entry.count++;
+		entry.results[item->result]++;
+		n_postings++;
+
+		if (fwrite(&item->game, sizeof(uint32_t), 1, postings) != 1) {
+			msg = SP_POSITION_INDEX_IO_ERROR;
+		}
+
+		// the item is read, the buffer of its run can be refilled
+		if (run->head == run->size) {
+			if (run->file != NULL && run->unread > 0) {
+				if (!readRun(run)) {
+					msg = SP_POSITION_INDEX_IO_ERROR;
+				}
+			}
+			else {
+				heap[0] = heap[--n_heap];
+			}
+		}
+
+		if (n_heap > 0) {
+			siftRun(heap, n_heap, 0);
+		}
+	}
+
+	if (msg == SP_POSITION_INDEX_SUCCESS && *n_entries > 0 &&
+		fwrite(&entry, sizeof(SPPositionIndexEntry), 1, index) != 1) {
+		msg = SP_POSITION_INDEX_IO_ERROR;
+	}
+
+	for (r = 0; r < n_runs; r++) {
+		if (runs[r].file != NULL) {
+			free(runs[r].items);
+		}
+	}
+
+	free(heap);
+	free(runs);
+
+	return msg;
+}
+
+/*
+* Writes an index file: a header, the entries merged from the runs of the
+* workers and the game numbers, copied from a temporary file after the entries.
+* A file that can't be written completely is removed.
+*
+* @param path the path of the file
+* @param header the header, its number of entries is set by the merge
+* @param workers the workers
+* @param n_workers the number of workers
+* @return the status of the write
+*/
+static SP_POSITION_INDEX_MESSAGE writeIndex(const char* path, SPPositionIndexHeader* header,
+	SPIndexWorker* workers, int n_workers) {
+	uint32_t buffer[RUN_BUFFER_ITEMS];
+	SP_POSITION_INDEX_MESSAGE msg;
+	FILE *file, *postings;
+	size_t n_entries, n_read;
+	bool failed;
+
+	if ((file = fopen(path, "wb")) == NULL) {
+		return SP_POSITION_INDEX_IO_ERROR;
+	}
+
+	if ((postings = tmpfile()) == NULL) {
+		fclose(file);
+		remove(path);
+		return SP_POSITION_INDEX_IO_ERROR;
+	}
+
+	// the header is written again once the entries are counted
+	msg = fwrite(header, sizeof(SPPositionIndexHeader), 1, file) != 1 ? SP_POSITION_INDEX_IO_ERROR :
+		mergeItems(workers, n_workers, file, postings, &n_entries);
+	failed = msg != SP_POSITION_INDEX_SUCCESS || fseek(postings, 0, SEEK_SET) != 0;
+
+	while (!failed && (n_read = fread(buffer, sizeof(uint32_t), RUN_BUFFER_ITEMS, postings)) > 0) {
+		failed = fwrite(buffer, sizeof(uint32_t), n_read, file) != n_read;
+	}
+
+	if (!failed) {
+		header->entries = n_entries;
+		failed = ferror(postings) || fseek(file, 0, SEEK_SET) != 0 ||
+			fwrite(header, sizeof(SPPositionIndexHeader), 1, file) != 1;
+	}
+
+	fclose(postings);
+	failed = fclose(file) != 0 || failed;
+
+	if (failed) {
+		remove(path);
+	}
+
+	return msg != SP_POSITION_INDEX_SUCCESS ? msg : (failed ? SP_POSITION_INDEX_IO_ERROR : SP_POSITION_INDEX_SUCCESS);
+}
+
+/*
+* Runs the workers, in threads where possible.
+*
+* @param workers the workers
+* @param n_workers the number of workers
+*/
+static void runWorkers(SPIndexWorker* workers, int n_workers) {
+	pthread_t threads[SP_POSITION_INDEX_MAX_THREADS];
+	bool started[SP_POSITION_INDEX_MAX_THREADS];
+	int w;
+
+	// a worker whose thread can't be created runs in this thread
+	for (w = 0; w < n_workers; w++) {
+		started[w] = pthread_create(threads + w, NULL, runWorker, workers + w) == 0;
+	}
+
+	for (w = 0; w < n_workers; w++) {
+		if (started[w]) {
+			pthread_join(threads[w], NULL);
+		}
+		else {
+			runWorker(workers + w);
+		}
+	}
+}
+
+SP_POSITION_INDEX_MESSAGE spPositionIndexBuild(const char* archive_path, const char* index_path, int threads,
+	size_t memory_limit, SPPositionIndexBuildStats* stats) {
+	SPIndexWorker workers[SP_POSITION_INDEX_MAX_THREADS];
+	SPPositionIndexHeader header;
+	SP_POSITION_INDEX_MESSAGE msg;
+	SPGameRecordReader* reader;
+	SPGameRecord* records = NULL;
+	unsigned long n_records, g, skipped = 0, runs = 0;
+	size_t n_items = 0, max_items;
+	int w, r;
+
+	if (archive_path == NULL || index_path == NULL) {
+		return SP_POSITION_INDEX_INVALID_ARGUMENT;
+	}
+
+	if (threads <= 0) {
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	}
+
+	threads = threads < 1 ? 1 : (threads > SP_POSITION_INDEX_MAX_THREADS ? SP_POSITION_INDEX_MAX_THREADS : threads);
+
+	// the items of a worker and the buffer of their sort
+	max_items = (memory_limit > 0 ? memory_limit : SP_POSITION_INDEX_DEFAULT_MEMORY_LIMIT) / threads /
+		(2 * sizeof(SPIndexItem));
+	max_items = max_items < INITIAL_CAPACITY ? INITIAL_CAPACITY : max_items;
+
+	if ((reader = spGameRecordReaderOpen(archive_path)) == NULL) {
+		return SP_POSITION_INDEX_INVALID_ARCHIVE;
+	}
+
+	memset(workers, 0, sizeof(workers));
+
+	if ((msg = readRecords(reader, &records, &n_records)) == SP_POSITION_INDEX_SUCCESS && n_records > 0 &&
+		!spFiarCodecHasKeys(records[0].geometry)) {
+		msg = SP_POSITION_INDEX_NO_KEYS;
+	}
+
+	if (msg == SP_POSITION_INDEX_SUCCESS && n_records > SP_POSITION_INDEX_MAX_COUNT) {
+		msg = SP_POSITION_INDEX_TOO_LARGE;
+	}
+
+	if (msg == SP_POSITION_INDEX_SUCCESS) {
+		for (w = 0; w < threads; w++) {
+			workers[w].records = records;
+			workers[w].n_records = n_records;
+			workers[w].first = w;
+			workers[w].step = threads;
+			workers[w].geometry = n_records > 0 ? records[0].geometry : spFiarGeometryGet(SP_FIAR_GEOMETRY_DEFAULT);
+			workers[w].max_items = max_items;
+		}
+
+		runWorkers(workers, threads);
+
+		for (w = 0; w < threads; w++) {
+			n_items += workers[w].n_spilled + workers[w].n_items;
+			runs += workers[w].n_runs;
+
+			if (workers[w].msg != SP_POSITION_INDEX_SUCCESS) {
+				msg = workers[w].msg;
+			}
+		}
+	}
+
+	if (msg == SP_POSITION_INDEX_SUCCESS && n_items > SP_POSITION_INDEX_MAX_COUNT) {
+		msg = SP_POSITION_INDEX_TOO_LARGE;
+	}
+
+	if (msg == SP_POSITION_INDEX_SUCCESS) {
+		for (g = 0; g < n_records; g++) {
+			skipped += records[g].geometry != workers[0].geometry;
+		}
+
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, SP_POSITION_INDEX_MAGIC, sizeof(header.magic));
+		header.version = SP_POSITION_INDEX_VERSION;
+		header.geometry = (uint8_t)workers[0].geometry->id;
+		header.postings = n_items;
+		header.games = n_records - skipped;
+
+		msg = writeIndex(index_path, &header, workers, threads);
+	}
+
+	if (msg == SP_POSITION_INDEX_SUCCESS && stats != NULL) {
+		stats->games = n_records - skipped;
+		stats->skipped = skipped;
+		stats->positions = n_items;
+		stats->entries = header.entries;
+		stats->runs = runs;
+		stats->threads = threads;
+	}
+
+	for (w = 0; w < threads; w++) {
+		for (r = 0; r < workers[w].n_runs; r++) {
+			fclose(workers[w].runs[r].file);
+		}
+
+		free(workers[w].runs);
+		free(workers[w].items);
+	}
+
+	free(records);
+	spGameRecordReaderClose(reader);
+
+	return msg;
+}
+
+/*
+* Checks if the mapped data of an index file is consistent: the header sizes
+* match the file size, every entry points inside the game numbers, and the keys
+* are sorted for the lookups. The sizes are compared by division, a corrupt
+* header can't overflow them.
+* @param data the mapped file, at least the size of a header
+* @param size the size of the file
+* @return true iff the index is valid
+*/
+static bool isValidIndex(const unsigned char* data, size_t size) {
+	const SPPositionIndexHeader* header = (const SPPositionIndexHeader*)data;
+	const SPPositionIndexEntry* entries = (const SPPositionIndexEntry*)(data + sizeof(SPPositionIndexHeader));
+	size_t rest = size - sizeof(SPPositionIndexHeader);
+	uint64_t i;
+
+	if (memcmp(header->magic, SP_POSITION_INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+		header->version != SP_POSITION_INDEX_VERSION || header->geometry >= SP_FIAR_N_GEOMETRIES) {
+		return false;
+	}
+
+	if (header->entries > rest / sizeof(SPPositionIndexEntry)) {
+		return false;
+	}
+
+	rest -= (size_t)header->entries * sizeof(SPPositionIndexEntry);
+
+	if (rest % sizeof(uint32_t) != 0 || header->postings != rest / sizeof(uint32_t)) {
+		return false;
+	}
+
+	for (i = 0; i < header->entries; i++) {
+		if (entries[i].first > header->postings || entries[i].count > header->postings - entries[i].first ||
+			(i > 0 && entries[i].key <= entries[i - 1].key)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+SPPositionIndex* spPositionIndexOpen(const char* path) {
+	const SPPositionIndexHeader* header;
+	SPPositionIndex* index;
+	struct stat st;
+	void* data;
+	int fd;
+
+	if (path == NULL || (fd = open(path, O_RDONLY)) < 0) {
+		return NULL;
+	}
+
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SPPositionIndexHeader)) {
+		close(fd);
+		return NULL;
+	}
+
+	data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		return NULL;
+	}
+
+	header = (const SPPositionIndexHeader*)data;
+
+	if (!isValidIndex((const unsigned char*)data, (size_t)st.st_size)) {
+		munmap(data, (size_t)st.st_size);
+		return NULL;
+	}
+
+	if ((index = (SPPositionIndex*)malloc(sizeof(SPPositionIndex))) == NULL) {
+		munmap(data, (size_t)st.st_size);
+		return NULL;
+	}
+
+	// lookups jump around the entries
+	posix_madvise(data, (size_t)st.st_size, POSIX_MADV_RANDOM);
+
+	index->data = (const unsigned char*)data;
+	index->size = (size_t)st.st_size;
+	index->header = header;
+	index->entries = (const SPPositionIndexEntry*)(index->data + sizeof(SPPositionIndexHeader));
+	index->postings = (const uint32_t*)(index->entries + header->entries);
+	index->geometry = spFiarGeometryGet((SP_FIAR_GEOMETRY_ID)header->geometry);
+
+	return index;
+}
+
+const SPPositionIndexEntry* spPositionIndexLookup(SPPositionIndex* index, unsigned long long key) {
+	size_t low, high, mid;
+
+	if ((void*)index == NULL) {
+		return NULL;
+	}
+
+	// binary search of the first entry with a key >= key
+	for (low = 0, high = index->header->entries; low < high;) {
+		mid = low + (high - low) / 2;
+
+		if (index->entries[mid].key < key) {
+			low = mid + 1;
+		}
+		else {
+			high = mid;
+		}
+	}
+
+	if (low == index->header->entries || index->entries[low].key != key) {
+		return NULL;
+	}
+
+	return index->entries + low;
+}
+
+const uint32_t* spPositionIndexGetGames(SPPositionIndex* index, const SPPositionIndexEntry* entry) {
+	if ((void*)index == NULL || (void*)entry == NULL) {
+		return NULL;
+	}
+
+	return index->postings + entry->first;
+}
+
+void spPositionIndexClose(SPPositionIndex* index) {
+	if ((void*)index == NULL) {
+		return;
+	}
+
+	munmap((void*)index->data, index->size);
+	free(index);
+}
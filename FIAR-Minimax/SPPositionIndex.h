@@ -0,0 +1,162 @@
+#ifndef SPPOSITIONINDEX_H_
+#define SPPOSITIONINDEX_H_
+#include <stdint.h>
+#include <stddef.h>
+#include "SPGameRecord.h"
+
+/**
+ * SPPositionIndex Summary:
+ *
+ * An index of the positions of a game archive (see SPGameRecord.h): for every
+ * position key (see SPFIARCodec.h) the games that passed through it, by their
+ * 0-based number in the archive, and the counts of their results.
+ *
+ * The index is built by replaying the games in parallel, every thread sorting its
+ * own entries, and merging the sorted runs. A thread keeps its share of a memory
+ * limit of entries, 16 bytes each and as many for their sort, and spills the rest
+ * in sorted runs to temporary files, which the merge reads back. The records of
+ * the archive stay in memory during the build, 40 bytes a game. The index file is
+ * mapped read only, a query is a binary search over its sorted keys.
+ *
+ * The game numbers and the positions of an index are 32 bit: an index holds up
+ * to SP_POSITION_INDEX_MAX_COUNT games and as many positions of all games, a
+ * larger archive fails to build.
+ *
+ * An index covers the games of a single geometry, the geometry of the first game
+ * of the archive. The games of other geometries are skipped.
+ *
+ * The file is a header, the entries sorted by key and the game numbers of all
+ * entries, in native byte order.
+ *
+ * spPositionIndexBuild   - Builds the index file of an archive
+ * spPositionIndexOpen    - Maps an index file for queries
+ * spPositionIndexLookup  - Looks up a position
+ * spPositionIndexGetGames - Returns the games of an entry
+ * spPositionIndexClose   - Unmaps an index and frees it
+ */
+
+//Definitions
+#define SP_POSITION_INDEX_MAGIC "FIDX"
+#define SP_POSITION_INDEX_VERSION 1
+#define SP_POSITION_INDEX_MAX_THREADS 64
+// the bytes of the entries the threads of a build keep in memory, by default
+#define SP_POSITION_INDEX_DEFAULT_MEMORY_LIMIT ((size_t)512 << 20)
+#define SP_POSITION_INDEX_MAX_COUNT UINT32_MAX
+
+/**
+ * Type used for returning error codes from index functions
+ */
+typedef enum sp_position_index_message_t {
+	SP_POSITION_INDEX_INVALID_ARGUMENT,
+	SP_POSITION_INDEX_INVALID_ARCHIVE,  // an unreadable or corrupt archive
+	SP_POSITION_INDEX_NO_KEYS,          // the geometry of the archive has no keys
+	SP_POSITION_INDEX_IO_ERROR,
+	SP_POSITION_INDEX_MEMORY_ERROR,
+	SP_POSITION_INDEX_TOO_LARGE,        // more games or positions than an index holds
+	SP_POSITION_INDEX_SUCCESS
+} SP_POSITION_INDEX_MESSAGE;
+
+/**
+ * The entry of a position
+ */
+typedef struct sp_position_index_entry_t {
+	uint64_t key;
+	uint32_t first;    // the index of the first game number of the entry
+	uint32_t count;    // the number of games
+	uint32_t results[4]; // the number of games of every SP_GAME_RECORD_RESULT
+} SPPositionIndexEntry;
+
+typedef struct sp_position_index_header_t {
+	char magic[4];
+	uint8_t version;
+	uint8_t geometry;  // SP_FIAR_GEOMETRY_ID
+	uint8_t reserved[2];
+	uint64_t entries;  // the number of entries
+	uint64_t postings; // the number of game numbers
+	uint64_t games;    // the number of games indexed
+} SPPositionIndexHeader;
+
+typedef struct sp_position_index_t {
+	const unsigned char* data; // the mapped file
+	size_t size;
+	const SPPositionIndexHeader* header;
+	const SPPositionIndexEntry* entries;
+	const uint32_t* postings;
+	const SPFiarGeometry* geometry;
+} SPPositionIndex;
+
+/**
+ * The numbers of a build of an index
+ */
+typedef struct sp_position_index_build_stats_t {
+	unsigned long games;     // the games indexed
+	unsigned long skipped;   // the games of another geometry
+	unsigned long positions; // the positions of all games
+	unsigned long entries;   // the distinct positions
+	unsigned long runs;      // the sorted runs spilled to temporary files
+	int threads;
+} SPPositionIndexBuildStats;
+
+/**
+ * Builds the index file of an archive.
+ *
+ * @param archive_path - the path of the archive
+ * @param index_path - the path of the index file to create
+ * @param threads - the number of threads, 0 for the number of processors
+ * @param memory_limit - the bytes of the entries kept in memory, 0 for SP_POSITION_INDEX_DEFAULT_MEMORY_LIMIT
+ * @param stats - if not NULL, set to the numbers of the build
+ * @return
+ * SP_POSITION_INDEX_INVALID_ARGUMENT - if a path is NULL
+ * SP_POSITION_INDEX_INVALID_ARCHIVE  - if the archive can't be read or is corrupt
+ * SP_POSITION_INDEX_NO_KEYS          - if the geometry of the archive has no position keys
+ * SP_POSITION_INDEX_TOO_LARGE        - if the archive has more than SP_POSITION_INDEX_MAX_COUNT
+ *                                      games or positions
+ * SP_POSITION_INDEX_IO_ERROR         - if the index file or a temporary file can't be written,
+ *                                      no index file is left then
+ * SP_POSITION_INDEX_MEMORY_ERROR     - if a memory allocation failure occurred
+ * SP_POSITION_INDEX_SUCCESS          - otherwise
+ */
+SP_POSITION_INDEX_MESSAGE spPositionIndexBuild(const char* archive_path, const char* index_path, int threads,
+	size_t memory_limit, SPPositionIndexBuildStats* stats);
+
+/**
+ * Maps an index file for queries. The file is checked first: its size must match
+ * the header, the game numbers of every entry must lie inside the file and the
+ * keys must be sorted.
+ *
+ * @param path - the path of the index file
+ * @return
+ * NULL if path is NULL, the file can't be mapped, it isn't a valid index or a
+ * memory allocation failure occurred. Otherwise, the index.
+ */
+SPPositionIndex* spPositionIndexOpen(const char* path);
+
+/**
+ * Looks up a position.
+ *
+ * @param index - the index
+ * @param key - the key of the position, see spFiarCodecEncodeKey
+ * @return
+ * NULL if index is NULL or no indexed game passed through the position.
+ * Otherwise, the entry of the position, valid until the index is closed.
+ */
+const SPPositionIndexEntry* spPositionIndexLookup(SPPositionIndex* index, unsigned long long key);
+
+/**
+ * Returns the game numbers of an entry, in increasing order.
+ *
+ * @param index - the index
+ * @param entry - an entry of the index
+ * @return
+ * NULL if index or entry is NULL, an array of entry->count game numbers otherwise.
+ */
+const uint32_t* spPositionIndexGetGames(SPPositionIndex* index, const SPPositionIndexEntry* entry);
+
+/**
+ * Unmaps an index and frees it. If index == NULL nothing happens.
+ *
+ * @param index - the index
+ */
+void spPositionIndexClose(SPPositionIndex* index);
+
+#endif
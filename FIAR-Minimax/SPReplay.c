@@ -0,0 +1,379 @@
+#include "SPReplay.h"
+#include "SPMainAux.h"
+#include "SPThreadPool.h"
+
+#define REPLAY_WINDOW_PER_THREAD 4
+#define REPLAY_INITIAL_FILE_SIZE 4096
+#define STDIN_PATH "-"
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+typedef struct sp_replay_run_t SPReplayRun;
+
+/*
+* A script and its results.
+*/
+typedef struct sp_replay_script_t {
+	SPReplayRun* run;
+	const char* path;
+	SP_GAME_OUTPUT output;           // the transcript
+	unsigned long long checksum;
+	bool read_failed;
+	bool done;
+} SPReplayScript;
+
+struct sp_replay_run_t {
+	bool checksum;                   // print checksums instead of transcripts
+	SP_GAME_SESSION options;         // the engine and board of the games, see parse_engine_option
+	pthread_mutex_t lock;
+	pthread_cond_t script_done;
+};
+
+/*
+* Adds a byte to an FNV-1a hash.
+* @param hash the hash
+* @param byte the byte
+* @return the new hash
+*/
+static unsigned long long hashByte(unsigned long long hash, unsigned char byte) {
+	return (hash ^ byte) * FNV_PRIME;
+}
+
+/*
+* Adds the final state of a game to the checksum of its script.
+* @param script the script
+* @param game the game
+* @param level the level of the game
+*/
+static void hashGame(SPReplayScript* script, SPFiarGame* game, unsigned int level) {
+	unsigned long long hash = script->checksum;
+	int i, j;
+
+	hash = hashByte(hash, (unsigned char)level);
+
+	for (i = 0; i < game->geometry->rows; i++) {
+		for (j = 0; j < game->geometry->columns; j++) {
+			hash = hashByte(hash, (unsigned char)(game->gameBoard)[i][j]);
+		}
+	}
+
+	script->checksum = hashByte(hash, (unsigned char)spFiarGameGetCurrentPlayer(game));
+}
+
+/*
+* Reads a whole file. The contents are ended by a '\n' if the file doesn't end
+* with one, so that its last line is a line too.
+* @param path the path of the file, "-" for the standard input
+* @param size set to the size of the contents
+* @return the contents of the file, NULL if it can't be read
+*/
+static char* readFile(const char* path, size_t* size) {
+	FILE* file = strcmp(path, STDIN_PATH) == 0 ? stdin : fopen(path, "rb");
+	size_t capacity = REPLAY_INITIAL_FILE_SIZE, read;
+	char *data = NULL, *grown;
+
+	if (file == NULL) {
+		return NULL;
+	}
+
+	*size = 0;
+
+	while ((grown = (char*)realloc(data, capacity)) != NULL) {
+		data = grown;
+		read = fread(data + *size, 1, capacity - *size, file);
+		*size += read;
+
+		if (*size < capacity) {
+			break;
+		}
+
+		capacity *= 2;
+	}
+
+	if (grown == NULL || ferror(file)) {
+		free(data);
+		data = NULL;
+	}
+	else if (*size > 0 && data[*size - 1] != '\n') {
+		// the loop has left room for it
+		data[(*size)++] = '\n';
+	}
+
+	if (file != stdin) {
+		fclose(file);
+	}
+
+	return data;
+}
+
+/*
+* Runs a script, with the game loop of the interactive game (see SPMainAux.h)
+* but without its prompts and boards. The task of the pool.
+* @param arg the script
+*/
+static void runScript(void* arg) {
+	SPReplayScript* script = (SPReplayScript*)arg;
+	SPReplayRun* run = script->run;
+	SP_GAME_SESSION session;
+	GAME_HAS_ENDED_MESSAGE msg;
+	unsigned int level;
+	char* data;
+
+	init_session(&session, NULL, NULL);
+	session.prompts = false;
+	session.output.discard = run->checksum;
+	session.config = run->options.config;
+	session.geometry = run->options.geometry;
+	script->checksum = FNV_OFFSET_BASIS;
+
+	if ((data = readFile(script->path, &session.input.size)) == NULL) {
+		script->read_failed = true;
+	}
+	else {
+		session.input.data = data;
+
+		// restart reads a new level, as in the interactive game
+		do {
+			if ((level = init(&session)) == EXIT) {
+				break;
+			}
+
+			msg = run_game(&session, level);
+
+			if (session.game != NULL) {
+				hashGame(script, session.game, level);
+			}
+		} while (msg == RESTART);
+	}
+
+	// the transcript outlives the session
+	script->output = session.output;
+	memset(&session.output, 0, sizeof(SP_GAME_OUTPUT));
+	destroy_session(&session);
+	free(data);
+
+	pthread_mutex_lock(&run->lock);
+	script->done = true;
+	pthread_cond_broadcast(&run->script_done);
+	pthread_mutex_unlock(&run->lock);
+}
+
+/*
+* Waits until a script has run and prints its transcript or checksum.
+* @param run the run
+* @param script the script
+* @param many true iff more than one script runs
+* @return false iff the script can't be read
+*/
+static bool printScript(SPReplayRun* run, SPReplayScript* script, bool many) {
+	pthread_mutex_lock(&run->lock);
+
+	while (!script->done) {
+		pthread_cond_wait(&run->script_done, &run->lock);
+	}
+
+	pthread_mutex_unlock(&run->lock);
+
+	if (script->read_failed) {
+		printf("Error: cannot read %s\n", script->path);
+		return false;
+	}
+
+	if (run->checksum) {
+		printf("%s %016llx\n", script->path, script->checksum);
+	}
+	else {
+		if (many) {
+			printf("script %s\n", script->path);
+		}
+
+		fwrite(script->output.data, 1, script->output.size, stdout);
+
+		if (script->output.failed) {
+			printf(MEM_ERR_STRING "\n", MALLOC);
+		}
+	}
+
+	free(script->output.data);
+	memset(&script->output, 0, sizeof(script->output));
+
+	return true;
+}
+
+/*
+* Adds the paths of a list file to the paths of the scripts.
+* @param list the contents of the list file, changed to hold the paths
+* @param size the size of the list file
+* @param paths the paths, reallocated to hold the new ones
+* @param n_paths the number of paths, increased by the new ones
+* @return false iff a memory allocation failure occurred
+*/
+static bool addListPaths(char* list, size_t size, const char*** paths, int* n_paths) {
+	const char** grown;
+	char *line = list, *end = list + size, *newline;
+	size_t length;
+
+	while (line < end) {
+		newline = (char*)memchr(line, '\n', end - line);
+		length = (newline != NULL ? newline : end) - line;
+
+		if (length > 0 && line[length - 1] == '\r') {
+			length--;
+		}
+
+		if (length > 0) {
+			if ((grown = (const char**)realloc(*paths, (*n_paths + 1) * sizeof(const char*))) == NULL) {
+				return false;
+			}
+
+			line[length] = '\0';
+			*paths = grown;
+			(*paths)[(*n_paths)++] = line;
+		}
+
+		line = newline != NULL ? newline + 1 : end;
+	}
+
+	return true;
+}
+
+/*
+* Parses the options of the run, the other arguments are the paths of scripts.
+* @param argc the number of arguments
+* @param argv the arguments
+* @param run the run to configure
+* @param list set to the list file, NULL if none
+* @param threads set to the threads option, 0 if none
+* @param paths set to the paths in the arguments
+* @param n_paths set to the number of paths in the arguments
+* @return true iff the arguments are valid
+*/
+static bool parseOptions(int argc, char* argv[], SPReplayRun* run, const char** list, int* threads,
+	const char*** paths, int* n_paths) {
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], REPLAY_CHECKSUM_OPTION) == 0) {
+			run->checksum = true;
+		}
+		else if (strncmp(argv[i], "--", 2) != 0) {
+			(*paths)[(*n_paths)++] = argv[i];
+		}
+		else if (i + 1 == argc) {
+			return false;
+		}
+		else if (strcmp(argv[i], REPLAY_LIST_OPTION) == 0) {
+			*list = argv[++i];
+		}
+		else if (strcmp(argv[i], REPLAY_THREADS_OPTION) == 0 && spParserIsInt(argv[i + 1]) && atoi(argv[i + 1]) > 0) {
+			*threads = atoi(argv[++i]);
+		}
+		else if (parse_engine_option(argv[i], argv[i + 1], &run->options)) {
+			i++;
+		}
+		else {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+* Runs the scripts in parallel and prints their results in order.
+* @param run the run
+* @param paths the paths of the scripts
+* @param n_paths the number of scripts
+* @param threads the number of threads
+* @return 0 on success, 1 if a script can't be read or a memory allocation failure occurred
+*/
+static int runScripts(SPReplayRun* run, const char** paths, int n_paths, int threads) {
+	SPReplayScript* scripts;
+	SPThreadPool* pool;
+	int window = REPLAY_WINDOW_PER_THREAD * threads, next, printed = 0, result = 0;
+
+	scripts = (SPReplayScript*)calloc(window, sizeof(SPReplayScript));
+
+	if (scripts == NULL || (pool = spThreadPoolCreate(threads, window)) == NULL) {
+		printf(MEM_ERR_STRING "\n", MALLOC);
+		free(scripts);
+		return 1;
+	}
+
+	pthread_mutex_init(&run->lock, NULL);
+	pthread_cond_init(&run->script_done, NULL);
+
+	// a script is reused once it is printed
+	for (next = 0; next < n_paths; next++) {
+		if (next - printed == window && !printScript(run, &scripts[printed++ % window], n_paths > 1)) {
+			result = 1;
+		}
+
+		memset(&scripts[next % window], 0, sizeof(SPReplayScript));
+		scripts[next % window].run = run;
+		scripts[next % window].path = paths[next];
+		spThreadPoolSubmit(pool, runScript, &scripts[next % window]);
+	}
+
+	while (printed < next) {
+		if (!printScript(run, &scripts[printed++ % window], n_paths > 1)) {
+			result = 1;
+		}
+	}
+
+	spThreadPoolDestroy(pool);
+	pthread_cond_destroy(&run->script_done);
+	pthread_mutex_destroy(&run->lock);
+	free(scripts);
+
+	return result;
+}
+
+int spReplayMain(int argc, char* argv[]) {
+	SPReplayRun run;
+	const char *list_path = NULL, **paths;
+	char* list = NULL;
+	size_t list_size;
+	int threads = 0, n_paths = 0, result;
+
+	memset(&run, 0, sizeof(run));
+	init_session(&run.options, NULL, NULL);
+
+	if ((paths = (const char**)malloc((argc + 1) * sizeof(const char*))) == NULL) {
+		printf(MEM_ERR_STRING "\n", MALLOC);
+		return 1;
+	}
+
+	if (!parseOptions(argc, argv, &run, &list_path, &threads, &paths, &n_paths)) {
+		printf("Usage: %s [%s] [%s <file>] [%s <n>] [%s plain|pvs|mtdf|mcts] [%s 7x6|8x7|9x7|connect5] "
+			"[%s depth|nodes] [%s <MB>] [<script> ...]\n", argv[0], REPLAY_CHECKSUM_OPTION, REPLAY_LIST_OPTION,
+			REPLAY_THREADS_OPTION, MODE_OPTION, GEOMETRY_OPTION, LEVELS_OPTION, MEMORY_OPTION);
+		free(paths);
+		return 1;
+	}
+
+	if (list_path != NULL) {
+		if ((list = readFile(list_path, &list_size)) == NULL) {
+			printf("Error: cannot read %s\n", list_path);
+			free(paths);
+			return 1;
+		}
+
+		if (!addListPaths(list, list_size, &paths, &n_paths)) {
+			printf(MEM_ERR_STRING "\n", MALLOC);
+			free(list);
+			free(paths);
+			return 1;
+		}
+	}
+	else if (n_paths == 0) {
+		paths[n_paths++] = STDIN_PATH;
+	}
+
+	result = runScripts(&run, paths, n_paths, threads > 0 ? threads : spThreadPoolCountProcessors());
+
+	free(list);
+	free(paths);
+
+	return result;
+}
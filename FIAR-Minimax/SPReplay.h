@@ -0,0 +1,48 @@
+#ifndef SPREPLAY_H_
+#define SPREPLAY_H_
+
+#define REPLAY_COMMAND "replay"
+#define REPLAY_CHECKSUM_OPTION "--checksum"
+#define REPLAY_LIST_OPTION "--list"
+#define REPLAY_THREADS_OPTION "--threads"
+
+/**
+ * SPReplay Summary:
+ *
+ * Runs command scripts, the input of the interactive game (a level line, then
+ * commands), with the game loop of the interactive game (see SPMainAux.h) but
+ * without its prompts and boards. A script is read at once and its lines are
+ * parsed in place, a line longer than SP_MAX_LINE_LENGTH is cut. The transcript of a script is the messages the interactive
+ * game prints for it (the moves of the computer, the suggestions, the removed
+ * discs, the notes of degraded searches, the ends of the games and the errors),
+ * built in memory and written at once.
+ *
+ * Instead of transcripts, a checksum of every script can be printed: a 64 bit
+ * FNV-1a hash of the final state (level, board and player to move) of every game
+ * the script played, in order. Two runs of a script agree iff they end every game
+ * in the same state.
+ *
+ * The scripts run in parallel in a single process and their output keeps the order
+ * of the scripts.
+ *
+ * spReplayMain  - Runs the scripts
+ */
+
+/**
+ * Runs the scripts. Usage: replay [--checksum] [--list <file>] [--threads <n>]
+ * [--mode <plain|pvs|mtdf|mcts>] [--geometry <7x6|8x7|9x7|connect5>]
+ * [--levels <depth|nodes>] [--memory <MB>] [<script> ...]
+ * The engine options are those of the interactive game, --threads is the number
+ * of scripts run at once. The scripts are the arguments and the paths of the list file, a path per line
+ * ("-" for the standard input). Without scripts the standard input is the script.
+ * With more than one script every transcript starts with a line "script <path>",
+ * a checksum is printed as a line "<path> <checksum>".
+ *
+ * @param argc - the number of arguments, including the command name
+ * @param argv - the arguments, argv[0] is the command name
+ * @return
+ * 0 on success, 1 if the arguments are invalid or a script can't be read
+ */
+int spReplayMain(int argc, char* argv[]);
+
+#endif
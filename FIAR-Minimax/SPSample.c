@@ -0,0 +1,146 @@
+#define _POSIX_C_SOURCE 200112L
+#include "SPSample.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define KEY_OFFSET 0
+#define SCORE_OFFSET 8
+#define MOVE_OFFSET 12
+#define RESULT_OFFSET 13
+
+void spSampleEncode(const SPSample* sample, unsigned char* dest) {
+	unsigned long score = (unsigned long)(unsigned int)sample->score;
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		dest[KEY_OFFSET + i] = (unsigned char)(sample->key >> (8 * i));
+	}
+
+	for (i = 0; i < 4; i++) {
+		dest[SCORE_OFFSET + i] = (unsigned char)(score >> (8 * i));
+	}
+
+	dest[MOVE_OFFSET] = (unsigned char)sample->move;
+	dest[RESULT_OFFSET] = (unsigned char)sample->result;
+}
+
+bool spSampleWriteHeader(FILE* file, const SPFiarGeometry* geometry) {
+	unsigned char header[SP_SAMPLE_FILE_HEADER_SIZE] = { 0 };
+
+	if (file == NULL || (void*)geometry == NULL) {
+		return false;
+	}
+
+	memcpy(header, SP_SAMPLE_MAGIC, strlen(SP_SAMPLE_MAGIC));
+	header[strlen(SP_SAMPLE_MAGIC)] = SP_SAMPLE_VERSION;
+	header[strlen(SP_SAMPLE_MAGIC) + 1] = (unsigned char)geometry->id;
+
+	return fwrite(header, 1, sizeof(header), file) == sizeof(header);
+}
+
+SPSampleReader* spSampleReaderOpen(const char* path) {
+	SPSampleReader* reader;
+	const unsigned char* header;
+	struct stat st;
+	void* data;
+	int fd;
+
+	if (path == NULL || (fd = open(path, O_RDONLY)) < 0) {
+		return NULL;
+	}
+
+	if (fstat(fd, &st) != 0 || st.st_size < SP_SAMPLE_FILE_HEADER_SIZE) {
+		close(fd);
+		return NULL;
+	}
+
+	data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping stays valid without the descriptor
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		return NULL;
+	}
+
+	header = (const unsigned char*)data;
+
+	if (memcmp(header, SP_SAMPLE_MAGIC, strlen(SP_SAMPLE_MAGIC)) != 0 ||
+		header[strlen(SP_SAMPLE_MAGIC)] != SP_SAMPLE_VERSION ||
+		header[strlen(SP_SAMPLE_MAGIC) + 1] >= SP_FIAR_N_GEOMETRIES) {
+		munmap(data, (size_t)st.st_size);
+		return NULL;
+	}
+
+	reader = (SPSampleReader*)malloc(sizeof(SPSampleReader));
+
+	if ((void*)reader == NULL) {
+		munmap(data, (size_t)st.st_size);
+		return NULL;
+	}
+
+	// the samples are read in order
+	posix_madvise(data, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+
+	reader->data = header;
+	reader->size = (size_t)st.st_size;
+	reader->offset = SP_SAMPLE_FILE_HEADER_SIZE;
+	reader->geometry = spFiarGeometryGet((SP_FIAR_GEOMETRY_ID)header[strlen(SP_SAMPLE_MAGIC) + 1]);
+
+	return reader;
+}
+
+SP_SAMPLE_MESSAGE spSampleReaderNext(SPSampleReader* reader, SPSample* sample) {
+	const unsigned char* src;
+	unsigned long score = 0;
+	int i;
+
+	if ((void*)reader == NULL || (void*)sample == NULL) {
+		return SP_SAMPLE_INVALID_ARGUMENT;
+	}
+
+	if (reader->offset == reader->size) {
+		return SP_SAMPLE_END;
+	}
+
+	if (reader->size - reader->offset < SP_SAMPLE_SIZE) {
+		return SP_SAMPLE_INVALID_FORMAT;
+	}
+
+	src = reader->data + reader->offset;
+
+	if (src[RESULT_OFFSET] > SP_SAMPLE_WIN) {
+		return SP_SAMPLE_INVALID_FORMAT;
+	}
+
+	sample->key = 0;
+
+	for (i = 7; i >= 0; i--) {
+		sample->key = (sample->key << 8) | src[KEY_OFFSET + i];
+	}
+
+	for (i = 3; i >= 0; i--) {
+		score = (score << 8) | src[SCORE_OFFSET + i];
+	}
+
+	// the score is a two's complement 32 bit number
+	sample->score = score >= 0x80000000UL ? -(int)(0xFFFFFFFFUL - score) - 1 : (int)score;
+	sample->move = src[MOVE_OFFSET];
+	sample->result = (SP_SAMPLE_RESULT)src[RESULT_OFFSET];
+	reader->offset += SP_SAMPLE_SIZE;
+
+	return SP_SAMPLE_SUCCESS;
+}
+
+void spSampleReaderClose(SPSampleReader* reader) {
+	if ((void*)reader == NULL) {
+		return;
+	}
+
+	munmap((void*)reader->data, reader->size);
+	free(reader);
+}
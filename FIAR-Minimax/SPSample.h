@@ -0,0 +1,119 @@
+#ifndef SPSAMPLE_H_
+#define SPSAMPLE_H_
+#include <stdio.h>
+#include <stddef.h>
+#include "SPFIARGame.h"
+
+/**
+ * SPSample Summary:
+ *
+ * A compact binary format of training samples, the positions of self-play games
+ * with their search results: a file header followed by fixed size samples, so a
+ * file can be split and read from any sample.
+ *
+ * The file header is the magic "FIRS", a version byte, the geometry id of the
+ * positions and 2 reserved bytes. A sample takes 14 bytes, little endian:
+ *   bytes 0-7   - the position key (see SPFIARCodec.h)
+ *   bytes 8-11  - the score of the search, for the player to move
+ *   byte 12     - the best move of the search, 0-based
+ *   byte 13     - the final result of the game for the player to move
+ *                 (see SP_SAMPLE_RESULT)
+ *
+ * Samples files are written as a stream and read from a read only memory mapping.
+ *
+ * spSampleEncode        - Encodes a sample into a buffer
+ * spSampleWriteHeader   - Writes the file header of a samples file
+ * spSampleReaderOpen    - Maps a samples file for reading
+ * spSampleReaderNext    - Reads the next sample of a file
+ * spSampleReaderClose   - Unmaps a samples file and frees its reader
+ */
+
+//Definitions
+#define SP_SAMPLE_MAGIC "FIRS"
+#define SP_SAMPLE_VERSION 1
+#define SP_SAMPLE_FILE_HEADER_SIZE 8
+#define SP_SAMPLE_SIZE 14
+
+/**
+ * Type used for returning error codes from sample functions
+ */
+typedef enum sp_sample_message_t {
+	SP_SAMPLE_INVALID_ARGUMENT,
+	SP_SAMPLE_INVALID_FORMAT, // a corrupt or truncated file
+	SP_SAMPLE_END,            // no more samples
+	SP_SAMPLE_SUCCESS
+} SP_SAMPLE_MESSAGE;
+
+/**
+ * The final result of a game for a player
+ */
+typedef enum sp_sample_result_t {
+	SP_SAMPLE_LOSS,
+	SP_SAMPLE_DRAW,
+	SP_SAMPLE_WIN
+} SP_SAMPLE_RESULT;
+
+typedef struct sp_sample_t {
+	unsigned long long key;
+	int score;
+	int move;
+	SP_SAMPLE_RESULT result;
+} SPSample;
+
+typedef struct sp_sample_reader_t {
+	const unsigned char* data; // the mapped file
+	size_t size;
+	size_t offset;             // the offset of the next sample
+	const SPFiarGeometry* geometry;
+} SPSampleReader;
+
+/**
+ * Encodes a sample.
+ *
+ * @param sample - the sample
+ * @param dest - the buffer to write the sample to, of SP_SAMPLE_SIZE bytes at least
+ */
+void spSampleEncode(const SPSample* sample, unsigned char* dest);
+
+/**
+ * Writes the file header of a samples file.
+ *
+ * @param file - the file, at its beginning
+ * @param geometry - the geometry of the positions
+ * @return
+ * true iff file and geometry are not NULL and the header was written
+ */
+bool spSampleWriteHeader(FILE* file, const SPFiarGeometry* geometry);
+
+/**
+ * Maps a samples file for reading and checks its header.
+ *
+ * @param path - the path of the file
+ * @return
+ * NULL if path is NULL, the file can't be mapped, it isn't a samples file or a
+ * memory allocation failure occurred. Otherwise, the reader of the file, at its
+ * first sample.
+ */
+SPSampleReader* spSampleReaderOpen(const char* path);
+
+/**
+ * Reads the next sample of a file.
+ *
+ * @param reader - the reader
+ * @param sample - set to the sample on success
+ * @return
+ * SP_SAMPLE_INVALID_ARGUMENT - if reader or sample is NULL
+ * SP_SAMPLE_INVALID_FORMAT   - if the next sample is corrupt or truncated
+ * SP_SAMPLE_END              - if there are no more samples
+ * SP_SAMPLE_SUCCESS          - otherwise
+ */
+SP_SAMPLE_MESSAGE spSampleReaderNext(SPSampleReader* reader, SPSample* sample);
+
+/**
+ * Unmaps a samples file and frees its reader.
+ *
+ * @param reader - the reader, if NULL nothing happens
+ */
+void spSampleReaderClose(SPSampleReader* reader);
+
+#endif
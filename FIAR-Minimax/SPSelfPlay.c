@@ -0,0 +1,308 @@
+#define _POSIX_C_SOURCE 200112L
+#include "SPSelfPlay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "SPMinimax.h"
+#include "SPSample.h"
+#include "SPThreadPool.h"
+#include "SPFIARParser.h"
+#include "SPFIARCodec.h"
+
+#define SELFPLAY_HISTORY_SIZE SP_FIAR_CODEC_MAX_MOVES
+#define SELFPLAY_SEED_STEP 0x9E3779B97F4A7C15ULL
+
+/*
+* A run of the generator, shared by its threads.
+*/
+typedef struct sp_self_play_t {
+	SPMinimaxConfig config;
+	const SPFiarGeometry* geometry;
+	unsigned int level;
+	long games;
+	int random;                // the percentage of random moves
+	unsigned long long seed;
+	long next_game;            // the number of the next game to play, taken atomically
+	FILE* output;
+	pthread_mutex_t lock;      // guards the output, samples and failed
+	unsigned long samples;     // the samples written
+	bool failed;
+} SPSelfPlay;
+
+/*
+* A thread of the generator and its buffer.
+*/
+typedef struct sp_self_play_worker_t {
+	SPSelfPlay* run;
+	unsigned char buffer[SELFPLAY_BUFFER_SAMPLES * SP_SAMPLE_SIZE];
+	size_t used;
+} SPSelfPlayWorker;
+
+/*
+* Returns the next random number of a game, by xorshift64*.
+* @param state the state of the random generator
+* @return the number
+*/
+static unsigned long long nextRandom(unsigned long long* state) {
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+
+	return *state * 2685821657736338717ULL;
+}
+
+/*
+* Marks a run as failed, so its threads stop after their current games.
+* @param run the run
+*/
+static void setFailed(SPSelfPlay* run) {
+	pthread_mutex_lock(&run->lock);
+	run->failed = true;
+	pthread_mutex_unlock(&run->lock);
+}
+
+/*
+* Checks if a run has failed.
+* @param run the run
+* @return true iff it failed
+*/
+static bool hasFailed(SPSelfPlay* run) {
+	bool failed;
+
+	pthread_mutex_lock(&run->lock);
+	failed = run->failed;
+	pthread_mutex_unlock(&run->lock);
+
+	return failed;
+}
+
+/*
+* Appends the buffer of a thread to the output, in a single write.
+* @param worker the thread
+*/
+static void flushBuffer(SPSelfPlayWorker* worker) {
+	SPSelfPlay* run = worker->run;
+
+	if (worker->used == 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&run->lock);
+
+	if (!run->failed && fwrite(worker->buffer, 1, worker->used, run->output) != worker->used) {
+		run->failed = true;
+	}
+
+	run->samples += worker->used / SP_SAMPLE_SIZE;
+	pthread_mutex_unlock(&run->lock);
+	worker->used = 0;
+}
+
+/*
+* Plays a game of the run and sets its samples.
+* @param run the run
+* @param game the game to play on, reset first
+* @param number the number of the game, which seeds its random moves
+* @param samples set to the samples of the game, SP_FIAR_CODEC_MAX_MOVES at most
+* @return the number of samples, -1 if a search failed
+*/
+static int playGame(SPSelfPlay* run, SPFiarGame* game, long number, SPSample* samples) {
+	unsigned long long state = run->seed ^ (SELFPLAY_SEED_STEP * (unsigned long long)(number + 1));
+	char movers[SP_FIAR_CODEC_MAX_MOVES], winner;
+	SPMinimaxResult result;
+	int n = 0, move, col, legal;
+
+	spFiarGameReset(game, run->geometry);
+
+	while ((winner = spFiarCheckWinner(game)) == '\0') {
+		if ((move = spMinimaxSuggestMoveWithConfig(game, run->level, &run->config, &result)) == -1) {
+			return -1;
+		}
+
+		samples[n].key = spFiarCodecEncodeKey(game);
+		samples[n].score = result.score;
+		samples[n].move = result.move;
+		movers[n++] = spFiarGameGetCurrentPlayer(game);
+
+		if ((int)(nextRandom(&state) % 100) < run->random) {
+			// the k-th legal column, for a random k
+			for (col = 0, legal = 0; col < run->geometry->columns; col++) {
+				legal += spFiarGameIsValidMove(game, col);
+			}
+
+			legal = (int)(nextRandom(&state) % legal);
+
+			for (move = 0; !spFiarGameIsValidMove(game, move) || legal-- > 0; move++);
+		}
+
+		spFiarGameSetMove(game, move);
+	}
+
+	for (col = 0; col < n; col++) {
+		samples[col].result = winner == SP_FIAR_GAME_TIE_SYMBOL ? SP_SAMPLE_DRAW :
+			(winner == movers[col] ? SP_SAMPLE_WIN : SP_SAMPLE_LOSS);
+	}
+
+	return n;
+}
+
+/*
+* Plays games until all of the games of the run are taken. The task of a thread.
+* @param arg the thread
+*/
+static void runWorker(void* arg) {
+	SPSelfPlayWorker* worker = (SPSelfPlayWorker*)arg;
+	SPSelfPlay* run = worker->run;
+	SPSample samples[SP_FIAR_CODEC_MAX_MOVES];
+	SPFiarGame* game;
+	long number;
+	int n, i;
+
+	if ((game = spFiarGameCreateWithGeometry(SELFPLAY_HISTORY_SIZE, run->geometry)) == NULL) {
+		setFailed(run);
+		return;
+	}
+
+	while ((number = __atomic_fetch_add(&run->next_game, 1, __ATOMIC_RELAXED)) < run->games && !hasFailed(run)) {
+		if ((n = playGame(run, game, number, samples)) == -1) {
+			setFailed(run);
+			break;
+		}
+
+		// the samples of a game stay together
+		if (worker->used + (size_t)n * SP_SAMPLE_SIZE > sizeof(worker->buffer)) {
+			flushBuffer(worker);
+		}
+
+		for (i = 0; i < n; i++, worker->used += SP_SAMPLE_SIZE) {
+			spSampleEncode(samples + i, worker->buffer + worker->used);
+		}
+	}
+
+	flushBuffer(worker);
+	spFiarGameDestroy(game);
+}
+
+/*
+* Parses the arguments of the generator.
+* @param argc the number of arguments
+* @param argv the arguments
+* @param run the run to configure
+* @param threads set to the threads option, 0 if none
+* @return true iff the arguments are valid
+*/
+static bool parseOptions(int argc, char* argv[], SPSelfPlay* run, int* threads) {
+	int i;
+
+	if (argc < 4 || !spParserIsInt(argv[1]) || atol(argv[1]) <= 0 || !spParserIsInt(argv[2]) || atoi(argv[2]) <= 0) {
+		return false;
+	}
+
+	run->games = atol(argv[1]);
+	run->level = (unsigned int)atoi(argv[2]);
+
+	for (i = 4; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], SELFPLAY_RANDOM_OPTION) == 0 && spParserIsInt(argv[i + 1]) &&
+			atoi(argv[i + 1]) >= 0 && atoi(argv[i + 1]) <= 100) {
+			run->random = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], SELFPLAY_SEED_OPTION) == 0 && spParserIsInt(argv[i + 1]) && atol(argv[i + 1]) >= 0) {
+			run->seed = (unsigned long long)atol(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], SELFPLAY_THREADS_OPTION) == 0 && spParserIsInt(argv[i + 1]) && atoi(argv[i + 1]) > 0) {
+			*threads = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], SELFPLAY_MODE_OPTION) == 0 && spMinimaxParseMode(argv[i + 1], &run->config.mode)) {
+			continue;
+		}
+		else if (strcmp(argv[i], SELFPLAY_GEOMETRY_OPTION) == 0 &&
+			(run->geometry = spFiarGeometryFind(argv[i + 1])) != NULL) {
+			continue;
+		}
+		else {
+			return false;
+		}
+	}
+
+	return i == argc && spFiarCodecHasKeys(run->geometry);
+}
+
+int spSelfPlayMain(int argc, char* argv[]) {
+	SPSelfPlay run;
+	SPSelfPlayWorker* workers;
+	SPThreadPool* pool;
+	struct timespec start, end;
+	int threads = 0, i;
+	double ms;
+
+	spMinimaxConfigInit(&run.config);
+	run.geometry = spFiarGeometryGet(SP_FIAR_GEOMETRY_DEFAULT);
+	run.random = SELFPLAY_DEFAULT_RANDOM;
+	run.seed = 0;
+	run.next_game = 0;
+	run.samples = 0;
+	run.failed = false;
+
+	if (!parseOptions(argc, argv, &run, &threads)) {
+		printf("Usage: %s <games> <level> <output> [%s <percent>] [%s <n>] [%s <n>] [%s plain|pvs|mtdf|mcts] "
+			"[%s 7x6|8x7|connect5]\n", argv[0], SELFPLAY_RANDOM_OPTION, SELFPLAY_SEED_OPTION, SELFPLAY_THREADS_OPTION,
+			SELFPLAY_MODE_OPTION, SELFPLAY_GEOMETRY_OPTION);
+		return 1;
+	}
+
+	if (threads == 0) {
+		threads = spThreadPoolCountProcessors();
+	}
+
+	if ((run.output = fopen(argv[3], "wb")) == NULL || !spSampleWriteHeader(run.output, run.geometry)) {
+		printf("Error: cannot write %s\n", argv[3]);
+
+		if (run.output != NULL) {
+			fclose(run.output);
+		}
+
+		return 1;
+	}
+
+	workers = (SPSelfPlayWorker*)malloc(threads * sizeof(SPSelfPlayWorker));
+	pool = (void*)workers == NULL ? NULL : spThreadPoolCreate(threads, threads);
+
+	if ((void*)pool == NULL) {
+		printf("Error: malloc has failed\n");
+		free(workers);
+		fclose(run.output);
+		return 1;
+	}
+
+	pthread_mutex_init(&run.lock, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for (i = 0; i < threads; i++) {
+		workers[i].run = &run;
+		workers[i].used = 0;
+		spThreadPoolSubmit(pool, runWorker, workers + i);
+	}
+
+	spThreadPoolWait(pool);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	spThreadPoolDestroy(pool);
+	pthread_mutex_destroy(&run.lock);
+	free(workers);
+
+	if (fclose(run.output) != 0) {
+		run.failed = true;
+	}
+
+	if (run.failed) {
+		printf("Error: self-play into %s has failed\n", argv[3]);
+		return 1;
+	}
+
+	ms = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1000000.0;
+	printf("games %ld samples %lu threads %d ms %.2f samples/s %.0f\n", run.games, run.samples, threads, ms,
+		ms > 0 ? run.samples * 1000.0 / ms : 0.0);
+
+	return 0;
+}
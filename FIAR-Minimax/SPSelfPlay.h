@@ -0,0 +1,49 @@
+#ifndef SPSELFPLAY_H_
+#define SPSELFPLAY_H_
+
+#define SELFPLAY_COMMAND "selfplay"
+#define SELFPLAY_RANDOM_OPTION "--random"
+#define SELFPLAY_SEED_OPTION "--seed"
+#define SELFPLAY_THREADS_OPTION "--threads"
+#define SELFPLAY_MODE_OPTION "--mode"
+#define SELFPLAY_GEOMETRY_OPTION "--geometry"
+// the default percentage of random moves
+#define SELFPLAY_DEFAULT_RANDOM 10
+// the samples a thread buffers before writing them
+#define SELFPLAY_BUFFER_SAMPLES 4096
+
+/**
+ * SPSelfPlay Summary:
+ *
+ * Generates training samples (see SPSample.h) by self-play: the engine plays both
+ * sides of many games at a level, and every position it searches becomes a
+ * sample of its key, the score and best move of the search and the final result
+ * of the game. A percentage of the moves played are random instead of the best
+ * ones, so the games differ; the searched best move is still the one sampled.
+ *
+ * The games are played in parallel, by a thread per processor by default. A
+ * thread buffers the samples of its games and appends a full buffer to the file
+ * at once, so the memory is bounded by the threads and not by the games. The
+ * samples of a game are adjacent, the games are in no particular order. A game
+ * depends only on the seed and its number, so every run of the same options gives
+ * the same samples.
+ *
+ * The positions must have keys, which every geometry but 9x7 has.
+ *
+ * spSelfPlayMain  - Runs the generator
+ */
+
+/**
+ * Runs the generator. Usage: selfplay <games> <level> <output> [--random <percent>]
+ * [--seed <n>] [--threads <n>] [--mode <plain|pvs|mtdf|mcts>] [--geometry <7x6|8x7|connect5>]
+ * Prints the number of games and samples and the time taken.
+ *
+ * @param argc - the number of arguments, including the command name
+ * @param argv - the arguments, argv[0] is the command name
+ * @return
+ * 0 on success, 1 if the arguments are invalid, a search failed or the output
+ * can't be written
+ */
+int spSelfPlayMain(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,807 @@
+#define _POSIX_C_SOURCE 200809L
+#include "SPServer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "SPMainAux.h"     // the levels, history size and level prompt of the interactive game
+#include "SPThreadPool.h"
+
+#define LISTEN_BACKLOG 128
+#define INITIAL_SESSIONS 16
+#define INITIAL_OUTPUT_SIZE 256
+// a session with more output waiting for its client takes no commands until it is written
+#define PAUSE_OUTPUT_SIZE 4096
+// a session whose output would grow past it is disconnected, its client doesn't read
+#define MAX_OUTPUT_SIZE 65536
+
+/*
+* The state of a session.
+*/
+typedef enum sp_session_state_t {
+	SESSION_LEVEL,     // waits for the level line
+	SESSION_PLAYING,   // waits for a command line
+	SESSION_QUEUING,   // has a search to queue, the queue of the pool was full
+	SESSION_SEARCHING, // its search is queued or running
+	SESSION_CLOSING    // closes when its output is written
+} SP_SESSION_STATE;
+
+/*
+* The search a session waits for.
+*/
+typedef enum sp_session_search_t {
+	SEARCH_COMPUTER_MOVE,
+	SEARCH_SUGGESTION
+} SP_SESSION_SEARCH;
+
+typedef struct sp_server_t SPServer;
+
+typedef struct sp_session_t {
+	SPServer* server;
+	int fd;
+	bool disconnected;           // the connection is gone, the session is freed after its search
+	SP_SESSION_STATE state;
+	SPFiarGame* game;
+	unsigned int level;
+	char input[SP_MAX_LINE_LENGTH + 1];
+	size_t input_size;
+	char* output;
+	size_t output_size;
+	size_t output_capacity;
+	SP_SESSION_SEARCH search;
+	int search_move;             // the result of the search, -1 if it failed
+	bool search_degraded;        // the search was cut down to fit its memory
+	struct sp_session_t* next_done;
+} SPSession;
+
+struct sp_server_t {
+	int listen_fd;
+	int wake_fds[2];             // a worker writes to wake_fds[1] when a search is done
+	SPThreadPool* pool;
+	SPMinimaxConfig config;
+	const SPFiarGeometry* geometry;
+	SPSession** sessions;
+	int n_sessions;
+	int sessions_capacity;
+	pthread_mutex_t done_lock;
+	SPSession* done;             // the sessions whose search is done
+};
+
+static volatile sig_atomic_t stop_requested = 0;
+
+/*
+* Requests the server to stop. The handler of SIGINT and SIGTERM.
+*/
+static void requestStop(int signal_number) {
+	(void)signal_number;
+	stop_requested = 1;
+}
+
+/*
+* Appends a formatted line to the output of a session. A session whose output
+* would pass MAX_OUTPUT_SIZE is disconnected instead.
+* @param session the session
+* @param format the format of the line, as printf
+* @return false iff a memory allocation failure occurred or the session was disconnected
+*/
+static bool sessionPrint(SPSession* session, const char* format, ...) {
+	va_list args;
+	size_t capacity;
+	char* output;
+	int size;
+
+	va_start(args, format);
+	size = vsnprintf(NULL, 0, format, args);
+	va_end(args);
+
+	if (size < 0) {
+		return false;
+	}
+
+	if (session->output_size + size > MAX_OUTPUT_SIZE) {
+		session->disconnected = true;
+		return false;
+	}
+
+	if (session->output_size + size + 1 > session->output_capacity) {
+		for (capacity = session->output_capacity; session->output_size + size + 1 > capacity; capacity *= 2);
+
+		if ((output = (char*)realloc(session->output, capacity)) == NULL) {
+			return false;
+		}
+
+		session->output = output;
+		session->output_capacity = capacity;
+	}
+
+	va_start(args, format);
+	vsnprintf(session->output + session->output_size, size + 1, format, args);
+	va_end(args);
+	session->output_size += size;
+
+	return true;
+}
+
+/*
+* Writes as much of the output of a session as the socket takes.
+* @param session the session
+*/
+static void flushSession(SPSession* session) {
+	ssize_t written;
+
+	while (session->output_size > 0 && !session->disconnected) {
+		written = send(session->fd, session->output, session->output_size, MSG_NOSIGNAL);
+
+		if (written < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+				session->disconnected = true;
+			}
+
+			if (errno != EINTR) {
+				return;
+			}
+		}
+		else {
+			memmove(session->output, session->output + written, session->output_size - written);
+			session->output_size -= written;
+		}
+	}
+}
+
+/*
+* Creates a session of a new connection.
+* @param server the server
+* @param fd the socket of the connection
+* @return the session, NULL if a memory allocation failure occurred
+*/
+static SPSession* createSession(SPServer* server, int fd) {
+	SPSession* session = (SPSession*)calloc(1, sizeof(SPSession));
+
+	if (session == NULL) {
+		return NULL;
+	}
+
+	session->server = server;
+	session->fd = fd;
+	session->state = SESSION_LEVEL;
+	session->output_capacity = INITIAL_OUTPUT_SIZE;
+
+	if ((session->output = (char*)malloc(session->output_capacity)) == NULL ||
+		(session->game = spFiarGameCreateWithGeometry(HISTORY_SIZE, server->geometry)) == NULL) {
+		free(session->output);
+		free(session);
+		return NULL;
+	}
+
+	return session;
+}
+
+/*
+* Closes the connection of a session and frees it.
+* @param session the session
+*/
+static void destroySession(SPSession* session) {
+	close(session->fd);
+	spFiarGameDestroy(session->game);
+	free(session->output);
+	free(session);
+}
+
+/*
+* Runs the search of a session. The task of the pool.
+* @param arg the session
+*/
+static void runSearch(void* arg) {
+	SPSession* session = (SPSession*)arg;
+	SPServer* server = session->server;
+	SPMinimaxResult result;
+	char byte = 0;
+
+	session->search_move = spMinimaxSuggestMoveWithConfig(session->game, session->level, &server->config, &result);
+	session->search_degraded = session->search_move != -1 && result.degraded;
+
+	pthread_mutex_lock(&server->done_lock);
+	session->next_done = server->done;
+	server->done = session;
+	pthread_mutex_unlock(&server->done_lock);
+
+	// wake the polling thread, a full pipe already has a pending wake up
+	if (write(server->wake_fds[1], &byte, 1) < 0) {
+		return;
+	}
+}
+
+/*
+* Queues the search of a session, or marks it to be queued when the pool has room.
+* @param session the session
+* @param search the kind of search
+*/
+static void startSearch(SPSession* session, SP_SESSION_SEARCH search) {
+	session->search = search;
+
+	if (spThreadPoolTrySubmit(session->server->pool, runSearch, session) == SP_THREAD_POOL_SUCCESS) {
+		session->state = SESSION_SEARCHING;
+	}
+	else {
+		session->state = SESSION_QUEUING;
+	}
+}
+
+/*
+* Prints the end of the game of a session, if it has ended.
+* @param session the session
+* @return true iff the game has ended
+*/
+static bool printGameOver(SPSession* session) {
+	char winner = spFiarCheckWinner(session->game);
+
+	if (winner == '\0') {
+		return false;
+	}
+
+	sessionPrint(session, "over %s\n", winner == SP_FIAR_GAME_PLAYER_1_SYMBOL ? "win" :
+		(winner == SP_FIAR_GAME_PLAYER_2_SYMBOL ? "loss" : "tie"));
+
+	return true;
+}
+
+/*
+* Undoes the moves of a session back to the last move of the user: the user move
+* and the computer move after it, if there is one.
+* @param session the session
+*/
+static void undoUserMove(SPSession* session) {
+	SPFiarGame* game = session->game;
+	int last;
+
+	if (spArrayListIsEmpty(game->history)) {
+		sessionPrint(session, "error cannot undo previous move\n");
+		return;
+	}
+
+	last = spArrayListGetLast(game->history);
+	spFiarGameUndoPrevMove(game);
+
+	// the user plays the first player, a winning user move has no computer move after it
+	if (spFiarGameGetCurrentPlayer(game) == SP_FIAR_GAME_PLAYER_1_SYMBOL || spArrayListIsEmpty(game->history)) {
+		sessionPrint(session, "undo %d\n", last + 1);
+		return;
+	}
+
+	sessionPrint(session, "undo %d %d\n", last + 1, spArrayListGetLast(game->history) + 1);
+	spFiarGameUndoPrevMove(game);
+}
+
+/*
+* Handles a command line of a playing session.
+* @param session the session
+* @param line the line
+*/
+static void handleCommand(SPSession* session, const char* line) {
+	SPCommand cmd = spParserPraseLine(line);
+	SPFiarGame* game = session->game;
+	bool over = spFiarCheckWinner(game) != '\0';
+
+	switch (cmd.cmd) {
+	case SP_ADD_DISC:
+		if (over) {
+			sessionPrint(session, "error the game is over\n");
+		}
+		else if (!(cmd.arg >= 1 && cmd.arg <= game->geometry->columns)) {
+			sessionPrint(session, "error column number must be in range 1-%d\n", game->geometry->columns);
+		}
+		else if (spFiarGameSetMove(game, cmd.arg - 1) != SP_FIAR_GAME_SUCCESS) {
+			sessionPrint(session, "error column %d is full\n", cmd.arg);
+		}
+		else {
+			sessionPrint(session, "move %d\n", cmd.arg);
+
+			if (!printGameOver(session)) {
+				startSearch(session, SEARCH_COMPUTER_MOVE);
+			}
+		}
+		break;
+	case SP_SUGGEST_MOVE:
+		if (over) {
+			sessionPrint(session, "error the game is over\n");
+		}
+		else {
+			startSearch(session, SEARCH_SUGGESTION);
+		}
+		break;
+	case SP_UNDO_MOVE:
+		undoUserMove(session);
+		break;
+	case SP_RESTART:
+		spFiarGameReset(game, session->server->geometry);
+		sessionPrint(session, "restarted\n");
+		break;
+	case SP_QUIT:
+		sessionPrint(session, "bye\n");
+		session->state = SESSION_CLOSING;
+		break;
+	default:
+		sessionPrint(session, "error invalid command\n");
+		break;
+	}
+}
+
+/*
+* Handles a line of a session.
+* @param session the session
+* @param line the line
+*/
+static void handleLine(SPSession* session, const char* line) {
+	int level;
+
+	if (session->state != SESSION_LEVEL) {
+		handleCommand(session, line);
+		return;
+	}
+
+	if (spParserIsInt(line)) {
+		level = atoi(line);
+
+		if (level >= MIN_LEVEL && level <= MAX_LEVEL) {
+			session->level = level;
+			session->state = SESSION_PLAYING;
+			sessionPrint(session, "level %d\n", level);
+		}
+		else {
+			sessionPrint(session, "error invalid level (should be between %d to %d)\n", MIN_LEVEL, MAX_LEVEL);
+		}
+	}
+	else if (spParserPraseLine(line).cmd == SP_QUIT) {
+		sessionPrint(session, "bye\n");
+		session->state = SESSION_CLOSING;
+	}
+	else {
+		sessionPrint(session, "error invalid command\n");
+	}
+}
+
+/*
+* Checks if a session takes its next command: it waits for one, and its client
+* has read enough of its output. A client that sends commands without reading
+* the answers is not read anymore, like a session waiting for the queue.
+* @param session the session
+* @return true iff the session takes a command
+*/
+static bool takesCommands(SPSession* session) {
+	return (session->state == SESSION_LEVEL || session->state == SESSION_PLAYING) &&
+		session->output_size < PAUSE_OUTPUT_SIZE;
+}
+
+/*
+* Handles the complete lines of the input of a session, until it waits for a search.
+* @param session the session
+*/
+static void handleInput(SPSession* session) {
+	char* end;
+	size_t length;
+
+	while (takesCommands(session) && (end = (char*)memchr(session->input, '\n', session->input_size)) != NULL) {
+		*end = '\0';
+		length = end - session->input + 1;
+		handleLine(session, session->input);
+		memmove(session->input, session->input + length, session->input_size - length);
+		session->input_size -= length;
+	}
+
+	// a line longer than the protocol allows
+	if (session->input_size == SP_MAX_LINE_LENGTH && session->state != SESSION_CLOSING &&
+		memchr(session->input, '\n', session->input_size) == NULL) {
+		sessionPrint(session, "error invalid command\n");
+		session->state = SESSION_CLOSING;
+	}
+}
+
+/*
+* Reads the available input of a session.
+* @param session the session
+*/
+static void readSession(SPSession* session) {
+	ssize_t size;
+
+	while (session->input_size < SP_MAX_LINE_LENGTH) {
+		size = recv(session->fd, session->input + session->input_size, SP_MAX_LINE_LENGTH - session->input_size, 0);
+
+		if (size == 0 || (size < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+			session->disconnected = true;
+			return;
+		}
+
+		if (size < 0) {
+			if (errno != EINTR) {
+				return;
+			}
+		}
+		else {
+			session->input_size += size;
+
+			// a session waiting for a search reads nothing more than a line
+			if (memchr(session->input, '\n', session->input_size) != NULL) {
+				return;
+			}
+		}
+	}
+}
+
+/*
+* Applies the searches that are done.
+* @param server the server
+*/
+static void applySearches(SPServer* server) {
+	SPSession *session, *next;
+	char bytes[64];
+
+	while (read(server->wake_fds[0], bytes, sizeof(bytes)) > 0);
+
+	pthread_mutex_lock(&server->done_lock);
+	session = server->done;
+	server->done = NULL;
+	pthread_mutex_unlock(&server->done_lock);
+
+	for (; session != NULL; session = next) {
+		next = session->next_done;
+		session->state = SESSION_PLAYING;
+
+		if (session->disconnected) {
+			continue;
+		}
+
+		// a failed search is never degraded
+		if (session->search_degraded) {
+			sessionPrint(session, "degraded\n");
+		}
+
+		if (session->search_move == -1) {
+			sessionPrint(session, "error malloc has failed\n");
+			session->state = SESSION_CLOSING;
+		}
+		else if (session->search == SEARCH_SUGGESTION) {
+			sessionPrint(session, "suggest %d\n", session->search_move + 1);
+		}
+		else {
+			spFiarGameSetMove(session->game, session->search_move);
+			sessionPrint(session, "computer %d\n", session->search_move + 1);
+			printGameOver(session);
+		}
+
+		handleInput(session);
+	}
+}
+
+/*
+* Queues the searches that found the queue full, in the order of the sessions.
+* @param server the server
+*/
+static void queueWaitingSearches(SPServer* server) {
+	int i;
+
+	for (i = 0; i < server->n_sessions; i++) {
+		if (server->sessions[i]->state == SESSION_QUEUING) {
+			startSearch(server->sessions[i], server->sessions[i]->search);
+
+			if (server->sessions[i]->state == SESSION_QUEUING) {
+				return;
+			}
+		}
+	}
+}
+
+/*
+* Accepts the pending connections.
+* @param server the server
+*/
+static void acceptSessions(SPServer* server) {
+	SPSession** sessions;
+	SPSession* session;
+	int fd;
+
+	while ((fd = accept(server->listen_fd, NULL, NULL)) >= 0) {
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+		if (server->n_sessions == server->sessions_capacity) {
+			sessions = (SPSession**)realloc(server->sessions, 2 * server->sessions_capacity * sizeof(SPSession*));
+
+			if (sessions == NULL) {
+				close(fd);
+				continue;
+			}
+
+			server->sessions = sessions;
+			server->sessions_capacity *= 2;
+		}
+
+		if ((session = createSession(server, fd)) == NULL) {
+			close(fd);
+			continue;
+		}
+
+		sessionPrint(session, ENTER_LEVEL_STRING);
+		server->sessions[server->n_sessions++] = session;
+	}
+}
+
+/*
+* Frees the sessions that have ended, except for the ones whose search runs.
+* @param server the server
+*/
+static void removeEndedSessions(SPServer* server) {
+	SPSession* session;
+	int i, kept = 0;
+
+	for (i = 0; i < server->n_sessions; i++) {
+		session = server->sessions[i];
+
+		if (session->state == SESSION_CLOSING && session->output_size == 0) {
+			session->disconnected = true;
+		}
+
+		if (session->disconnected && session->state != SESSION_SEARCHING) {
+			destroySession(session);
+		}
+		else {
+			server->sessions[kept++] = session;
+		}
+	}
+
+	server->n_sessions = kept;
+}
+
+/*
+* Polls the sockets and serves the sessions until a stop is requested.
+* @param server the server
+* @return 0 on a requested stop, 1 on a failure of poll
+*/
+static int serve(SPServer* server) {
+	struct pollfd* fds = NULL, *grown;
+	int i, capacity = 0, n_fds, failed = 0;
+	SPSession* session;
+
+	while (!stop_requested && !failed) {
+		if (capacity < server->n_sessions + 2) {
+			if ((grown = (struct pollfd*)realloc(fds, 2 * (server->n_sessions + 2) * sizeof(struct pollfd))) == NULL) {
+				failed = 1;
+				break;
+			}
+
+			fds = grown;
+			capacity = 2 * (server->n_sessions + 2);
+		}
+
+		fds[0].fd = server->listen_fd;
+		fds[0].events = POLLIN;
+		fds[1].fd = server->wake_fds[0];
+		fds[1].events = POLLIN;
+
+		// a session is read only when it can take a command
+		for (i = 0; i < server->n_sessions; i++) {
+			session = server->sessions[i];
+			fds[i + 2].fd = session->fd;
+			fds[i + 2].events = (takesCommands(session) ? POLLIN : 0) | (session->output_size > 0 ? POLLOUT : 0);
+		}
+
+		n_fds = server->n_sessions + 2;
+
+		if (poll(fds, n_fds, -1) < 0) {
+			failed = errno != EINTR;
+			continue;
+		}
+
+		for (i = 0; i < n_fds - 2; i++) {
+			session = server->sessions[i];
+
+			if (fds[i + 2].revents & (POLLIN | POLLHUP | POLLERR)) {
+				readSession(session);
+				handleInput(session);
+			}
+		}
+
+		if (fds[1].revents & POLLIN) {
+			applySearches(server);
+		}
+
+		queueWaitingSearches(server);
+
+		// a session whose output was written may take the commands it has read
+		for (i = 0; i < server->n_sessions; i++) {
+			flushSession(server->sessions[i]);
+
+			if (!server->sessions[i]->disconnected) {
+				handleInput(server->sessions[i]);
+			}
+		}
+
+		removeEndedSessions(server);
+
+		if (fds[0].revents & POLLIN) {
+			acceptSessions(server);
+		}
+	}
+
+	free(fds);
+
+	return failed;
+}
+
+/*
+* Opens the listening socket of the server.
+* @param port the TCP port, if path is NULL
+* @param path the path of the Unix socket, or NULL
+* @return the socket, -1 on failure
+*/
+static int openListenSocket(int port, const char* path) {
+	struct sockaddr_in address;
+	struct sockaddr_un unix_address;
+	int fd, reuse = 1;
+
+	if (path != NULL) {
+		if (strlen(path) >= sizeof(unix_address.sun_path) || (fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+			return -1;
+		}
+
+		memset(&unix_address, 0, sizeof(unix_address));
+		unix_address.sun_family = AF_UNIX;
+		strcpy(unix_address.sun_path, path);
+		unlink(path);
+
+		if (bind(fd, (struct sockaddr*)&unix_address, sizeof(unix_address)) != 0) {
+			close(fd);
+			return -1;
+		}
+	}
+	else {
+		if ((fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+			return -1;
+		}
+
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_port = htons((unsigned short)port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		if (bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+			close(fd);
+			return -1;
+		}
+	}
+
+	if (listen(fd, LISTEN_BACKLOG) != 0) {
+		close(fd);
+		return -1;
+	}
+
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+	return fd;
+}
+
+/*
+* Parses the options of the server.
+* @param argc the number of arguments
+* @param argv the arguments
+* @param server the server to configure
+* @param port set to the port option
+* @param path set to the socket option, NULL if none
+* @param threads set to the threads option, 0 if none
+* @param queue_size set to the queue option
+* @return true iff the options are valid
+*/
+static bool parseOptions(int argc, char* argv[], SPServer* server, int* port, const char** path,
+	int* threads, int* queue_size) {
+	int i;
+
+	for (i = 1; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], SERVER_PORT_OPTION) == 0 && spParserIsInt(argv[i + 1]) &&
+			atoi(argv[i + 1]) > 0 && atoi(argv[i + 1]) < 65536) {
+			*port = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], SERVER_SOCKET_OPTION) == 0) {
+			*path = argv[i + 1];
+		}
+		else if (strcmp(argv[i], SERVER_THREADS_OPTION) == 0 && spParserIsInt(argv[i + 1]) && atoi(argv[i + 1]) > 0) {
+			*threads = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], SERVER_QUEUE_OPTION) == 0 && spParserIsInt(argv[i + 1]) && atoi(argv[i + 1]) > 0) {
+			*queue_size = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], SERVER_MODE_OPTION) == 0 && spMinimaxParseMode(argv[i + 1], &server->config.mode)) {
+			continue;
+		}
+		else if (strcmp(argv[i], SERVER_GEOMETRY_OPTION) == 0 && (server->geometry = spFiarGeometryFind(argv[i + 1])) != NULL) {
+			continue;
+		}
+		else if (strcmp(argv[i], SERVER_LEVELS_OPTION) == 0 && spMinimaxParseLevels(argv[i + 1], &server->config.levels)) {
+			continue;
+		}
+		else if (strcmp(argv[i], SERVER_MEMORY_OPTION) == 0 && spParserIsInt(argv[i + 1]) && atoi(argv[i + 1]) > 0) {
+			server->config.memoryLimit = (unsigned long)atoi(argv[i + 1]) << 20;
+		}
+		else {
+			return false;
+		}
+	}
+
+	return i == argc;
+}
+
+int spServerMain(int argc, char* argv[]) {
+	int port = SERVER_DEFAULT_PORT, threads = 0, queue_size = SERVER_DEFAULT_QUEUE_SIZE, result, i;
+	const char* path = NULL;
+	struct sigaction action;
+	SPServer server;
+
+	memset(&server, 0, sizeof(server));
+	spMinimaxConfigInit(&server.config);
+	server.geometry = spFiarGeometryGet(SP_FIAR_GEOMETRY_DEFAULT);
+
+	if (!parseOptions(argc, argv, &server, &port, &path, &threads, &queue_size)) {
+		printf("Usage: %s [%s <port> | %s <path>] [%s <n>] [%s <n>] [%s plain|pvs|mtdf|mcts] [%s 7x6|8x7|9x7|connect5] "
+			"[%s depth|nodes] [%s <MB>]\n", argv[0], SERVER_PORT_OPTION, SERVER_SOCKET_OPTION, SERVER_THREADS_OPTION,
+			SERVER_QUEUE_OPTION, SERVER_MODE_OPTION, SERVER_GEOMETRY_OPTION, SERVER_LEVELS_OPTION, SERVER_MEMORY_OPTION);
+		return 1;
+	}
+
+	if ((server.listen_fd = openListenSocket(port, path)) < 0) {
+		printf("Error: cannot listen on %s\n", path != NULL ? path : "the port");
+		return 1;
+	}
+
+	server.sessions_capacity = INITIAL_SESSIONS;
+	server.sessions = (SPSession**)malloc(server.sessions_capacity * sizeof(SPSession*));
+
+	if (server.sessions == NULL || pipe(server.wake_fds) != 0 ||
+		(server.pool = spThreadPoolCreate(threads, queue_size)) == NULL) {
+		printf("Error: cannot start the server\n");
+		free(server.sessions);
+		close(server.listen_fd);
+		return 1;
+	}
+
+	fcntl(server.wake_fds[0], F_SETFL, fcntl(server.wake_fds[0], F_GETFL) | O_NONBLOCK);
+	fcntl(server.wake_fds[1], F_SETFL, fcntl(server.wake_fds[1], F_GETFL) | O_NONBLOCK);
+	pthread_mutex_init(&server.done_lock, NULL);
+
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = requestStop;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	printf("serving %s %s on %s, %d threads\n", server.geometry->name, spMinimaxModeName(server.config.mode),
+		path != NULL ? path : "127.0.0.1", server.pool->n_threads);
+	fflush(stdout);
+
+	result = serve(&server);
+
+	// the running searches still use their sessions
+	spThreadPoolDestroy(server.pool);
+
+	for (i = 0; i < server.n_sessions; i++) {
+		destroySession(server.sessions[i]);
+	}
+
+	free(server.sessions);
+	pthread_mutex_destroy(&server.done_lock);
+	close(server.wake_fds[0]);
+	close(server.wake_fds[1]);
+	close(server.listen_fd);
+
+	if (path != NULL) {
+		unlink(path);
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef SPSERVER_H_
+#define SPSERVER_H_
+
+#define SERVER_COMMAND "serve"
+#define SERVER_DEFAULT_PORT 5555
+#define SERVER_DEFAULT_QUEUE_SIZE 64
+#define SERVER_PORT_OPTION "--port"
+#define SERVER_SOCKET_OPTION "--socket"
+#define SERVER_THREADS_OPTION "--threads"
+#define SERVER_QUEUE_OPTION "--queue"
+#define SERVER_MODE_OPTION "--mode"
+#define SERVER_GEOMETRY_OPTION "--geometry"
+#define SERVER_LEVELS_OPTION "--levels"
+#define SERVER_MEMORY_OPTION "--memory"
+
+/**
+ * SPServer Summary:
+ *
+ * A game server: every connection to a local TCP port (on 127.0.0.1) or a Unix
+ * socket is a session playing its own games against the computer, with a line
+ * protocol of the commands of the interactive game (see SPFIARParser.h).
+ *
+ * A session first gets a level line, an integer in [1-7]. Then every command line
+ * is answered by lines of:
+ *   move <col>      - the disc of the user was added
+ *   computer <col>  - the disc of the computer was added
+ *   suggest <col>   - the suggested move
+ *   undo <col> ...  - the columns of the discs removed
+ *   over <win|loss|tie> - the game has ended
+ *   restarted       - a new game started, with the same level
+ *   bye             - the session ends
+ *   error <message> - the command failed
+ *   degraded        - the next computer or suggest move was searched with less
+ *                     memory than its level asks (see --memory)
+ * Columns are 1-based.
+ *
+ * All sessions are served by a single thread polling their sockets. The engine
+ * searches run in a thread pool with a bounded queue. A session waits for its
+ * search before its next command is read, and a session whose search finds the
+ * queue full waits for room, so a loaded server stops reading commands instead
+ * of queuing without bound. In the same way, a session stops reading commands
+ * while its client leaves a few kilobytes of answers unread, and a session whose
+ * unread output would still pass 64 KB is disconnected.
+ *
+ * spServerMain  - Runs the server
+ */
+
+/**
+ * Runs the server until it is interrupted (SIGINT or SIGTERM).
+ * Usage: serve [--port <port> | --socket <path>] [--threads <n>] [--queue <n>]
+ *              [--mode <plain|pvs|mtdf|mcts>] [--geometry <7x6|8x7|9x7|connect5>]
+ *              [--levels <depth|nodes>] [--memory <MB>]
+ * The memory limit, in megabytes, is that of every search (see SPMinimaxConfig).
+ *
+ * @param argc - the number of arguments, including the command name
+ * @param argv - the arguments, argv[0] is the command name
+ * @return
+ * 0 on success, 1 if the arguments are invalid or the server can't be started
+ */
+int spServerMain(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,455 @@
+#include "SPSuite.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SPMinimax.h"
+#include "SPFIARParser.h"
+#include "SPFIARCodec.h"
+
+#define SUITE_HISTORY_SIZE SP_FIAR_CODEC_MAX_MOVES
+#define SUITE_N_MODES 4
+#define TEXT_FORMAT_NAME "text"
+#define CSV_FORMAT_NAME "csv"
+#define JSON_FORMAT_NAME "json"
+
+/*
+* The output formats of the suite.
+*/
+typedef enum sp_suite_format_t {
+	SP_SUITE_TEXT,
+	SP_SUITE_CSV,
+	SP_SUITE_JSON
+} SP_SUITE_FORMAT;
+
+/*
+* A position of the suite, a win or a draw for the player to move.
+*/
+typedef struct sp_suite_position_t {
+	const char* id;
+	const char* category;
+	const char* moves;   // the move string of the position, see SPFIARCodec.h
+	bool win;            // a win, otherwise a draw
+	const char* best;    // the correct moves, 1-based columns
+} SPSuitePosition;
+
+/*
+* The positions, solved by a perfect play solver.
+*/
+static const SPSuitePosition SUITE_POSITIONS[] = {
+	{ "early-1", "early", "", true, "4" },
+	{ "early-2", "early", "23134724", true, "2" },
+	{ "early-3", "early", "23554221", true, "47" },
+	{ "early-4", "early", "23722723", false, "26" },
+	{ "early-5", "early", "43566226", true, "246" },
+	{ "mid-1", "mid", "324611751351", true, "25" },
+	{ "mid-2", "mid", "751266515541", true, "26" },
+	{ "mid-3", "mid", "557733635457", false, "5" },
+	{ "mid-4", "mid", "562472772132", false, "4" },
+	{ "mid-5", "mid", "212547625754", true, "45" },
+	{ "mid-6", "mid", "255174725177", true, "56" },
+	{ "mid-7", "mid", "7452653527424144", true, "5" },
+	{ "mid-8", "mid", "3456412621257452", true, "5" },
+	{ "mid-9", "mid", "4271222561766677", true, "1267" },
+	{ "late-1", "late", "36516121633515272274", true, "356" },
+	{ "late-2", "late", "77713727752356435155", true, "1356" },
+	{ "late-3", "late", "27236677774437562432", true, "4" },
+	{ "late-4", "late", "34317455611621637651", true, "47" },
+	{ "late-5", "late", "57627331774521347411722656", true, "3" },
+	{ "late-6", "late", "11524625577411451252532127", true, "46" },
+	{ "late-7", "late", "76552524512257511112644641", true, "346" },
+	{ "late-8", "late", "266667612211561273541475235157", true, "34" },
+	{ "late-9", "late", "773445511611227577132462276541", true, "4" },
+	{ "tactical-1", "tactical", "521144121541", true, "6" },
+	{ "tactical-2", "tactical", "32727363174145", true, "45" },
+	{ "tactical-3", "tactical", "436617173675616", true, "45" },
+	{ "tactical-4", "tactical", "5261164457267341", true, "56" },
+	{ "tactical-5", "tactical", "617155221127627432", true, "6" },
+	{ "tactical-6", "tactical", "6464227356442457321", true, "6" },
+	{ "tactical-7", "tactical", "2213147722677122545", true, "45" },
+	{ "tactical-8", "tactical", "6465226322267427515", true, "13" },
+	{ "tactical-9", "tactical", "235662715564161757435", true, "37" },
+	{ "tactical-10", "tactical", "1256672772331257745365", true, "6" }
+};
+
+#define SUITE_N_POSITIONS ((int)(sizeof(SUITE_POSITIONS) / sizeof(SUITE_POSITIONS[0])))
+
+/*
+* A search of a position at a level.
+*/
+typedef struct sp_suite_search_t {
+	int move;
+	bool correct;
+	unsigned long nodes;
+	double ms;
+} SPSuiteSearch;
+
+/*
+* The searches of a position by a mode.
+*/
+typedef struct sp_suite_result_t {
+	SPSuiteSearch searches[SUITE_MAX_LEVELS];
+	int solve_level;              // 0 if unsolved
+	unsigned long solve_nodes;
+	double solve_ms;
+} SPSuiteResult;
+
+/*
+* A mode and its results.
+*/
+typedef struct sp_suite_run_t {
+	SP_MINIMAX_MODE mode;
+	SPSuiteResult results[SUITE_N_POSITIONS];
+	int solved;
+	unsigned long nodes;          // of all of the searches
+	double ms;
+} SPSuiteRun;
+
+/*
+* Returns the milliseconds of processor time since start.
+* @param start the start time
+* @return the milliseconds since start
+*/
+static double elapsedMs(clock_t start) {
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/*
+* Searches a position at every level and finds the level that solves it.
+* @param position the position
+* @param config the configuration of the searches
+* @param levels the maximal level
+* @param result set to the searches
+* @return true on success, false if the position is invalid or a search failed
+*/
+static bool runPosition(const SPSuitePosition* position, const SPMinimaxConfig* config, int levels,
+	SPSuiteResult* result) {
+	SPMinimaxResult search;
+	SPFiarGame* game;
+	clock_t start;
+	int level;
+
+	if ((game = spFiarCodecDecodeMoves(position->moves, spFiarGeometryGet(SP_FIAR_GEOMETRY_7X6),
+		SUITE_HISTORY_SIZE)) == NULL) {
+		return false;
+	}
+
+	for (level = 1; level <= levels; level++) {
+		start = clock();
+
+		if (spMinimaxSuggestMoveWithConfig(game, level, config, &search) == -1) {
+			spFiarGameDestroy(game);
+			return false;
+		}
+
+		result->searches[level - 1].ms = elapsedMs(start);
+		result->searches[level - 1].move = search.move;
+		result->searches[level - 1].nodes = search.nodes;
+		result->searches[level - 1].correct = strchr(position->best, '1' + search.move) != NULL;
+	}
+
+	spFiarGameDestroy(game);
+
+	// the lowest level from which every level is correct
+	for (result->solve_level = levels; result->solve_level >= 1 && result->searches[result->solve_level - 1].correct;
+		result->solve_level--);
+
+	result->solve_level = result->solve_level < levels ? result->solve_level + 1 : 0;
+	result->solve_nodes = 0;
+	result->solve_ms = 0;
+
+	for (level = 1; level <= result->solve_level; level++) {
+		result->solve_nodes += result->searches[level - 1].nodes;
+		result->solve_ms += result->searches[level - 1].ms;
+	}
+
+	return true;
+}
+
+/*
+* Runs every position with a mode.
+* @param run the run, its mode is set
+* @param levels the maximal level
+* @return true on success
+*/
+static bool runMode(SPSuiteRun* run, int levels) {
+	SPMinimaxConfig config;
+	int p, level;
+
+	spMinimaxConfigInit(&config);
+	config.mode = run->mode;
+	run->solved = 0;
+	run->nodes = 0;
+	run->ms = 0;
+
+	for (p = 0; p < SUITE_N_POSITIONS; p++) {
+		if (!runPosition(SUITE_POSITIONS + p, &config, levels, run->results + p)) {
+			printf("Error: search of position %s failed\n", SUITE_POSITIONS[p].id);
+			return false;
+		}
+
+		run->solved += run->results[p].solve_level > 0;
+
+		for (level = 0; level < levels; level++) {
+			run->nodes += run->results[p].searches[level].nodes;
+			run->ms += run->results[p].searches[level].ms;
+		}
+	}
+
+	return true;
+}
+
+/*
+* Writes the correctness of the searches of a result, a character per level.
+* @param result the result
+* @param levels the maximal level
+* @param correct the character of a correct move
+* @param wrong the character of a wrong move
+* @param dest the buffer, of SUITE_MAX_LEVELS + 1 characters at least
+*/
+static void formatLevels(const SPSuiteResult* result, int levels, char correct, char wrong, char* dest) {
+	int level;
+
+	for (level = 0; level < levels; level++) {
+		dest[level] = result->searches[level].correct ? correct : wrong;
+	}
+
+	dest[levels] = '\0';
+}
+
+/*
+* Writes the results as text tables.
+* @param out the output
+* @param runs the runs
+* @param n_runs the number of runs
+* @param levels the maximal level
+*/
+static void writeText(FILE* out, SPSuiteRun* runs, int n_runs, int levels) {
+	char marks[SUITE_MAX_LEVELS + 1];
+	const SPSuiteResult* result;
+	int r, p;
+
+	for (r = 0; r < n_runs; r++) {
+		fprintf(out, "mode %s\n", spMinimaxModeName(runs[r].mode));
+		fprintf(out, "%-12s %-9s %-5s %-5s %-12s %6s %12s %10s\n", "position", "category", "value", "best", "levels",
+			"solved", "nodes", "ms");
+
+		for (p = 0; p < SUITE_N_POSITIONS; p++) {
+			result = runs[r].results + p;
+			formatLevels(result, levels, '+', '-', marks);
+
+			if (result->solve_level > 0) {
+				fprintf(out, "%-12s %-9s %-5s %-5s %-12s %6d %12lu %10.2f\n", SUITE_POSITIONS[p].id,
+					SUITE_POSITIONS[p].category, SUITE_POSITIONS[p].win ? "win" : "draw", SUITE_POSITIONS[p].best,
+					marks, result->solve_level, result->solve_nodes, result->solve_ms);
+			}
+			else {
+				fprintf(out, "%-12s %-9s %-5s %-5s %-12s %6s %12s %10s\n", SUITE_POSITIONS[p].id,
+					SUITE_POSITIONS[p].category, SUITE_POSITIONS[p].win ? "win" : "draw", SUITE_POSITIONS[p].best,
+					marks, "-", "-", "-");
+			}
+		}
+
+		fprintf(out, "\n");
+	}
+
+	fprintf(out, "%-5s %8s %14s %10s %12s %14s\n", "mode", "solved", "nodes", "ms", "solved/s", "solved/Mnodes");
+
+	for (r = 0; r < n_runs; r++) {
+		fprintf(out, "%-5s %5d/%-2d %14lu %10.2f %12.3f %14.3f\n", spMinimaxModeName(runs[r].mode), runs[r].solved,
+			SUITE_N_POSITIONS, runs[r].nodes, runs[r].ms, runs[r].ms > 0 ? runs[r].solved * 1000.0 / runs[r].ms : 0.0,
+			runs[r].nodes > 0 ? runs[r].solved * 1000000.0 / runs[r].nodes : 0.0);
+	}
+}
+
+/*
+* Writes the results as CSV, a line per mode and position.
+* @param out the output
+* @param runs the runs
+* @param n_runs the number of runs
+* @param levels the maximal level
+*/
+static void writeCsv(FILE* out, SPSuiteRun* runs, int n_runs, int levels) {
+	char marks[SUITE_MAX_LEVELS + 1];
+	const SPSuiteResult* result;
+	int r, p;
+
+	fprintf(out, "mode,position,category,moves,value,best,levels,solve_level,solve_nodes,solve_ms\n");
+
+	for (r = 0; r < n_runs; r++) {
+		for (p = 0; p < SUITE_N_POSITIONS; p++) {
+			result = runs[r].results + p;
+			formatLevels(result, levels, '1', '0', marks);
+			fprintf(out, "%s,%s,%s,%s,%s,%s,%s,", spMinimaxModeName(runs[r].mode), SUITE_POSITIONS[p].id,
+				SUITE_POSITIONS[p].category, SUITE_POSITIONS[p].moves, SUITE_POSITIONS[p].win ? "win" : "draw",
+				SUITE_POSITIONS[p].best, marks);
+
+			// an unsolved position has empty solve fields
+			if (result->solve_level > 0) {
+				fprintf(out, "%d,%lu,%.3f\n", result->solve_level, result->solve_nodes, result->solve_ms);
+			}
+			else {
+				fprintf(out, ",,\n");
+			}
+		}
+	}
+}
+
+/*
+* Writes the results as a JSON document.
+* @param out the output
+* @param runs the runs
+* @param n_runs the number of runs
+* @param levels the maximal level
+*/
+static void writeJson(FILE* out, SPSuiteRun* runs, int n_runs, int levels) {
+	const SPSuiteResult* result;
+	const SPSuiteSearch* search;
+	int r, p, level;
+
+	fprintf(out, "{\n  \"geometry\": \"7x6\",\n  \"levels\": %d,\n  \"modes\": [", levels);
+
+	for (r = 0; r < n_runs; r++) {
+		fprintf(out, "%s\n    {\n      \"mode\": \"%s\",\n      \"solved\": %d,\n      \"positions\": %d,\n",
+			r > 0 ? "," : "", spMinimaxModeName(runs[r].mode), runs[r].solved, SUITE_N_POSITIONS);
+		fprintf(out, "      \"nodes\": %lu,\n      \"ms\": %.3f,\n      \"solved_per_second\": %.3f,\n",
+			runs[r].nodes, runs[r].ms, runs[r].ms > 0 ? runs[r].solved * 1000.0 / runs[r].ms : 0.0);
+		fprintf(out, "      \"solved_per_mnodes\": %.3f,\n      \"results\": [",
+			runs[r].nodes > 0 ? runs[r].solved * 1000000.0 / runs[r].nodes : 0.0);
+
+		for (p = 0; p < SUITE_N_POSITIONS; p++) {
+			result = runs[r].results + p;
+			fprintf(out, "%s\n        {\"position\": \"%s\", \"category\": \"%s\", \"moves\": \"%s\", "
+				"\"value\": \"%s\", \"best\": \"%s\", ", p > 0 ? "," : "", SUITE_POSITIONS[p].id,
+				SUITE_POSITIONS[p].category, SUITE_POSITIONS[p].moves, SUITE_POSITIONS[p].win ? "win" : "draw",
+				SUITE_POSITIONS[p].best);
+
+			if (result->solve_level > 0) {
+				fprintf(out, "\"solve_level\": %d, \"solve_nodes\": %lu, \"solve_ms\": %.3f,\n",
+					result->solve_level, result->solve_nodes, result->solve_ms);
+			}
+			else {
+				fprintf(out, "\"solve_level\": null, \"solve_nodes\": null, \"solve_ms\": null,\n");
+			}
+
+			fprintf(out, "         \"searches\": [");
+
+			for (level = 0; level < levels; level++) {
+				search = result->searches + level;
+				fprintf(out, "%s{\"level\": %d, \"move\": %d, \"correct\": %s, \"nodes\": %lu, \"ms\": %.3f}",
+					level > 0 ? ", " : "", level + 1, search->move + 1, search->correct ? "true" : "false",
+					search->nodes, search->ms);
+			}
+
+			fprintf(out, "]}");
+		}
+
+		fprintf(out, "\n      ]\n    }");
+	}
+
+	fprintf(out, "\n  ]\n}\n");
+}
+
+/*
+* Parses the name of an output format.
+* @param str the name
+* @param format set to the format on success
+* @return true iff str is the name of a format
+*/
+static bool parseFormat(const char* str, SP_SUITE_FORMAT* format) {
+	if (strcmp(str, TEXT_FORMAT_NAME) == 0)
+		*format = SP_SUITE_TEXT;
+	else if (strcmp(str, CSV_FORMAT_NAME) == 0)
+		*format = SP_SUITE_CSV;
+	else if (strcmp(str, JSON_FORMAT_NAME) == 0)
+		*format = SP_SUITE_JSON;
+	else
+		return false;
+
+	return true;
+}
+
+int spSuiteMain(int argc, char* argv[]) {
+	SP_MINIMAX_MODE all_modes[SUITE_N_MODES] = { SP_MINIMAX_MODE_PLAIN, SP_MINIMAX_MODE_PVS, SP_MINIMAX_MODE_MTDF,
+		SP_MINIMAX_MODE_MCTS };
+	SP_SUITE_FORMAT format = SP_SUITE_TEXT;
+	const char* output = NULL;
+	SPSuiteRun* runs;
+	FILE* out = stdout;
+	int levels = SUITE_DEFAULT_LEVELS, n_runs = 0, r, i;
+	bool valid = true;
+
+	if ((runs = (SPSuiteRun*)malloc(SUITE_N_MODES * sizeof(SPSuiteRun))) == NULL) {
+		printf("Error: malloc has failed\n");
+		return 1;
+	}
+
+	// every option is followed by its value
+	for (i = 1; i < argc && valid; i += 2) {
+		if (i + 1 == argc) {
+			valid = false;
+		}
+		else if (strcmp(argv[i], SUITE_LEVELS_OPTION) == 0 && spParserIsInt(argv[i + 1])) {
+			levels = atoi(argv[i + 1]);
+			valid = levels >= 1 && levels <= SUITE_MAX_LEVELS;
+		}
+		else if (strcmp(argv[i], SUITE_MODE_OPTION) == 0 && n_runs < SUITE_N_MODES) {
+			valid = spMinimaxParseMode(argv[i + 1], &runs[n_runs++].mode);
+		}
+		else if (strcmp(argv[i], SUITE_FORMAT_OPTION) == 0) {
+			valid = parseFormat(argv[i + 1], &format);
+		}
+		else if (strcmp(argv[i], SUITE_OUTPUT_OPTION) == 0) {
+			output = argv[i + 1];
+		}
+		else {
+			valid = false;
+		}
+	}
+
+	if (!valid) {
+		printf("Usage: %s [%s <1-%d>] [%s plain|pvs|mtdf|mcts]... [%s text|csv|json] [%s <file>]\n", argv[0],
+			SUITE_LEVELS_OPTION, SUITE_MAX_LEVELS, SUITE_MODE_OPTION, SUITE_FORMAT_OPTION, SUITE_OUTPUT_OPTION);
+		free(runs);
+		return 1;
+	}
+
+	// every mode by default
+	if (n_runs == 0) {
+		for (n_runs = 0; n_runs < SUITE_N_MODES; n_runs++) {
+			runs[n_runs].mode = all_modes[n_runs];
+		}
+	}
+
+	for (r = 0; r < n_runs && valid; r++) {
+		valid = runMode(runs + r, levels);
+	}
+
+	if (valid && output != NULL && (out = fopen(output, "w")) == NULL) {
+		printf("Error: cannot write %s\n", output);
+		valid = false;
+	}
+
+	if (valid) {
+		switch (format) {
+		case SP_SUITE_CSV:
+			writeCsv(out, runs, n_runs, levels);
+			break;
+		case SP_SUITE_JSON:
+			writeJson(out, runs, n_runs, levels);
+			break;
+		default:
+			writeText(out, runs, n_runs, levels);
+			break;
+		}
+
+		if (out != stdout && fclose(out) != 0) {
+			printf("Error: cannot write %s\n", output);
+			valid = false;
+		}
+	}
+
+	free(runs);
+
+	return valid ? 0 : 1;
+}
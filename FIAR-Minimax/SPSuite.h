@@ -0,0 +1,48 @@
+#ifndef SPSUITE_H_
+#define SPSUITE_H_
+
+#define SUITE_COMMAND "suite"
+#define SUITE_LEVELS_OPTION "--levels"
+#define SUITE_MODE_OPTION "--mode"
+#define SUITE_FORMAT_OPTION "--format"
+#define SUITE_OUTPUT_OPTION "--output"
+#define SUITE_DEFAULT_LEVELS 7
+#define SUITE_MAX_LEVELS 12
+
+/**
+ * SPSuite Summary:
+ *
+ * A test suite of 7x6 positions with known game-theoretic values, solved by
+ * perfect play, and a runner that measures how fast the engine finds their
+ * correct moves. The positions are in four categories: early, mid and late
+ * positions, and tactical ones with short forced wins. Every position is a win
+ * or a draw for the player to move, with some moves that throw it away. A correct
+ * move keeps the value: any winning move in a won position, any drawing move in
+ * a drawn one.
+ *
+ * Every position is searched at every level up to a maximal one, by every mode
+ * asked for. A position is solved at the lowest level from which every level gives
+ * a correct move; its nodes and time to solve are those of the searches up to that
+ * level, as an iterative deepening would spend them. The time is processor time.
+ * A mode gets the number of positions it solves per processor second and per
+ * million nodes; the node counts don't vary between runs.
+ *
+ * spSuiteMain  - Runs the suite
+ */
+
+/**
+ * Runs the suite. Usage: suite [--levels <n>] [--mode <plain|pvs|mtdf|mcts>]...
+ * [--format <text|csv|json>] [--output <file>]
+ * The modes are every mode by default. The csv format has a line per mode and
+ * position, the json format adds the searches of every level and the summary of
+ * every mode.
+ *
+ * @param argc - the number of arguments, including the command name
+ * @param argv - the arguments, argv[0] is the command name
+ * @return
+ * 0 on success, 1 if the arguments are invalid, a search failed or the output
+ * can't be written
+ */
+int spSuiteMain(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,202 @@
+#define _POSIX_C_SOURCE 200112L
+#include "SPThreadPool.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include "SPTrace.h"
+
+/*
+* Runs the tasks of a pool until it stops. The thread routine of the workers.
+*
+* @param arg the pool
+* @return NULL
+*/
+static void* runWorker(void* arg) {
+	SPThreadPool* pool = (SPThreadPool*)arg;
+	SPThreadPoolTaskEntry task;
+
+	pthread_mutex_lock(&pool->lock);
+
+	while (true) {
+		while (pool->size == 0 && !pool->stopping) {
+			pthread_cond_wait(&pool->not_empty, &pool->lock);
+		}
+
+		// the queued tasks are run before stopping
+		if (pool->size == 0) {
+			break;
+		}
+
+		task = pool->queue[pool->head];
+		pool->head = (pool->head + 1) % pool->capacity;
+		pool->size--;
+		pool->running++;
+		pthread_cond_signal(&pool->not_full);
+		pthread_mutex_unlock(&pool->lock);
+
+		SP_TRACE_BEGIN(task);
+		task.run(task.arg);
+		SP_TRACE_END(task, SP_TRACE_NO_ARG);
+
+		pthread_mutex_lock(&pool->lock);
+		pool->running--;
+
+		if (pool->size == 0 && pool->running == 0) {
+			pthread_cond_broadcast(&pool->idle);
+		}
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+
+	return NULL;
+}
+
+int spThreadPoolCountProcessors() {
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return count < 1 ? 1 : (int)count;
+}
+
+/*
+* Stops the first threads of a pool and frees it.
+*
+* @param pool the pool
+* @param started the number of threads started
+*/
+static void stopPool(SPThreadPool* pool, int started) {
+	int i;
+
+	pthread_mutex_lock(&pool->lock);
+	pool->stopping = true;
+	pthread_cond_broadcast(&pool->not_empty);
+	pthread_mutex_unlock(&pool->lock);
+
+	for (i = 0; i < started; i++) {
+		pthread_join(pool->threads[i], NULL);
+	}
+
+	pthread_cond_destroy(&pool->idle);
+	pthread_cond_destroy(&pool->not_full);
+	pthread_cond_destroy(&pool->not_empty);
+	pthread_mutex_destroy(&pool->lock);
+	free(pool->threads);
+	free(pool->queue);
+	free(pool);
+}
+
+SPThreadPool* spThreadPoolCreate(int threads, int queueSize) {
+	SPThreadPool* pool;
+	int i;
+
+	if (threads < 0 || queueSize <= 0) {
+		return NULL;
+	}
+
+	if (threads == 0) {
+		threads = spThreadPoolCountProcessors();
+	}
+
+	if ((pool = (SPThreadPool*)calloc(1, sizeof(SPThreadPool))) == NULL) {
+		return NULL;
+	}
+
+	pool->threads = (pthread_t*)malloc(threads * sizeof(pthread_t));
+	pool->queue = (SPThreadPoolTaskEntry*)malloc(queueSize * sizeof(SPThreadPoolTaskEntry));
+
+	if (pool->threads == NULL || pool->queue == NULL) {
+		free(pool->threads);
+		free(pool->queue);
+		free(pool);
+		return NULL;
+	}
+
+	pool->n_threads = threads;
+	pool->capacity = queueSize;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->not_empty, NULL);
+	pthread_cond_init(&pool->not_full, NULL);
+	pthread_cond_init(&pool->idle, NULL);
+
+	for (i = 0; i < threads; i++) {
+		if (pthread_create(pool->threads + i, NULL, runWorker, pool) != 0) {
+			stopPool(pool, i);
+			return NULL;
+		}
+	}
+
+	return pool;
+}
+
+/*
+* Queues a task.
+* Assumes the lock is held and the queue has room.
+*
+* @param pool the pool
+* @param run the task function
+* @param arg the argument of the task
+*/
+static void enqueue(SPThreadPool* pool, SPThreadPoolTask run, void* arg) {
+	SPThreadPoolTaskEntry* task = pool->queue + (pool->head + pool->size) % pool->capacity;
+
+	task->run = run;
+	task->arg = arg;
+	pool->size++;
+	pthread_cond_signal(&pool->not_empty);
+}
+
+SP_THREAD_POOL_MESSAGE spThreadPoolSubmit(SPThreadPool* pool, SPThreadPoolTask run, void* arg) {
+	if ((void*)pool == NULL || run == NULL) {
+		return SP_THREAD_POOL_INVALID_ARGUMENT;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+
+	while (pool->size == pool->capacity) {
+		pthread_cond_wait(&pool->not_full, &pool->lock);
+	}
+
+	enqueue(pool, run, arg);
+	pthread_mutex_unlock(&pool->lock);
+
+	return SP_THREAD_POOL_SUCCESS;
+}
+
+SP_THREAD_POOL_MESSAGE spThreadPoolTrySubmit(SPThreadPool* pool, SPThreadPoolTask run, void* arg) {
+	SP_THREAD_POOL_MESSAGE msg = SP_THREAD_POOL_FULL;
+
+	if ((void*)pool == NULL || run == NULL) {
+		return SP_THREAD_POOL_INVALID_ARGUMENT;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+
+	if (pool->size < pool->capacity) {
+		enqueue(pool, run, arg);
+		msg = SP_THREAD_POOL_SUCCESS;
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+
+	return msg;
+}
+
+void spThreadPoolWait(SPThreadPool* pool) {
+	if ((void*)pool == NULL) {
+		return;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+
+	while (pool->size > 0 || pool->running > 0) {
+		pthread_cond_wait(&pool->idle, &pool->lock);
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+}
+
+void spThreadPoolDestroy(SPThreadPool* pool) {
+	if ((void*)pool == NULL) {
+		return;
+	}
+
+	stopPool(pool, pool->n_threads);
+}
@@ -0,0 +1,109 @@
+#ifndef SPTHREADPOOL_H_
+#define SPTHREADPOOL_H_
+#include <stdbool.h>
+#include <pthread.h>
+
+/**
+ * SPThreadPool Summary:
+ *
+ * A fixed number of worker threads running tasks from a bounded queue. A task is
+ * a function and its argument. When the queue is full a submission either waits
+ * for room (back-pressure on the submitter) or fails at once.
+ *
+ * spThreadPoolCreate     - Creates a pool and starts its threads
+ * spThreadPoolSubmit     - Queues a task, waits while the queue is full
+ * spThreadPoolTrySubmit  - Queues a task if the queue has room
+ * spThreadPoolWait       - Waits until all queued tasks are done
+ * spThreadPoolDestroy    - Finishes the queued tasks, stops the threads and frees the pool
+ */
+
+/**
+ * Type used for returning error codes from pool functions
+ */
+typedef enum sp_thread_pool_message_t {
+	SP_THREAD_POOL_INVALID_ARGUMENT,
+	SP_THREAD_POOL_FULL,
+	SP_THREAD_POOL_SUCCESS
+} SP_THREAD_POOL_MESSAGE;
+
+typedef void (*SPThreadPoolTask)(void* arg);
+
+typedef struct sp_thread_pool_task_t {
+	SPThreadPoolTask run;
+	void* arg;
+} SPThreadPoolTaskEntry;
+
+typedef struct sp_thread_pool_t {
+	pthread_t* threads;
+	int n_threads;
+	SPThreadPoolTaskEntry* queue; // a ring buffer
+	int capacity;
+	int head;                     // the index of the next task
+	int size;                     // the number of queued tasks
+	int running;                  // the number of tasks being run
+	bool stopping;
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;     // signaled when a task is queued or the pool stops
+	pthread_cond_t not_full;      // signaled when a task is taken
+	pthread_cond_t idle;          // signaled when the last task is done
+} SPThreadPool;
+
+/**
+ * Creates a pool and starts its threads.
+ *
+ * @param threads - the number of threads, 0 for the number of processors
+ * @param queueSize - the maximal number of queued tasks
+ * @return
+ * NULL if threads < 0, queueSize <= 0, a thread can't be started or a memory
+ * allocation failure occurred. Otherwise, the pool.
+ */
+SPThreadPool* spThreadPoolCreate(int threads, int queueSize);
+
+/**
+ * Queues a task, waiting while the queue is full.
+ *
+ * @param pool - the pool
+ * @param run - the task function, called with arg by a worker thread
+ * @param arg - the argument of the task
+ * @return
+ * SP_THREAD_POOL_INVALID_ARGUMENT - if pool or run is NULL
+ * SP_THREAD_POOL_SUCCESS          - otherwise
+ */
+SP_THREAD_POOL_MESSAGE spThreadPoolSubmit(SPThreadPool* pool, SPThreadPoolTask run, void* arg);
+
+/**
+ * Queues a task if the queue has room.
+ *
+ * @param pool - the pool
+ * @param run - the task function, called with arg by a worker thread
+ * @param arg - the argument of the task
+ * @return
+ * SP_THREAD_POOL_INVALID_ARGUMENT - if pool or run is NULL
+ * SP_THREAD_POOL_FULL             - if the queue is full, the task isn't queued
+ * SP_THREAD_POOL_SUCCESS          - otherwise
+ */
+SP_THREAD_POOL_MESSAGE spThreadPoolTrySubmit(SPThreadPool* pool, SPThreadPoolTask run, void* arg);
+
+/**
+ * Waits until the queue is empty and no task is running.
+ *
+ * @param pool - the pool, if NULL nothing happens
+ */
+void spThreadPoolWait(SPThreadPool* pool);
+
+/**
+ * Runs the queued tasks, stops the threads and frees the pool.
+ *
+ * @param pool - the pool, if NULL nothing happens
+ */
+void spThreadPoolDestroy(SPThreadPool* pool);
+
+/**
+ * Returns the number of processors online.
+ *
+ * @return
+ * the number of processors, at least 1
+ */
+int spThreadPoolCountProcessors();
+
+#endif
@@ -0,0 +1,210 @@
+#include "SPThreatParity.h"
+#include <string.h>
+
+#define PLAYER_1_BIT 1
+#define PLAYER_2_BIT 2
+
+// the counters are shared by the threads of a parallel search and updated atomically
+#define ATOMIC_ADD(p, v) __atomic_fetch_add(p, v, __ATOMIC_RELAXED)
+#define ATOMIC_LOAD(p) __atomic_load_n(p, __ATOMIC_RELAXED)
+#define ATOMIC_STORE(p, v) __atomic_store_n(p, v, __ATOMIC_RELAXED)
+
+static SPThreatParityStats stats = { 0, 0 };
+
+/*
+* The 4 directions of a span: row, column, diagonal of type / and diagonal of type '\'.
+*/
+static const int DIRECTIONS[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+
+/*
+* Finds the players who have a span in which every cell is marked with their bit.
+* The board cells are bit masks of the players which may own the cell.
+*
+* @param geometry the geometry of the board
+* @param board the marked board
+* @param bits the bits of the players to look for
+* @return the bits of the players with such a span
+*/
+static char getFullSpans(const SPFiarGeometry* geometry, char board[SP_FIAR_GAME_MAX_ROWS][SP_FIAR_GAME_MAX_COLUMNS], char bits) {
+	int i, j, d, m, row, col;
+	char found = 0, span_bits;
+
+	for (d = 0; d < 4; d++) {
+		for (i = 0; i < geometry->rows; i++) {
+			for (j = 0; j < geometry->columns; j++) {
+				row = i + DIRECTIONS[d][0] * (geometry->span - 1);
+				col = j + DIRECTIONS[d][1] * (geometry->span - 1);
+
+				if (row >= geometry->rows || col < 0 || col >= geometry->columns) {
+					continue;
+				}
+
+				// a single pass over the span serves both players
+				span_bits = bits & ~found;
+
+				for (m = 0; m < geometry->span && span_bits != 0; m++) {
+					span_bits &= board[i + DIRECTIONS[d][0] * m][j + DIRECTIONS[d][1] * m];
+				}
+
+				if ((found |= span_bits) == bits) {
+					return found;
+				}
+			}
+		}
+	}
+
+	return found;
+}
+
+/*
+* Returns the bit of a player.
+* @param symbol the symbol of the player
+* @return the bit of the player
+*/
+static char getPlayerBit(char symbol) {
+	return symbol == SP_FIAR_GAME_PLAYER_1_SYMBOL ? PLAYER_1_BIT : PLAYER_2_BIT;
+}
+
+/*
+* Marks the discs on the board with the bit of their player.
+* Assumes src is not null.
+*
+* @param src the game
+* @param board the board to mark, every empty cell is set to empty_bits
+* @param empty_bits the bits to set the empty cells to
+*/
+static void markDiscs(SPFiarGame* src, char board[SP_FIAR_GAME_MAX_ROWS][SP_FIAR_GAME_MAX_COLUMNS], char empty_bits) {
+	int i, j;
+
+	for (i = 0; i < src->geometry->rows; i++) {
+		for (j = 0; j < src->geometry->columns; j++) {
+			if ((src->gameBoard)[i][j] == SP_FIAR_GAME_PLAYER_1_SYMBOL) {
+				board[i][j] = PLAYER_1_BIT;
+			}
+			else if ((src->gameBoard)[i][j] == SP_FIAR_GAME_PLAYER_2_SYMBOL) {
+				board[i][j] = PLAYER_2_BIT;
+			}
+			else {
+				board[i][j] = empty_bits;
+			}
+		}
+	}
+}
+
+/*
+* Checks if a column has room for a vertical span, which both players can still
+* complete: a cheap test that rules a draw out.
+* Assumes src is not null.
+*
+* @param src the game
+* @return true iff some column has at least a span of empty cells
+*/
+static bool hasOpenColumn(SPFiarGame* src) {
+	int j;
+
+	for (j = 0; j < src->geometry->columns; j++) {
+		if (src->geometry->rows - (src->tops)[j] >= src->geometry->span) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+* Finds the players who can still complete a span, taking every empty cell.
+* Assumes src is not null.
+*
+* @param src the game
+* @return the bits of the players who can still win
+*/
+static char getOpenPlayers(SPFiarGame* src) {
+	char board[SP_FIAR_GAME_MAX_ROWS][SP_FIAR_GAME_MAX_COLUMNS];
+
+	// every empty cell may still be taken by both players
+	markDiscs(src, board, PLAYER_1_BIT | PLAYER_2_BIT);
+
+	return getFullSpans(src->geometry, board, PLAYER_1_BIT | PLAYER_2_BIT);
+}
+
+/*
+* Applies the claimeven rule: if every column has an even number of empty cells
+* the follower can get every cell at an odd distance above the column tops,
+* answering every move in the same column, and leave the player to move at most
+* the cells at an even distance. The board is filled that way.
+* Assumes src is not null.
+*
+* @param src the game
+* @param mover_bit the bit of the player to move
+* @return the bits of the players with a span on the filled board, or
+*         PLAYER_1_BIT | PLAYER_2_BIT if some column has an odd number of empty cells
+*/
+static char getClaimevenSpans(SPFiarGame* src, char mover_bit) {
+	char board[SP_FIAR_GAME_MAX_ROWS][SP_FIAR_GAME_MAX_COLUMNS], follower_bit;
+	int i, j;
+
+	for (j = 0; j < src->geometry->columns; j++) {
+		if ((src->geometry->rows - (src->tops)[j]) % 2 != 0) {
+			return PLAYER_1_BIT | PLAYER_2_BIT;
+		}
+	}
+
+	follower_bit = mover_bit == PLAYER_1_BIT ? PLAYER_2_BIT : PLAYER_1_BIT;
+	markDiscs(src, board, 0);
+
+	for (j = 0; j < src->geometry->columns; j++) {
+		for (i = (src->tops)[j]; i < src->geometry->rows; i++) {
+			board[i][j] = (i - (src->tops)[j]) % 2 == 0 ? mover_bit : follower_bit;
+		}
+	}
+
+	return getFullSpans(src->geometry, board, PLAYER_1_BIT | PLAYER_2_BIT);
+}
+
+SP_THREAT_PARITY_RESULT spThreatParityAnalyze(SPFiarGame* src) {
+	SP_THREAT_PARITY_RESULT result = SP_THREAT_PARITY_UNKNOWN;
+	char mover_bit, follower_bit, claimeven;
+
+	if ((void*)src == NULL) {
+		return SP_THREAT_PARITY_UNKNOWN;
+	}
+
+	ATOMIC_ADD(&stats.probes, 1);
+
+	mover_bit = getPlayerBit(spFiarGameGetCurrentPlayer(src));
+	follower_bit = mover_bit == PLAYER_1_BIT ? PLAYER_2_BIT : PLAYER_1_BIT;
+	claimeven = getClaimevenSpans(src, mover_bit);
+
+	// unless claimeven leaves the player to move a span, the follower can't lose
+	if (!(claimeven & mover_bit)) {
+		if (claimeven & follower_bit) {
+			result = follower_bit == PLAYER_1_BIT ? SP_THREAT_PARITY_PLAYER_1_WINS : SP_THREAT_PARITY_PLAYER_2_WINS;
+		}
+		else if (!hasOpenColumn(src) && !(getOpenPlayers(src) & follower_bit)) {
+			result = SP_THREAT_PARITY_DRAW;
+		}
+	}
+	else if (!hasOpenColumn(src) && getOpenPlayers(src) == 0) {
+		result = SP_THREAT_PARITY_DRAW;
+	}
+
+	if (result != SP_THREAT_PARITY_UNKNOWN) {
+		ATOMIC_ADD(&stats.resolved, 1);
+	}
+
+	return result;
+}
+
+void spThreatParityGetStats(SPThreatParityStats* dst) {
+	if (dst == NULL) {
+		return;
+	}
+
+	dst->probes = ATOMIC_LOAD(&stats.probes);
+	dst->resolved = ATOMIC_LOAD(&stats.resolved);
+}
+
+void spThreatParityResetStats() {
+	ATOMIC_STORE(&stats.probes, 0);
+	ATOMIC_STORE(&stats.resolved, 0);
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef SPTHREATPARITY_H_
+#define SPTHREATPARITY_H_
+
+#include "SPFIARGame.h"
+
+/**
+ * SPThreatParity Summary:
+ *
+ * A static analyzer that proves the outcome of some connect-4 positions without
+ * searching them, based on the row parity of the empty cells (zugzwang).
+ *
+ * When every column has an even number of empty cells, the player who is not to
+ * move (the follower) can always answer in the column the other player just
+ * played in. Doing so the follower gets every empty cell at an odd distance above
+ * its column top, and the player to move gets every cell at an even distance.
+ * If in the board filled that way the follower has a FIAR and the player to
+ * move has none, the follower wins, whatever the player to move does. If neither
+ * has one there, and the follower can't complete a span even with every empty
+ * cell, the game is a draw. A board in which no span of cells can be completed
+ * by either player is a draw too.
+ *
+ * Only rules that are sound in every position are applied, so a proven result is
+ * the real game-theoretic value of the position and may replace any search score.
+ *
+ * spThreatParityAnalyze       - Tries to prove the result of a position
+ * spThreatParityGetStats      - Returns the analyzer counters
+ * spThreatParityResetStats    - Resets the analyzer counters
+ */
+
+// the minimal remaining search depth for which a search should try the analyzer
+#define SP_THREAT_PARITY_MIN_DEPTH 3
+
+/**
+ * Type used for returning the result of the analysis
+ */
+typedef enum sp_threat_parity_result_t {
+	SP_THREAT_PARITY_UNKNOWN,
+	SP_THREAT_PARITY_PLAYER_1_WINS,
+	SP_THREAT_PARITY_PLAYER_2_WINS,
+	SP_THREAT_PARITY_DRAW
+} SP_THREAT_PARITY_RESULT;
+
+/**
+ * Counters of the analyzer, accumulated over all calls of spThreatParityAnalyze
+ * in every thread
+ */
+typedef struct sp_threat_parity_stats_t {
+	unsigned long probes;   // number of analyzed positions
+	unsigned long resolved; // number of positions with a proven result
+} SPThreatParityStats;
+
+/**
+ * Tries to prove the game-theoretic result of the specified position.
+ * The game is not changed. A game that has ended is not checked for first: the
+ * rules only prove its real result, if they prove one at all.
+ *
+ * @param src - the source game
+ * @return
+ * SP_THREAT_PARITY_UNKNOWN        - if src == NULL or nothing was proven
+ * SP_THREAT_PARITY_PLAYER_1_WINS  - if player 1 wins with perfect play
+ * SP_THREAT_PARITY_PLAYER_2_WINS  - if player 2 wins with perfect play
+ * SP_THREAT_PARITY_DRAW           - if neither player can win anymore
+ */
+SP_THREAT_PARITY_RESULT spThreatParityAnalyze(SPFiarGame* src);
+
+/**
+ * Copies the analyzer counters.
+ *
+ * @param stats - where to copy the counters to, nothing happens if stats == NULL
+ */
+void spThreatParityGetStats(SPThreatParityStats* stats);
+
+/**
+ * Resets the analyzer counters to zero.
+ */
+void spThreatParityResetStats();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,192 @@
+#define _POSIX_C_SOURCE 200112L
+#include "SPTrace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+/*
+* A recorded event, its times in nanoseconds.
+*/
+typedef struct sp_trace_event_t {
+	const char* name;
+	unsigned long long start;
+	unsigned long long end;
+	int arg;
+} SPTraceEvent;
+
+/*
+* The ring buffer of a thread. Only its owner writes its events.
+*/
+typedef struct sp_trace_buffer_t {
+	SPTraceEvent events[SP_TRACE_BUFFER_EVENTS];
+	unsigned long long count;        // the events ever recorded, published by release stores
+	bool owned;                      // a live thread records into the buffer
+	int tid;                         // the track of the buffer
+	struct sp_trace_buffer_t* next;  // the next buffer of the list
+} SPTraceBuffer;
+
+static bool enabled = false;
+static unsigned long long origin = 0;   // the time of spTraceStart
+static SPTraceBuffer* buffers = NULL;   // every buffer, pushed without a lock
+static int n_buffers = 0;
+static pthread_key_t buffer_key;        // the buffer of the calling thread
+
+/*
+* Returns the monotonic time.
+* @return the time in nanoseconds
+*/
+static unsigned long long getTime(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+/*
+* Returns the buffer of the calling thread: its own, a released one or a new one.
+* @return the buffer, NULL if a memory allocation failure occurred
+*/
+static SPTraceBuffer* getBuffer(void) {
+	SPTraceBuffer* buffer = (SPTraceBuffer*)pthread_getspecific(buffer_key);
+	bool owned;
+
+	if (buffer != NULL) {
+		return buffer;
+	}
+
+	for (buffer = __atomic_load_n(&buffers, __ATOMIC_ACQUIRE); buffer != NULL; buffer = buffer->next) {
+		owned = false;
+
+		if (__atomic_compare_exchange_n(&buffer->owned, &owned, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			break;
+		}
+	}
+
+	if (buffer == NULL) {
+		if ((buffer = (SPTraceBuffer*)malloc(sizeof(SPTraceBuffer))) == NULL) {
+			return NULL;
+		}
+
+		buffer->count = 0;
+		buffer->owned = true;
+		buffer->tid = __atomic_add_fetch(&n_buffers, 1, __ATOMIC_RELAXED);
+		buffer->next = __atomic_load_n(&buffers, __ATOMIC_RELAXED);
+
+		while (!__atomic_compare_exchange_n(&buffers, &buffer->next, buffer, true, __ATOMIC_RELEASE,
+			__ATOMIC_RELAXED));
+	}
+
+	pthread_setspecific(buffer_key, buffer);
+
+	return buffer;
+}
+
+#ifdef SP_TRACE
+static const char* trace_path = NULL;   // the file written at exit
+
+/*
+* Gives up the buffer of an exiting thread, for a later thread to take.
+* @param arg the buffer
+*/
+static void releaseBuffer(void* arg) {
+	__atomic_store_n(&((SPTraceBuffer*)arg)->owned, false, __ATOMIC_RELEASE);
+}
+
+/*
+* Stops recording and writes the trace file. Runs at exit.
+*/
+static void writeAtExit(void) {
+	__atomic_store_n(&enabled, false, __ATOMIC_RELEASE);
+
+	if (!spTraceWrite(trace_path)) {
+		printf("Error: cannot write the trace %s\n", trace_path);
+	}
+}
+#endif
+
+void spTraceStart(const char* path) {
+#ifdef SP_TRACE
+	if (path == NULL || trace_path != NULL || pthread_key_create(&buffer_key, releaseBuffer) != 0) {
+		return;
+	}
+
+	trace_path = path;
+	origin = getTime();
+	atexit(writeAtExit);
+	__atomic_store_n(&enabled, true, __ATOMIC_RELEASE);
+#else
+	(void)path;
+#endif
+}
+
+bool spTraceIsEnabled(void) {
+	return __atomic_load_n(&enabled, __ATOMIC_ACQUIRE);
+}
+
+unsigned long long spTraceNow(void) {
+	if (!spTraceIsEnabled()) {
+		return 0;
+	}
+
+	// a thread takes its track at its first event, the tracks of running threads differ
+	getBuffer();
+
+	return getTime();
+}
+
+void spTraceEvent(const char* name, unsigned long long start, int arg) {
+	SPTraceBuffer* buffer;
+	SPTraceEvent* event;
+
+	if (start == 0 || (buffer = getBuffer()) == NULL) {
+		return;
+	}
+
+	event = &buffer->events[buffer->count % SP_TRACE_BUFFER_EVENTS];
+	event->name = name;
+	event->start = start;
+	event->end = getTime();
+	event->arg = arg;
+	__atomic_store_n(&buffer->count, buffer->count + 1, __ATOMIC_RELEASE);
+}
+
+bool spTraceWrite(const char* path) {
+	SPTraceBuffer* buffer;
+	SPTraceEvent* event;
+	unsigned long long count, i;
+	FILE* out;
+	bool succeeded;
+
+	if (path == NULL || (out = fopen(path, "w")) == NULL) {
+		return false;
+	}
+
+	fprintf(out, "{\"traceEvents\":[\n");
+	fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"FIAR-Minimax\"}}");
+
+	for (buffer = __atomic_load_n(&buffers, __ATOMIC_ACQUIRE); buffer != NULL; buffer = buffer->next) {
+		count = __atomic_load_n(&buffer->count, __ATOMIC_ACQUIRE);
+		fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+			buffer->tid, buffer->tid);
+
+		// the oldest kept event first
+		for (i = count > SP_TRACE_BUFFER_EVENTS ? count - SP_TRACE_BUFFER_EVENTS : 0; i < count; i++) {
+			event = &buffer->events[i % SP_TRACE_BUFFER_EVENTS];
+			fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f", event->name,
+				buffer->tid, (event->start - origin) / 1000.0, (event->end - event->start) / 1000.0);
+
+			if (event->arg != SP_TRACE_NO_ARG) {
+				fprintf(out, ",\"args\":{\"arg\":%d}", event->arg);
+			}
+
+			fprintf(out, "}");
+		}
+	}
+
+	fprintf(out, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	succeeded = !ferror(out);
+
+	return fclose(out) == 0 && succeeded;
+}
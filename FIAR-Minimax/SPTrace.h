@@ -0,0 +1,98 @@
+#ifndef SPTRACE_H_
+#define SPTRACE_H_
+#include <stdbool.h>
+
+// the environment variable of the trace file, see spTraceStart
+#define SP_TRACE_FILE_VARIABLE "FIAR_TRACE"
+// the events kept by every thread, the oldest ones are overwritten
+#define SP_TRACE_BUFFER_EVENTS (1 << 16)
+// the argument of an event that has none
+#define SP_TRACE_NO_ARG (-1)
+
+/**
+ * SPTrace Summary:
+ *
+ * Tracing of the phases of the engine into a Chrome trace_event JSON file, which
+ * chrome://tracing and Perfetto display as a timeline per thread. An event is a
+ * named span of time with an optional integer argument (a depth, a column, a
+ * number of iterations).
+ *
+ * The hooks are compiled in only when SP_TRACE is defined (build with -DSP_TRACE).
+ * Otherwise the SP_TRACE_BEGIN and SP_TRACE_END macros expand to no code (the
+ * argument of an event is only evaluated and dropped) and the engine has no
+ * tracing cost at all. When compiled in, nothing is recorded until
+ * spTraceStart; until then a hook costs a test of a flag.
+ *
+ * Every thread records into a ring buffer of its own, allocated at its first
+ * event, so recording takes no lock: the thread writes an event and then publishes
+ * it by a release store of its event count. A buffer holds the last
+ * SP_TRACE_BUFFER_EVENTS events of its thread. The buffer of a thread that exits is
+ * reused by the next new thread, whose events follow on the same track.
+ *
+ *   SP_TRACE_BEGIN(build);
+ *   ...
+ *   SP_TRACE_END(build, depth);
+ *
+ * records an event named "build" over the code in between, within one block.
+ *
+ * spTraceStart      - Starts recording, written to a file at exit
+ * spTraceIsEnabled  - Checks if events are recorded
+ * spTraceNow        - Returns the time of the start of an event
+ * spTraceEvent      - Records an event of the calling thread
+ * spTraceWrite      - Writes the recorded events to a file
+ */
+
+#ifdef SP_TRACE
+#define SP_TRACE_BEGIN(name) unsigned long long sp_trace_##name = spTraceNow()
+#define SP_TRACE_END(name, arg) spTraceEvent(#name, sp_trace_##name, (arg))
+#else
+#define SP_TRACE_BEGIN(name) ((void)0)
+#define SP_TRACE_END(name, arg) ((void)(arg))
+#endif
+
+/**
+ * Starts recording the events of every thread. The events are written to the
+ * file at the exit of the process. Nothing happens if the path is NULL,
+ * recording has started already or the engine is built without SP_TRACE.
+ *
+ * @param path - the path of the trace file, typically getenv(SP_TRACE_FILE_VARIABLE)
+ */
+void spTraceStart(const char* path);
+
+/**
+ * Checks if events are recorded.
+ *
+ * @return
+ * true iff spTraceStart has started recording
+ */
+bool spTraceIsEnabled(void);
+
+/**
+ * Returns the time of the start of an event.
+ *
+ * @return
+ * 0 if events aren't recorded, otherwise the monotonic time in nanoseconds
+ */
+unsigned long long spTraceNow(void);
+
+/**
+ * Records an event of the calling thread, from a start time to now. Nothing
+ * happens if the start time is 0 or the buffer of the thread can't be allocated.
+ *
+ * @param name - the name of the event, a string that outlives the process
+ * @param start - the start time, as returned by spTraceNow
+ * @param arg - the argument of the event, SP_TRACE_NO_ARG for none
+ */
+void spTraceEvent(const char* name, unsigned long long start, int arg);
+
+/**
+ * Writes the recorded events of every thread to a file, with a track per
+ * thread buffer. It must not run while other threads record events.
+ *
+ * @param path - the path of the file
+ * @return
+ * true on success, false if path is NULL or the file can't be written
+ */
+bool spTraceWrite(const char* path);
+
+#endif
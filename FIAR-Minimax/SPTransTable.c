@@ -0,0 +1,117 @@
+#include "SPTransTable.h"
+#include "SPFIARCodec.h"
+#include <stdlib.h>
+
+// multiplier of the fibonacci hashing of the keys
+#define HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+
+SPTransTable* spTransTableCreate(unsigned long size) {
+	SPTransTable* table;
+	unsigned long entries = 1;
+
+	if (size == 0) {
+		return NULL;
+	}
+
+	while (entries < size) {
+		entries <<= 1;
+	}
+
+	table = (SPTransTable*)malloc(sizeof(SPTransTable));
+
+	if ((void*)table == NULL) {
+		return NULL;
+	}
+
+	table->entries = (SPTransTableEntry*)calloc(entries, sizeof(SPTransTableEntry));
+
+	if ((void*)(table->entries) == NULL) {
+		free(table);
+		return NULL;
+	}
+
+	table->mask = entries - 1;
+
+	return table;
+}
+
+void spTransTableDestroy(SPTransTable* table) {
+	if ((void*)table == NULL) {
+		return;
+	}
+
+	free(table->entries);
+	free(table);
+}
+
+void spTransTableClear(SPTransTable* table) {
+	unsigned long i;
+
+	if ((void*)table == NULL) {
+		return;
+	}
+
+	for (i = 0; i <= table->mask; i++) {
+		(table->entries)[i].key = 0;
+	}
+}
+
+unsigned long long spTransTableGetKey(SPFiarGame* game, bool* mirrored) {
+	unsigned long long key, mirror_key;
+
+	if (mirrored != NULL) {
+		*mirrored = false;
+	}
+
+	if ((key = spFiarCodecEncodeKey(game)) == 0) {
+		return 0;
+	}
+
+	mirror_key = spFiarCodecMirrorKey(key, game->geometry);
+
+	if (mirrored != NULL) {
+		*mirrored = mirror_key < key;
+	}
+
+	return mirror_key < key ? mirror_key : key;
+}
+
+/*
+* Returns the slot of a key.
+* Assumes table is not null.
+*
+* @param table the table
+* @param key the key
+* @return the slot of the key
+*/
+static SPTransTableEntry* getSlot(SPTransTable* table, unsigned long long key) {
+	return table->entries + ((key * HASH_MULTIPLIER) >> 32 & table->mask);
+}
+
+SPTransTableEntry* spTransTableProbe(SPTransTable* table, unsigned long long key) {
+	SPTransTableEntry* entry;
+
+	if ((void*)table == NULL) {
+		return NULL;
+	}
+
+	entry = getSlot(table, key);
+
+	return entry->key == key ? entry : NULL;
+}
+
+void spTransTableStore(SPTransTable* table, unsigned long long key, int score, SP_TRANS_TABLE_BOUND bound,
+	int depth, int move) {
+	SPTransTableEntry* entry;
+
+	if ((void*)table == NULL) {
+		return;
+	}
+
+	entry = getSlot(table, key);
+	entry->key = key;
+	entry->score = score;
+	entry->bound = (char)bound;
+	entry->depth = (signed char)depth;
+	entry->move = (signed char)move;
+}
@@ -0,0 +1,109 @@
+#ifndef SPTRANSTABLE_H_
+#define SPTRANSTABLE_H_
+
+#include <stdbool.h>
+#include "SPFIARGame.h"
+
+/**
+ * SPTransTable Summary:
+ *
+ * A fixed size transposition table, caching the results of searched positions.
+ * The positions are keyed by their mirror canonical form, so a position and its
+ * mirror image share one entry. Every key maps to a single slot and a new entry
+ * always replaces the old one.
+ *
+ * spTransTableCreate   - Creates an empty table
+ * spTransTableDestroy  - Frees all memory resources associated with a table
+ * spTransTableClear    - Removes all entries from a table
+ * spTransTableGetKey   - Returns the mirror canonical key of a position
+ * spTransTableProbe    - Looks up the entry of a key
+ * spTransTableStore    - Stores an entry for a key
+ */
+
+/**
+ * The kind of bound the score of an entry is
+ */
+typedef enum sp_trans_table_bound_t {
+	SP_TRANS_TABLE_EXACT,
+	SP_TRANS_TABLE_LOWER,
+	SP_TRANS_TABLE_UPPER
+} SP_TRANS_TABLE_BOUND;
+
+typedef struct sp_trans_table_entry_t {
+	unsigned long long key; // 0 means an empty slot
+	int score;
+	signed char depth;
+	signed char move;       // the best move found or -1, in the orientation of the key
+	char bound;             // SP_TRANS_TABLE_BOUND
+} SPTransTableEntry;
+
+typedef struct sp_trans_table_t {
+	SPTransTableEntry* entries;
+	unsigned long mask; // number of entries - 1
+} SPTransTable;
+
+/**
+ * Creates an empty table with at least the specified number of entries (rounded
+ * up to a power of 2).
+ *
+ * @param size - the minimal number of entries
+ * @return
+ * NULL if either a memory allocation failure occurs or size == 0.
+ * Otherwise, a new empty table.
+ */
+SPTransTable* spTransTableCreate(unsigned long size);
+
+/**
+ * Frees all memory resources associated with a table. If table == NULL nothing happens.
+ *
+ * @param table - the table
+ */
+void spTransTableDestroy(SPTransTable* table);
+
+/**
+ * Removes all entries from a table. If table == NULL nothing happens.
+ *
+ * @param table - the table
+ */
+void spTransTableClear(SPTransTable* table);
+
+/**
+ * Returns the key of the position of a game. A position and its mirror image get
+ * the same key, the lower of their keys of SPFIARCodec.h. The side to move is part
+ * of the key.
+ *
+ * @param game - the game
+ * @param mirrored - if not NULL, set to true iff the key was taken from the mirror
+ *                   image, in which case columns of moves have to be mirrored too
+ * @return
+ * 0 if game == NULL or the board of the game has too many cells for a 64 bit
+ * key ((rows + 1) * columns > 64), the key of the position otherwise (never 0).
+ */
+unsigned long long spTransTableGetKey(SPFiarGame* game, bool* mirrored);
+
+/**
+ * Looks up the entry of a key.
+ *
+ * @param table - the table
+ * @param key - the key
+ * @return
+ * NULL if table == NULL or there is no entry for the key.
+ * Otherwise, the entry of the key.
+ */
+SPTransTableEntry* spTransTableProbe(SPTransTable* table, unsigned long long key);
+
+/**
+ * Stores an entry for a key, replacing the entry in its slot.
+ * If table == NULL nothing happens.
+ *
+ * @param table - the table
+ * @param key - the key
+ * @param score - the score
+ * @param bound - the kind of bound the score is
+ * @param depth - the search depth the score was found with
+ * @param move - the best move found or -1, in the orientation of the key
+ */
+void spTransTableStore(SPTransTable* table, unsigned long long key, int score, SP_TRANS_TABLE_BOUND bound,
+	int depth, int move);
+
+#endif
@@ -0,0 +1,481 @@
+#define _POSIX_C_SOURCE 200112L
+#include "SPTune.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "SPMinimaxNode.h"
+#include "SPSample.h"
+#include "SPThreadPool.h"
+#include "SPFIARParser.h"
+#include "SPFIARCodec.h"
+
+#define MAX_FEATURES (SP_FIAR_GAME_MAX_SPAN - 1)
+#define SCALE_MIN 1e-4
+#define SCALE_MAX 10.0
+#define SCALE_STEPS 60
+#define IMPROVEMENT 1e-12
+
+/*
+* The samples of a tuning and the weights being tuned, shared by its tasks.
+*/
+typedef struct sp_tune_t {
+	const SPFiarGeometry* geometry;
+	int n_features;                // span - 1, the feature of index k is of the span sum k + 1
+	long n;                        // the samples used
+	short* features[MAX_FEATURES]; // a column of n per feature, for the player to move
+	float* targets;                // the results of the games, 0, 0.5 or 1
+	int* evals;                    // the evaluations of the samples, scratch of the tasks
+	int weights[MAX_FEATURES];     // the weight of the span sum k + 1
+	double scale;                  // of the sigmoid
+	SPSample* samples;             // the loaded samples, before the features are computed
+	char* used;                    // whether the evaluation scores a loaded sample
+} SPTune;
+
+/*
+* A slice of the samples and the result of its task.
+*/
+typedef struct sp_tune_slice_t {
+	SPTune* tune;
+	long begin;
+	long end;
+	double error;                  // the squared error of the slice
+	bool failed;
+} SPTuneSlice;
+
+/*
+* Computes the features of the loaded samples of a slice. A task.
+* @param arg the slice
+*/
+static void computeFeatures(void* arg) {
+	SPTuneSlice* slice = (SPTuneSlice*)arg;
+	SPTune* tune = slice->tune;
+	int histogram[SIZE_OF_HISTOGRAM], k, sign, span = tune->geometry->span;
+	SPFiarGame* game;
+	char player, opponent;
+	long i;
+
+	for (i = slice->begin; i < slice->end; i++) {
+		if ((game = spFiarCodecDecodeKey(tune->samples[i].key, tune->geometry, 1)) == NULL) {
+			slice->failed = true;
+			tune->used[i] = false;
+			continue;
+		}
+
+		player = spFiarGameGetCurrentPlayer(game);
+		opponent = player == SP_FIAR_GAME_PLAYER_1_SYMBOL ? SP_FIAR_GAME_PLAYER_2_SYMBOL : SP_FIAR_GAME_PLAYER_1_SYMBOL;
+
+		// the positions scored as wins or losses, see spCalculateGameScore
+		tune->used[i] = spFiarCheckWinner(game) == NO_WINNER && spCountImmediateWins(game, player, NULL) == 0 &&
+			spCountImmediateWins(game, opponent, NULL) <= 1;
+
+		if (tune->used[i]) {
+			memset(histogram, 0, sizeof(histogram));
+			game->geometry->fillHistogram((const char (*)[SP_FIAR_GAME_MAX_COLUMNS])game->gameBoard, histogram);
+			sign = player == SP_FIAR_GAME_PLAYER_1_SYMBOL ? 1 : -1;
+
+			for (k = 0; k < tune->n_features; k++) {
+				tune->features[k][i] = (short)(sign * (histogram[span + k + 1] - histogram[span - k - 1]));
+			}
+
+			tune->targets[i] = tune->samples[i].result / 2.0f;
+		}
+
+		spFiarGameDestroy(game);
+	}
+}
+
+/*
+* Computes the squared error of the samples of a slice. A task.
+* @param arg the slice
+*/
+static void computeError(void* arg) {
+	SPTuneSlice* slice = (SPTuneSlice*)arg;
+	SPTune* tune = slice->tune;
+	int* evals = tune->evals;
+	const short* column;
+	double expected, error = 0;
+	long i;
+	int k, weight;
+
+	for (i = slice->begin; i < slice->end; i++) {
+		evals[i] = 0;
+	}
+
+	// a pass per feature column
+	for (k = 0; k < tune->n_features; k++) {
+		column = tune->features[k];
+		weight = tune->weights[k];
+
+		for (i = slice->begin; i < slice->end; i++) {
+			evals[i] += weight * column[i];
+		}
+	}
+
+	for (i = slice->begin; i < slice->end; i++) {
+		expected = 1.0 / (1.0 + exp(-tune->scale * evals[i]));
+		error += (expected - tune->targets[i]) * (expected - tune->targets[i]);
+	}
+
+	slice->error = error;
+}
+
+/*
+* Splits samples into the slices.
+* @param tune the tuning
+* @param slices the slices
+* @param n the number of samples
+*/
+static void makeSlices(SPTune* tune, SPTuneSlice slices[TUNE_SLICES], long n) {
+	int s;
+
+	for (s = 0; s < TUNE_SLICES; s++) {
+		slices[s].tune = tune;
+		slices[s].begin = n * s / TUNE_SLICES;
+		slices[s].end = n * (s + 1) / TUNE_SLICES;
+		slices[s].error = 0;
+		slices[s].failed = false;
+	}
+}
+
+/*
+* Runs a task on every slice and waits for them.
+* @param pool the pool
+* @param slices the slices
+* @param task the task
+*/
+static void runSlices(SPThreadPool* pool, SPTuneSlice slices[TUNE_SLICES], SPThreadPoolTask task) {
+	int s;
+
+	for (s = 0; s < TUNE_SLICES; s++) {
+		spThreadPoolSubmit(pool, task, slices + s);
+	}
+
+	spThreadPoolWait(pool);
+}
+
+/*
+* Returns the mean squared error of the current weights and scale.
+* @param tune the tuning
+* @param pool the pool
+* @param slices the slices of the used samples
+* @return the error
+*/
+static double evaluate(SPTune* tune, SPThreadPool* pool, SPTuneSlice slices[TUNE_SLICES]) {
+	double error = 0;
+	int s;
+
+	runSlices(pool, slices, computeError);
+
+	// summed in order, so the error doesn't depend on the threads
+	for (s = 0; s < TUNE_SLICES; s++) {
+		error += slices[s].error;
+	}
+
+	return tune->n > 0 ? error / tune->n : 0;
+}
+
+/*
+* Fits the scale of the sigmoid to the current weights, by a ternary search of its
+* logarithm.
+* @param tune the tuning
+* @param pool the pool
+* @param slices the slices of the used samples
+*/
+static void fitScale(SPTune* tune, SPThreadPool* pool, SPTuneSlice slices[TUNE_SLICES]) {
+	double low = log(SCALE_MIN), high = log(SCALE_MAX), left, right, left_error;
+	int i;
+
+	for (i = 0; i < SCALE_STEPS; i++) {
+		left = low + (high - low) / 3;
+		right = high - (high - low) / 3;
+		tune->scale = exp(left);
+		left_error = evaluate(tune, pool, slices);
+		tune->scale = exp(right);
+
+		if (left_error < evaluate(tune, pool, slices)) {
+			high = right;
+		}
+		else {
+			low = left;
+		}
+	}
+
+	tune->scale = exp((low + high) / 2);
+}
+
+/*
+* Loads the samples of a file and computes their features.
+* @param tune the tuning, its geometry is set
+* @param path the path of the samples file
+* @param pool the pool
+* @return the number of samples loaded, -1 on failure
+*/
+static long loadSamples(SPTune* tune, const char* path, SPThreadPool* pool) {
+	SPTuneSlice slices[TUNE_SLICES];
+	SPSampleReader* reader;
+	long capacity, loaded = 0, i;
+	bool failed = false;
+	int k, s;
+
+	if ((reader = spSampleReaderOpen(path)) == NULL) {
+		return -1;
+	}
+
+	tune->geometry = reader->geometry;
+	tune->n_features = reader->geometry->span - 1;
+	capacity = (long)((reader->size - SP_SAMPLE_FILE_HEADER_SIZE) / SP_SAMPLE_SIZE);
+	tune->samples = (SPSample*)malloc((capacity > 0 ? capacity : 1) * sizeof(SPSample));
+
+	while (tune->samples != NULL && loaded < capacity &&
+		spSampleReaderNext(reader, tune->samples + loaded) == SP_SAMPLE_SUCCESS) {
+		loaded++;
+	}
+
+	spSampleReaderClose(reader);
+
+	if (tune->samples == NULL || loaded < capacity) {
+		return -1;
+	}
+
+	tune->used = (char*)malloc(loaded + 1);
+	tune->targets = (float*)malloc((loaded + 1) * sizeof(float));
+	tune->evals = (int*)malloc((loaded + 1) * sizeof(int));
+	failed = tune->used == NULL || tune->targets == NULL || tune->evals == NULL;
+
+	for (k = 0; k < tune->n_features; k++) {
+		failed = (tune->features[k] = (short*)malloc((loaded + 1) * sizeof(short))) == NULL || failed;
+	}
+
+	if (failed) {
+		return -1;
+	}
+
+	makeSlices(tune, slices, loaded);
+	runSlices(pool, slices, computeFeatures);
+
+	for (s = 0; s < TUNE_SLICES; s++) {
+		failed = failed || slices[s].failed;
+	}
+
+	// keeps the samples the evaluation scores, in order
+	for (i = 0, tune->n = 0; i < loaded; i++) {
+		if (tune->used[i]) {
+			for (k = 0; k < tune->n_features; k++) {
+				tune->features[k][tune->n] = tune->features[k][i];
+			}
+
+			tune->targets[tune->n++] = tune->targets[i];
+		}
+	}
+
+	return failed ? -1 : loaded;
+}
+
+/*
+* Frees the samples of a tuning.
+* @param tune the tuning
+*/
+static void freeSamples(SPTune* tune) {
+	int k;
+
+	for (k = 0; k < MAX_FEATURES; k++) {
+		free(tune->features[k]);
+	}
+
+	free(tune->targets);
+	free(tune->evals);
+	free(tune->samples);
+	free(tune->used);
+}
+
+/*
+* Writes a weights macro, the weights of the span sums -(span - 1) to span - 1 without 0.
+* @param file the file
+* @param name the name of the macro
+* @param weights the weights of the positive sums
+* @param n the number of positive sums
+*/
+static void writeWeightsMacro(FILE* file, const char* name, const int* weights, int n) {
+	int i;
+
+	fprintf(file, "#define %s {", name);
+
+	for (i = n - 1; i >= 0; i--) {
+		fprintf(file, " %d,", -weights[i]);
+	}
+
+	for (i = 0; i < n; i++) {
+		fprintf(file, " %d%s", weights[i], i + 1 < n ? "," : " }\n");
+	}
+}
+
+/*
+* Writes a replacement of SPEvalWeights.h.
+* @param tune the tuning
+* @param path the path of the header
+* @param samples_path the path of the samples, for the comment of the header
+* @param error the error of the tuned weights
+* @return true iff the header was written
+*/
+static bool writeHeader(SPTune* tune, const char* path, const char* samples_path, double error) {
+	int weights_span_4[] = WEIGHTS, weights_span_5[] = WEIGHTS_SPAN_5;
+	FILE* file;
+	int k;
+
+	if ((file = fopen(path, "w")) == NULL) {
+		return false;
+	}
+
+	for (k = 0; k < tune->n_features; k++) {
+		if (tune->geometry->span == 5) {
+			weights_span_5[4 + k] = tune->weights[k];
+		}
+		else {
+			weights_span_4[3 + k] = tune->weights[k];
+		}
+	}
+
+	fprintf(file, "#ifndef SPEVALWEIGHTS_H_\n#define SPEVALWEIGHTS_H_\n\n");
+	fprintf(file, "/**\n * The weights of the evaluation of a position (see spCalculateGameScore), by the\n");
+	fprintf(file, " * sum of a span: the number of discs of player 1 minus those of player 2 in the\n");
+	fprintf(file, " * span, from -(span - 1) to span - 1 without 0. The tune command writes a\n");
+	fprintf(file, " * replacement of this header fitted to self-play samples.\n *\n");
+	fprintf(file, " * The weights of span %d were tuned on %s (%ld positions, error %.6f).\n */\n",
+		tune->geometry->span, samples_path, tune->n, error);
+	writeWeightsMacro(file, "WEIGHTS", weights_span_4 + 3, 3);
+	fprintf(file, "// the weights of the geometries with a span of 5\n");
+	writeWeightsMacro(file, "WEIGHTS_SPAN_5", weights_span_5 + 4, 4);
+	fprintf(file, "\n#endif\n");
+
+	return fclose(file) == 0;
+}
+
+/*
+* Prints the error and the weights of a step of the tuning.
+* @param tune the tuning
+* @param step the name of the step
+* @param error the error
+*/
+static void printStep(SPTune* tune, const char* step, double error) {
+	int k;
+
+	printf("%-8s error %.6f weights", step, error);
+
+	for (k = 0; k < tune->n_features; k++) {
+		printf(" %d", tune->weights[k]);
+	}
+
+	printf("\n");
+}
+
+/*
+* Moves the weights by one while that lowers the error, see SPTune.h.
+* @param tune the tuning
+* @param pool the pool
+* @param slices the slices of the used samples
+* @param passes the maximal number of passes
+* @return the error of the final weights
+*/
+static double localSearch(SPTune* tune, SPThreadPool* pool, SPTuneSlice slices[TUNE_SLICES], int passes) {
+	double best = evaluate(tune, pool, slices), error;
+	char step[16];
+	bool improved = true;
+	int pass, k, delta;
+
+	for (pass = 1; pass <= passes && improved; pass++) {
+		improved = false;
+
+		for (k = 0; k < tune->n_features; k++) {
+			for (delta = 1; delta >= -1; delta -= 2) {
+				tune->weights[k] += delta;
+
+				if ((error = evaluate(tune, pool, slices)) < best - IMPROVEMENT) {
+					best = error;
+					improved = true;
+					break;
+				}
+
+				tune->weights[k] -= delta;
+			}
+		}
+
+		sprintf(step, "pass %d", pass);
+		printStep(tune, step, best);
+	}
+
+	return best;
+}
+
+int spTuneMain(int argc, char* argv[]) {
+	int weights_span_4[] = WEIGHTS, weights_span_5[] = WEIGHTS_SPAN_5;
+	int threads = 0, passes = TUNE_DEFAULT_PASSES, i, k;
+	SPTuneSlice slices[TUNE_SLICES];
+	struct timespec start, end;
+	SPThreadPool* pool;
+	SPTune tune;
+	long loaded;
+	double error;
+	bool valid = argc >= 3;
+
+	// every option is followed by its value
+	for (i = 3; i < argc && valid; i += 2) {
+		if (i + 1 == argc || !spParserIsInt(argv[i + 1]) || atoi(argv[i + 1]) <= 0) {
+			valid = false;
+		}
+		else if (strcmp(argv[i], TUNE_THREADS_OPTION) == 0) {
+			threads = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], TUNE_PASSES_OPTION) == 0) {
+			passes = atoi(argv[i + 1]);
+		}
+		else {
+			valid = false;
+		}
+	}
+
+	if (!valid) {
+		printf("Usage: %s <samples> <header> [%s <n>] [%s <n>]\n", argv[0], TUNE_THREADS_OPTION, TUNE_PASSES_OPTION);
+		return 1;
+	}
+
+	if ((pool = spThreadPoolCreate(threads, TUNE_SLICES)) == NULL) {
+		printf("Error: malloc has failed\n");
+		return 1;
+	}
+
+	memset(&tune, 0, sizeof(tune));
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	if ((loaded = loadSamples(&tune, argv[1], pool)) == -1) {
+		printf("Error: cannot read the samples of %s\n", argv[1]);
+		freeSamples(&tune);
+		spThreadPoolDestroy(pool);
+		return 1;
+	}
+
+	for (k = 0; k < tune.n_features; k++) {
+		tune.weights[k] = tune.geometry->span == 5 ? weights_span_5[4 + k] : weights_span_4[3 + k];
+	}
+
+	printf("geometry %s samples %ld positions %ld threads %d\n", tune.geometry->name, loaded, tune.n, pool->n_threads);
+	makeSlices(&tune, slices, tune.n);
+	fitScale(&tune, pool, slices);
+	printf("scale %.6f\n", tune.scale);
+	printStep(&tune, "initial", evaluate(&tune, pool, slices));
+	error = localSearch(&tune, pool, slices, passes);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	printf("ms %.2f\n", (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1000000.0);
+
+	valid = writeHeader(&tune, argv[2], argv[1], error);
+	freeSamples(&tune);
+	spThreadPoolDestroy(pool);
+
+	if (!valid) {
+		printf("Error: cannot write %s\n", argv[2]);
+		return 1;
+	}
+
+	return 0;
+}
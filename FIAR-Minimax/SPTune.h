@@ -0,0 +1,51 @@
+#ifndef SPTUNE_H_
+#define SPTUNE_H_
+
+#define TUNE_COMMAND "tune"
+#define TUNE_THREADS_OPTION "--threads"
+#define TUNE_PASSES_OPTION "--passes"
+#define TUNE_DEFAULT_PASSES 50
+// the slices of the samples, each scored by a task; their number keeps the
+// errors the same on any number of threads
+#define TUNE_SLICES 64
+
+/**
+ * SPTune Summary:
+ *
+ * Fits the evaluation weights (see SPEvalWeights.h) of a geometry to self-play
+ * samples (see SPSample.h). Every sample position is evaluated by the weights,
+ * for the player to move, and the evaluation is mapped to an expected result by a
+ * sigmoid. The weights minimize the mean squared error between the expected and
+ * the final results of the games.
+ *
+ * The features of the samples are computed once: for every span sum s > 0, the
+ * number of spans of sum s minus those of sum -s, for the player to move. The
+ * weights are kept antisymmetric, the weight of -s is minus that of s, as the
+ * hand-written ones are. The features are stored as a column per sum, so scoring
+ * a weight vector is a dense multiply-add pass over the columns, split among
+ * threads. Positions that the evaluation doesn't score (decided by an immediate
+ * win or a double threat) are left out.
+ *
+ * The sigmoid scale is fitted to the current weights first. The weights are then
+ * improved by a local search: a weight is moved by one at a time as long as that
+ * lowers the error.
+ *
+ * spTuneMain  - Runs the tuning
+ */
+
+/**
+ * Runs the tuning. Usage: tune <samples> <header> [--threads <n>] [--passes <n>]
+ * The header is written as a replacement of SPEvalWeights.h, with the tuned
+ * weights of the geometry of the samples and the current weights of the others.
+ * A pass tries to move every weight, the tuning stops after a pass that changed
+ * nothing.
+ *
+ * @param argc - the number of arguments, including the command name
+ * @param argv - the arguments, argv[0] is the command name
+ * @return
+ * 0 on success, 1 if the arguments are invalid, the samples can't be read or
+ * the header can't be written
+ */
+int spTuneMain(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,633 @@
+#include "SPVerify.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SPMinimax.h"
+#include "SPMinimaxNode.h"
+#include "SPFIARParser.h"
+#include "SPFIARCodec.h"
+
+#define VERIFY_HISTORY_SIZE SP_FIAR_CODEC_MAX_MOVES
+// the reference, then the modes under test
+#define VERIFY_MAX_ENGINES 4
+// the reference and the plain search visit the full tree, deeper ones take too long
+#define VERIFY_MAX_DEPTH 10
+#define VERIFY_REFERENCE_NAME "ref"
+// the scores of the reference, as the engine started with: a win has no distance
+#define VERIFY_REFERENCE_WIN INT_MAX
+#define VERIFY_REFERENCE_LOSS INT_MIN
+// the weights of the span sums -(span - 1), ..., -1, 1, ..., span - 1 of the reference evaluation
+#define VERIFY_REFERENCE_WEIGHTS_SPAN_4 { -5, -2, -1, 1, 2, 5 }
+#define VERIFY_REFERENCE_WEIGHTS_SPAN_5 { -12, -5, -2, -1, 1, 2, 5, 12 }
+
+/*
+* The result of a search of a mode, compared with the reference.
+*/
+typedef enum sp_verify_outcome_t {
+	VERIFY_MATCH,    // the result of the reference, or a move it gives the score of the root
+	VERIFY_HORIZON,  // a difference where the leaves of the mode see a win a ply or two past the depth
+	VERIFY_PARITY,   // a difference where threat parity proves a result
+	VERIFY_MISMATCH
+} SP_VERIFY_OUTCOME;
+
+/*
+* The 4 directions of a span: row, column, diagonal of type / and diagonal of type '\'.
+*/
+static const int VERIFY_DIRECTIONS[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+
+/*
+* The curated positions, as move strings (see SPFIARCodec.h). They are valid on
+* every geometry; those that are over on a geometry are skipped on it.
+*/
+static const char* VERIFY_POSITIONS[] = {
+	"",
+	"4",
+	"44",
+	"4455",         // an open three to make or block
+	"445566",       // a win in one
+	"4453",
+	"434443",
+	"33443",        // a threat to block
+	"4453354",
+	"43344553",
+	"444333222",
+	"44444422",
+	"3333334444",
+	"44433355521",
+	"444455526367",
+	"12345671234567",
+	"12345676543211",
+	"7777771111112222223",  // full columns
+	"444444333333555555",   // three full columns in the middle
+	"11111122222233333344444455555", // few moves left
+	"6622672466627215557755747514",  // a win just past the depth
+	"246615523516252661314133"       // a win proven by threat parity
+};
+
+#define VERIFY_N_POSITIONS ((int)(sizeof(VERIFY_POSITIONS) / sizeof(VERIFY_POSITIONS[0])))
+
+/*
+* The totals of the searches of an engine at a depth.
+*/
+typedef struct sp_verify_stats_t {
+	int searches;
+	int mismatches;
+	int horizon;         // the results past the depth, see SP_VERIFY_OUTCOME
+	int parity;
+	unsigned long nodes;
+	double ms;
+} SPVerifyStats;
+
+/*
+* A run of the test.
+*/
+typedef struct sp_verify_t {
+	const SPFiarGeometry* geometry;
+	SPMinimaxConfig engines[VERIFY_MAX_ENGINES]; // the modes under test, after a slot of the reference
+	int n_engines;
+	unsigned int max_depth;
+	int random;                                  // the number of random positions
+	unsigned long long seed;
+	SPVerifyStats stats[VERIFY_MAX_ENGINES][VERIFY_MAX_DEPTH];
+} SPVerify;
+
+/*
+* Returns the next random number of a run, by xorshift64*.
+* @param state the state of the random generator, not 0
+* @return the number
+*/
+static unsigned long long nextRandom(unsigned long long* state) {
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+
+	return *state * 2685821657736338717ULL;
+}
+
+/*
+* Returns the milliseconds of processor time since start.
+* @param start the start time
+* @return the milliseconds since start
+*/
+static double elapsedMs(clock_t start) {
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/*
+* Returns the name of an engine of a run.
+* @param run the run
+* @param e the index of the engine, 0 for the reference
+* @return the name
+*/
+static const char* engineName(const SPVerify* run, int e) {
+	return e == 0 ? VERIFY_REFERENCE_NAME : spMinimaxModeName(run->engines[e].mode);
+}
+
+/*
+* Sets a game to a random position: a random number of random moves from the
+* empty board, up to a board with two empty cells, so that the searches reach the
+* end of the game. A move that ends the game is undone and ends the position.
+* @param game the game
+* @param geometry the geometry of the position
+* @param state the state of the random generator
+*/
+static void setRandomPosition(SPFiarGame* game, const SPFiarGeometry* geometry, unsigned long long* state) {
+	int length, legal, col;
+
+	spFiarGameReset(game, geometry);
+	length = (int)(nextRandom(state) % (geometry->rows * geometry->columns - 1));
+
+	while (length-- > 0) {
+		// the k-th legal column, for a random k
+		for (col = 0, legal = 0; col < geometry->columns; col++) {
+			legal += spFiarGameIsValidMove(game, col);
+		}
+
+		legal = (int)(nextRandom(state) % legal);
+
+		for (col = 0; !spFiarGameIsValidMove(game, col) || legal-- > 0; col++);
+
+		spFiarGameSetMove(game, col);
+
+		if (spFiarCheckWinner(game) != '\0') {
+			spFiarGameUndoPrevMove(game);
+			break;
+		}
+	}
+}
+
+/*
+* Evaluates a position that hasn't ended, as the engine started with: every span
+* of the board adds the weight of its number of player 1 discs minus its number
+* of player 2 discs. This is a frozen copy, it doesn't follow the tuned weights
+* of SPEvalWeights.h or the pattern tables of the engine.
+* @param game the position
+* @param player_A_identity the identity of the player to move at the root
+* @return the value of the position for player A
+*/
+static int referenceEvaluate(SPFiarGame* game, SP_PlayerA player_A_identity) {
+	const SPFiarGeometry* geometry = game->geometry;
+	int weights_span_4[] = VERIFY_REFERENCE_WEIGHTS_SPAN_4, weights_span_5[] = VERIFY_REFERENCE_WEIGHTS_SPAN_5;
+	int* weights = geometry->span == 5 ? weights_span_5 : weights_span_4;
+	int i, j, d, m, row, col, sum, value = 0;
+	char symbol;
+
+	for (d = 0; d < 4; d++) {
+		for (i = 0; i < geometry->rows; i++) {
+			for (j = 0; j < geometry->columns; j++) {
+				row = i + VERIFY_DIRECTIONS[d][0] * (geometry->span - 1);
+				col = j + VERIFY_DIRECTIONS[d][1] * (geometry->span - 1);
+
+				if (row >= geometry->rows || col < 0 || col >= geometry->columns) {
+					continue;
+				}
+
+				for (sum = 0, m = 0; m < geometry->span; m++) {
+					symbol = (game->gameBoard)[i + VERIFY_DIRECTIONS[d][0] * m][j + VERIFY_DIRECTIONS[d][1] * m];
+					sum += symbol == SP_FIAR_GAME_PLAYER_1_SYMBOL ? 1 : (symbol == SP_FIAR_GAME_PLAYER_2_SYMBOL ? -1 : 0);
+				}
+
+				if (sum != 0) {
+					value += weights[sum < 0 ? sum + geometry->span - 1 : sum + geometry->span - 2];
+				}
+			}
+		}
+	}
+
+	return player_A_identity == Player2 ? -value : value;
+}
+
+/*
+* A search of the reference.
+*/
+typedef struct sp_verify_reference_t {
+	SP_PlayerA player_A_identity; // the player to move at the root
+	unsigned long nodes;
+	bool horizon;                 // a leaf the engine scores as a win or loss, see referenceScore
+	bool parity;                  // a node the engine scores by threat parity
+} SPVerifyReference;
+
+/*
+* Counts the columns in which a symbol completes a span at once.
+* @param game the position
+* @param symbol the symbol
+* @return the number of winning columns
+*/
+static int countImmediateWins(SPFiarGame* game, char symbol) {
+	int col, count = 0;
+
+	for (col = 0; col < game->geometry->columns; col++) {
+		count += spFiarGameIsWinningMove(game, col, symbol);
+	}
+
+	return count;
+}
+
+/*
+* Scores a node of the reference search: the full-width minimax the engine started
+* with, before any pruning, frozen here so that it shares nothing with the engine
+* but the rules of the game. Every legal move of a node is searched, until the
+* depth is spent or the game ends. A leaf is scored by referenceEvaluate, a win by
+* VERIFY_REFERENCE_WIN or VERIFY_REFERENCE_LOSS and a tie by 0.
+*
+* The scores don't use what the engine knows past the depth, the search only
+* records where it could: a leaf whose player can win at once or faces two
+* threats, and a node with SP_THREAT_PARITY_MIN_DEPTH plies left whose result
+* threat parity proves (see spGetNodeExpansion).
+* @param game the position of the node, restored when the function returns
+* @param depth the depth left
+* @param max_node true iff player A is to move
+* @param reference the search
+* @return the score of the node for player A
+*/
+static int referenceScore(SPFiarGame* game, unsigned int depth, bool max_node, SPVerifyReference* reference) {
+	char winner = spFiarCheckWinner(game), player = spFiarGameGetCurrentPlayer(game);
+	int col, score, best = 0;
+	bool first = true;
+
+	reference->nodes++;
+
+	if (winner == SP_FIAR_GAME_TIE_SYMBOL) {
+		return 0;
+	}
+
+	if (winner != NO_WINNER) {
+		return (winner == SP_FIAR_GAME_PLAYER_1_SYMBOL) == (reference->player_A_identity == Player1) ?
+			VERIFY_REFERENCE_WIN : VERIFY_REFERENCE_LOSS;
+	}
+
+	if (depth == 0) {
+		if (countImmediateWins(game, player) > 0 || countImmediateWins(game,
+			player == SP_FIAR_GAME_PLAYER_1_SYMBOL ? SP_FIAR_GAME_PLAYER_2_SYMBOL : SP_FIAR_GAME_PLAYER_1_SYMBOL) > 1) {
+			reference->horizon = true;
+		}
+
+		return referenceEvaluate(game, reference->player_A_identity);
+	}
+
+	if (depth >= SP_THREAT_PARITY_MIN_DEPTH && !reference->parity &&
+		spThreatParityAnalyze(game) != SP_THREAT_PARITY_UNKNOWN) {
+		reference->parity = true;
+	}
+
+	for (col = 0; col < game->geometry->columns; col++) {
+		if (!spFiarGameIsValidMove(game, col)) {
+			continue;
+		}
+
+		spFiarGameSetMove(game, col);
+		score = referenceScore(game, depth - 1, !max_node, reference);
+		spFiarGameUndoPrevMove(game);
+
+		if (first || (max_node ? score > best : score < best)) {
+			best = score;
+			first = false;
+		}
+	}
+
+	return best;
+}
+
+/*
+* Scores a move of the root with the reference.
+* @param game the position of the root, restored when the function returns
+* @param depth the depth of the search
+* @param col the move
+* @param reference the search
+* @return the score of the move for the player to move
+*/
+static int referenceScoreMove(SPFiarGame* game, unsigned int depth, int col, SPVerifyReference* reference) {
+	int score;
+
+	spFiarGameSetMove(game, col);
+	score = referenceScore(game, depth - 1, false, reference);
+	spFiarGameUndoPrevMove(game);
+
+	return score;
+}
+
+/*
+* Searches a position with the reference: the move is the first column whose
+* child has the score of the root.
+* @param game the position, which hasn't ended, restored when the function returns
+* @param depth the depth of the search
+* @param result set to the move, score and nodes of the search
+* @param reference set to the search
+* @return the move
+*/
+static int referenceSuggestMove(SPFiarGame* game, unsigned int depth, SPMinimaxResult* result,
+	SPVerifyReference* reference) {
+	int col, score;
+
+	memset(reference, 0, sizeof(*reference));
+	reference->player_A_identity = spFiarGameGetCurrentPlayer(game) == SP_FIAR_GAME_PLAYER_1_SYMBOL ? Player1 : Player2;
+	reference->nodes = 1;
+	result->move = -1;
+	result->score = 0;
+	result->degraded = false;
+
+	for (col = 0; col < game->geometry->columns; col++) {
+		if (!spFiarGameIsValidMove(game, col)) {
+			continue;
+		}
+
+		score = referenceScoreMove(game, depth, col, reference);
+
+		if (result->move == -1 || score > result->score) {
+			result->move = col;
+			result->score = score;
+		}
+	}
+
+	result->nodes = reference->nodes;
+
+	return result->move;
+}
+
+/*
+* Returns the distance of the win or loss of an engine score.
+* @param score the score
+* @return the plies from the root to the win or loss, 0 if the score is a value
+*/
+static int getWinDistance(int score) {
+	int distance = SP_MINIMAX_WIN_SCORE - abs(score);
+
+	return distance >= 0 && distance <= SP_FIAR_CODEC_MAX_MOVES ? distance : 0;
+}
+
+/*
+* Compares the search of a mode with that of the reference. A result, a win or a
+* loss, is compared by its class only, as the reference knows no distances: a
+* won position must be won with a move the reference wins with, any move is as
+* good in a lost one. Otherwise the evaluations of the mode and the reference
+* may differ, so only the move is compared: the reference must give it the score
+* of the root. A tie is 0 for both and compared as a value.
+*
+* A mode that differs where the reference recorded a leaf of a win or loss past
+* the depth differs by what its leaves know, a mode that differs where threat
+* parity applies may differ by the proof. Both are reported as such, any other
+* difference is a mismatch.
+* @param game the position, restored when the function returns
+* @param depth the depth of the search
+* @param result the result of the mode
+* @param root the result of the reference
+* @param reference the search of the reference
+* @return the outcome of the comparison
+*/
+static SP_VERIFY_OUTCOME compareResult(SPFiarGame* game, unsigned int depth, const SPMinimaxResult* result,
+	const SPMinimaxResult* root, const SPVerifyReference* reference) {
+	SPVerifyReference move_reference = *reference;
+	int distance = getWinDistance(result->score);
+	bool root_result = root->score == VERIFY_REFERENCE_WIN || root->score == VERIFY_REFERENCE_LOSS;
+
+	if (!spFiarGameIsValidMove(game, result->move)) {
+		return VERIFY_MISMATCH;
+	}
+
+	if (root_result) {
+		// the reference sees every result within the depth, the mode must see it the same
+		if (distance == 0 || (result->score > 0) != (root->score > 0)) {
+			return VERIFY_MISMATCH;
+		}
+
+		return root->score == VERIFY_REFERENCE_LOSS || result->move == root->move ||
+			referenceScoreMove(game, depth, result->move, &move_reference) == root->score ?
+			VERIFY_MATCH : VERIFY_MISMATCH;
+	}
+
+	if (distance == 0 && (result->move == root->move ||
+		referenceScoreMove(game, depth, result->move, &move_reference) == root->score)) {
+		return VERIFY_MATCH;
+	}
+
+	if (reference->horizon && (distance == 0 || (distance > (int)depth && distance <= (int)depth + 2))) {
+		return VERIFY_HORIZON;
+	}
+
+	return reference->parity && (distance == 0 || distance > (int)depth) ? VERIFY_PARITY : VERIFY_MISMATCH;
+}
+
+/*
+* Searches a position at every depth with the reference and every mode under
+* test, and prints their disagreements.
+* @param run the run
+* @param game the position, not changed
+* @return true on success, false if a search failed
+*/
+static bool verifyPosition(SPVerify* run, SPFiarGame* game) {
+	SPMinimaxResult results[VERIFY_MAX_ENGINES];
+	SPVerifyReference reference;
+	char moves[SP_FIAR_CODEC_MOVES_SIZE];
+	SPVerifyStats* stats;
+	unsigned int depth;
+	clock_t start;
+	int e;
+
+	spFiarCodecEncodeMoves(game, moves, sizeof(moves));
+
+	for (depth = 1; depth <= run->max_depth; depth++) {
+		for (e = 0; e < run->n_engines; e++) {
+			start = clock();
+
+			if ((e == 0 ? referenceSuggestMove(game, depth, results, &reference) :
+				spMinimaxSuggestMoveWithConfig(game, depth, run->engines + e, results + e)) == -1) {
+				printf("Error: search of position %s failed\n", moves[0] == '\0' ? "start" : moves);
+				return false;
+			}
+
+			stats = &run->stats[e][depth - 1];
+			stats->ms += elapsedMs(start);
+			stats->nodes += results[e].nodes;
+			stats->searches++;
+
+			if (e == 0) {
+				continue;
+			}
+
+			switch (compareResult(game, depth, results + e, results, &reference)) {
+			case VERIFY_MATCH:
+				break;
+			case VERIFY_HORIZON:
+				stats->horizon++;
+				break;
+			case VERIFY_PARITY:
+				stats->parity++;
+				break;
+			case VERIFY_MISMATCH:
+				stats->mismatches++;
+				printf("MISMATCH position %s depth %u mode %s move %d score %d, reference move %d score %d\n",
+					moves[0] == '\0' ? "start" : moves, depth, engineName(run, e),
+					results[e].move + 1, results[e].score, results[0].move + 1, results[0].score);
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+/*
+* Prints the totals of an engine, compared with those of the reference.
+* @param label the depth of the totals
+* @param engine the totals of the engine
+* @param reference the totals of the reference
+* @param name the name of the engine
+*/
+static void printStats(const char* label, const SPVerifyStats* engine, const SPVerifyStats* reference,
+	const char* name) {
+	printf("%5s %-5s %8d %14lu %10.2f %12.3f %10.2f %8d %7d %8d\n", label, name, engine->searches,
+		engine->nodes, engine->ms, reference->nodes > 0 ? (double)engine->nodes / reference->nodes : 0.0,
+		engine->ms > 0 ? reference->ms / engine->ms : 0.0, engine->horizon, engine->parity, engine->mismatches);
+}
+
+/*
+* Parses the arguments of the test.
+* @param argc the number of arguments
+* @param argv the arguments
+* @param run the run to configure
+* @return true iff the arguments are valid
+*/
+static bool parseOptions(int argc, char* argv[], SPVerify* run) {
+	SP_MINIMAX_MODE mode;
+	unsigned long table_size = SP_MINIMAX_DEFAULT_TABLE_SIZE;
+	int i = 1, e;
+
+	if (argc > 1 && strncmp(argv[1], "--", 2) != 0) {
+		if (!spParserIsInt(argv[1]) || atoi(argv[1]) <= 0 || atoi(argv[1]) > VERIFY_MAX_DEPTH) {
+			return false;
+		}
+
+		run->max_depth = (unsigned int)atoi(argv[1]);
+		i = 2;
+	}
+
+	for (; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], VERIFY_RANDOM_OPTION) == 0 && spParserIsInt(argv[i + 1]) && atoi(argv[i + 1]) >= 0) {
+			run->random = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], VERIFY_SEED_OPTION) == 0 && spParserIsInt(argv[i + 1]) && atol(argv[i + 1]) >= 0) {
+			run->seed = (unsigned long long)atol(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], VERIFY_MODE_OPTION) == 0 && spMinimaxParseMode(argv[i + 1], &mode) &&
+			mode != SP_MINIMAX_MODE_MCTS && run->n_engines < VERIFY_MAX_ENGINES) {
+			spMinimaxConfigInit(run->engines + run->n_engines);
+			run->engines[run->n_engines++].mode = mode;
+		}
+		else if (strcmp(argv[i], VERIFY_TABLE_OPTION) == 0 && spParserIsInt(argv[i + 1]) && atol(argv[i + 1]) >= 0) {
+			table_size = (unsigned long)atol(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], VERIFY_GEOMETRY_OPTION) == 0 &&
+			(run->geometry = spFiarGeometryFind(argv[i + 1])) != NULL) {
+			continue;
+		}
+		else {
+			return false;
+		}
+	}
+
+	if (run->n_engines == 1) {
+		spMinimaxConfigInit(run->engines + 1);
+		run->engines[1].mode = SP_MINIMAX_MODE_PLAIN;
+		spMinimaxConfigInit(run->engines + 2);
+		run->engines[2].mode = SP_MINIMAX_MODE_PVS;
+		spMinimaxConfigInit(run->engines + 3);
+		run->engines[3].mode = SP_MINIMAX_MODE_MTDF;
+		run->n_engines = 4;
+	}
+
+	for (e = 1; e < run->n_engines; e++) {
+		run->engines[e].tableSize = table_size;
+	}
+
+	return i == argc;
+}
+
+int spVerifyMain(int argc, char* argv[]) {
+	SPVerify run;
+	SPVerifyStats totals[VERIFY_MAX_ENGINES];
+	SPFiarGame* game;
+	unsigned long long state;
+	unsigned int depth;
+	int curated = 0, p, e, mismatches = 0;
+	bool succeeded = true;
+	char label[8];
+
+	memset(&run, 0, sizeof(run));
+	memset(totals, 0, sizeof(totals));
+	run.geometry = spFiarGeometryGet(SP_FIAR_GEOMETRY_DEFAULT);
+	run.max_depth = VERIFY_DEFAULT_MAX_DEPTH;
+	run.random = VERIFY_DEFAULT_RANDOM;
+	spMinimaxConfigInit(run.engines);
+	run.n_engines = 1;
+
+	if (!parseOptions(argc, argv, &run)) {
+		printf("Usage: %s [max depth] [%s <n>] [%s <n>] [%s plain|pvs|mtdf]... [%s <entries>] "
+			"[%s 7x6|8x7|9x7|connect5]\n", argv[0], VERIFY_RANDOM_OPTION, VERIFY_SEED_OPTION, VERIFY_MODE_OPTION,
+			VERIFY_TABLE_OPTION, VERIFY_GEOMETRY_OPTION);
+		return 1;
+	}
+
+	for (p = 0; p < VERIFY_N_POSITIONS && succeeded; p++) {
+		if ((game = spFiarCodecDecodeMoves(VERIFY_POSITIONS[p], run.geometry, VERIFY_HISTORY_SIZE)) == NULL) {
+			continue;
+		}
+
+		if (spFiarCheckWinner(game) == '\0') {
+			succeeded = verifyPosition(&run, game);
+			curated++;
+		}
+
+		spFiarGameDestroy(game);
+	}
+
+	if (!succeeded) {
+		return 1;
+	}
+
+	if ((game = spFiarGameCreateWithGeometry(VERIFY_HISTORY_SIZE, run.geometry)) == NULL) {
+		printf("Error: malloc has failed\n");
+		return 1;
+	}
+
+	// the state of xorshift must not be 0
+	state = run.seed * 2 + 1;
+
+	for (p = 0; p < run.random && succeeded; p++) {
+		setRandomPosition(game, run.geometry, &state);
+		succeeded = verifyPosition(&run, game);
+	}
+
+	spFiarGameDestroy(game);
+
+	if (!succeeded) {
+		return 1;
+	}
+
+	printf("geometry %s positions %d curated %d random seed %llu\n", run.geometry->name, curated, run.random, run.seed);
+	printf("%5s %-5s %8s %14s %10s %12s %10s %8s %7s %8s\n", "depth", "mode", "searches", "nodes", "ms", "node ratio",
+		"speedup", "horizon", "parity", "mismatch");
+
+	for (depth = 1; depth <= run.max_depth; depth++) {
+		sprintf(label, "%u", depth);
+
+		for (e = 0; e < run.n_engines; e++) {
+			printStats(label, &run.stats[e][depth - 1], &run.stats[0][depth - 1], engineName(&run, e));
+			totals[e].searches += run.stats[e][depth - 1].searches;
+			totals[e].mismatches += run.stats[e][depth - 1].mismatches;
+			totals[e].horizon += run.stats[e][depth - 1].horizon;
+			totals[e].parity += run.stats[e][depth - 1].parity;
+			totals[e].nodes += run.stats[e][depth - 1].nodes;
+			totals[e].ms += run.stats[e][depth - 1].ms;
+		}
+	}
+
+	for (e = 0; e < run.n_engines; e++) {
+		printStats("all", totals + e, totals, engineName(&run, e));
+		mismatches += totals[e].mismatches;
+	}
+
+	printf("%s: %d mismatches\n", mismatches == 0 ? "ok" : "FAILED", mismatches);
+
+	return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+#ifndef SPVERIFY_H_
+#define SPVERIFY_H_
+
+#define VERIFY_COMMAND "verify"
+#define VERIFY_RANDOM_OPTION "--random"
+#define VERIFY_SEED_OPTION "--seed"
+#define VERIFY_MODE_OPTION "--mode"
+#define VERIFY_TABLE_OPTION "--table"
+#define VERIFY_GEOMETRY_OPTION "--geometry"
+#define VERIFY_DEFAULT_MAX_DEPTH 6
+#define VERIFY_DEFAULT_RANDOM 50
+
+/**
+ * SPVerify Summary:
+ *
+ * A differential test of the search modes of the engine against a reference: the
+ * full-width minimax the engine started with, kept as a private copy in
+ * SPVerify.c together with its histogram evaluation and weights. It searches every
+ * legal move to the depth and shares nothing with the engine but the rules of the
+ * game: no leaf rules, distances, threat parity proofs, forced moves, mirror
+ * skipping, tuned weights or pattern tables.
+ *
+ * A won or lost position must have the same result in a mode, won with a move
+ * the reference wins with; a tie is scored 0 by both. Otherwise the evaluations
+ * differ, so only the move is compared: the reference must give the move of the
+ * mode the score of the root. The plain mode is verified like every other one.
+ * A mode may know more than the reference where its leaves see a win one or two
+ * plies past the depth, or where threat parity proves a result; a difference
+ * there is reported as a horizon or parity result of its own, not as a mismatch.
+ *
+ * The positions are a curated set of openings, threats and nearly full boards,
+ * and random positions reached by random moves from the empty board, up to two
+ * empty cells, the same ones for the same seed. Every position is searched at
+ * every depth up to a maximal one by the reference and by every mode under test.
+ * A mismatch is printed with its position, then the nodes, time, horizon and
+ * parity results and mismatches of every mode at every depth, compared with the
+ * reference. The time is processor time. The Monte Carlo tree search has a score
+ * of its own, it can't be verified.
+ *
+ * spVerifyMain  - Runs the test
+ */
+
+/**
+ * Runs the test. Usage: verify [max depth] [--random <n>] [--seed <n>]
+ * [--mode <plain|pvs|mtdf>]... [--table <entries>] [--geometry <7x6|8x7|9x7|connect5>]
+ * The modes are plain, pvs and mtdf by default, with transposition tables of the
+ * default size.
+ *
+ * @param argc - the number of arguments, including the command name
+ * @param argv - the arguments, argv[0] is the command name
+ * @return
+ * 0 if no mode has a mismatch, 1 if the arguments are invalid, a mode has a
+ * mismatch or a search failed
+ */
+int spVerifyMain(int argc, char* argv[]);
+
+#endif
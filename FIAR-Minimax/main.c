@@ -1,16 +1,83 @@
 #include "SPMainAux.h"
+#include "SPBench.h"
+#include "SPArchive.h"
+#include "SPServer.h"
+#include "SPAnalyze.h"
+#include "SPReplay.h"
+#include "SPMatch.h"
+#include "SPSelfPlay.h"
+#include "SPTune.h"
+#include "SPPerft.h"
+#include "SPSuite.h"
+#include "SPVerify.h"
+#include "SPTrace.h"
 
-int main() {
+int main(int argc, char* argv[]) {
+	SP_GAME_SESSION session;
 	unsigned int level;
 
+	spTraceStart(getenv(SP_TRACE_FILE_VARIABLE));
+
+	if (argc > 1 && strcmp(argv[1], BENCH_COMMAND) == 0) {
+		return spBenchMain(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], ARCHIVE_COMMAND) == 0) {
+		return spArchiveMain(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], SERVER_COMMAND) == 0) {
+		return spServerMain(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], ANALYZE_COMMAND) == 0) {
+		return spAnalyzeMain(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], REPLAY_COMMAND) == 0) {
+		return spReplayMain(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], MATCH_COMMAND) == 0) {
+		return spMatchMain(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], SELFPLAY_COMMAND) == 0) {
+		return spSelfPlayMain(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], TUNE_COMMAND) == 0) {
+		return spTuneMain(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], PERFT_COMMAND) == 0) {
+		return spPerftMain(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], SUITE_COMMAND) == 0) {
+		return spSuiteMain(argc - 1, argv + 1);
+	}
+
+	if (argc > 1 && strcmp(argv[1], VERIFY_COMMAND) == 0) {
+		return spVerifyMain(argc - 1, argv + 1);
+	}
+
+	init_session(&session, stdin, stdout);
+
+	if (!parse_engine_options(argc, argv, &session)) {
+		return 1;
+	}
+
 	do {
-		level = init();
+		level = init(&session);
 
 		if (level == EXIT) {
-			return 0;
+			break;
 		}
 
-	} while (run_game(level) == RESTART);
+	} while (run_game(&session, level) == RESTART);
+
+	destroy_session(&session);
 
 	return 0;
 }
\ No newline at end of file